@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pg
+{
+    namespace benchmark
+    {
+        /** Seed used by every benchmark needing random data, so two runs always work on the same inputs */
+        constexpr uint32_t BENCHSEED = 0x5EED;
+
+        /**
+         * @brief Settings of a benchmark run, filled from the command line in mainbenchmark.cc
+         */
+        struct BenchConfig
+        {
+            /** Number of timed runs of each benchmark */
+            size_t nbRepetitions = 15;
+
+            /** File where the results are written as json */
+            std::string outputPath = "benchResults.json";
+
+            /** Json file of a previous run to compare against, no comparison is done when empty */
+            std::string baselinePath = "";
+
+            /** Allowed slow down of the median compared to the baseline before reporting a regression (0.1 = 10%) */
+            double tolerance = 0.1;
+
+            static BenchConfig& get() { static BenchConfig config; return config; }
+        };
+
+        /**
+         * @brief Statistics of a benchmark over all its timed runs, all the durations are in ns
+         */
+        struct BenchResult
+        {
+            std::string name;
+
+            /** Number of items processed by a single run */
+            size_t nbItems = 0;
+
+            size_t nbRepetitions = 0;
+
+            double min = 0.0;
+            double median = 0.0;
+            double mean = 0.0;
+            double stddev = 0.0;
+
+            /** Items processed per second, computed from the median */
+            double itemsPerSecond = 0.0;
+        };
+
+        /**
+         * @brief Prevent the compiler from optimizing away a value computed by a benchmark
+         */
+        template <typename Type>
+        inline void doNotOptimize(const Type& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            const volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+            (void)sink;
+#endif
+        }
+
+        /**
+         * @brief Collect the results of all the benchmarks of the run and write them as json
+         */
+        class BenchReporter
+        {
+        public:
+            static BenchReporter& get() { static BenchReporter reporter; return reporter; }
+
+            inline void add(const BenchResult& result) { results.push_back(result); }
+
+            inline const std::vector<BenchResult>& getResults() const { return results; }
+
+            /** Write all the results in a json file, return false if the file can't be opened */
+            bool writeJson(const std::string& path) const
+            {
+                std::ofstream file(path);
+
+                if (not file)
+                {
+                    std::cout << "Can't open file: " << path << " to write the benchmark results" << std::endl;
+                    return false;
+                }
+
+                file << std::fixed << std::setprecision(1);
+
+                file << "{" << std::endl;
+                file << "  \"context\": {\"repetitions\": " << BenchConfig::get().nbRepetitions << ", \"seed\": " << BENCHSEED << "}," << std::endl;
+                file << "  \"benchmarks\": [" << std::endl;
+
+                for (size_t i = 0; i < results.size(); ++i)
+                {
+                    const auto& result = results[i];
+
+                    // One result per line, the baseline reader relies on it
+                    file << "    {\"name\": \"" << result.name << "\""
+                         << ", \"items\": " << result.nbItems
+                         << ", \"repetitions\": " << result.nbRepetitions
+                         << ", \"min_ns\": " << result.min
+                         << ", \"median_ns\": " << result.median
+                         << ", \"mean_ns\": " << result.mean
+                         << ", \"stddev_ns\": " << result.stddev
+                         << ", \"items_per_second\": " << result.itemsPerSecond
+                         << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+                }
+
+                file << "  ]" << std::endl;
+                file << "}" << std::endl;
+
+                return true;
+            }
+
+            /**
+             * @brief Compare the medians of this run with a json file written by a previous run
+             *
+             * @param path Path of the baseline json file
+             * @param tolerance Allowed relative slow down before a benchmark is reported as a regression
+             * @return size_t The number of regressions found
+             */
+            size_t compareWithBaseline(const std::string& path, double tolerance) const
+            {
+                std::ifstream file(path);
+
+                if (not file)
+                {
+                    std::cout << "Can't open baseline file: " << path << std::endl;
+                    return 0;
+                }
+
+                std::unordered_map<std::string, double> baseline;
+
+                std::string line;
+
+                while (std::getline(file, line))
+                {
+                    const auto name = readField(line, "\"name\": \"", "\"");
+                    const auto median = readField(line, "\"median_ns\": ", ",");
+
+                    if (not name.empty() and not median.empty())
+                        baseline[name] = std::stod(median);
+                }
+
+                size_t nbRegressions = 0;
+
+                for (const auto& result : results)
+                {
+                    auto it = baseline.find(result.name);
+
+                    if (it == baseline.end() or it->second <= 0.0)
+                        continue;
+
+                    const auto ratio = result.median / it->second;
+
+                    if (ratio > 1.0 + tolerance)
+                    {
+                        std::cout << "[ REGRESSION ] " << result.name << ": " << result.median << " ns vs " << it->second << " ns in baseline (x" << ratio << ")" << std::endl;
+                        nbRegressions++;
+                    }
+                }
+
+                return nbRegressions;
+            }
+
+        private:
+            static std::string readField(const std::string& line, const std::string& prefix, const std::string& suffix)
+            {
+                const auto start = line.find(prefix);
+
+                if (start == std::string::npos)
+                    return "";
+
+                const auto valueStart = start + prefix.size();
+                const auto end = line.find(suffix, valueStart);
+
+                if (end == std::string::npos)
+                    return "";
+
+                return line.substr(valueStart, end - valueStart);
+            }
+
+            std::vector<BenchResult> results;
+        };
+
+        /**
+         * @brief Time a benchmark over several runs and register its statistics in the reporter
+         *
+         * Each run gets a fresh state from setup and only the call to body is timed,
+         * so the creation and destruction of the state don't end up in the results.
+         * An untimed run is done first to warm up the caches and the allocators.
+         *
+         * @tparam Setup Type of the function creating the state of a run
+         * @tparam Body Type of the function being timed, called as body(state)
+         * @param name Unique name of the benchmark, used as the key in the baseline comparison
+         * @param nbItems Number of items processed by a run, used to compute the throughput
+         * @param setup Function creating the state of a run
+         * @param body Function being timed
+         * @return BenchResult The statistics of the timed runs
+         */
+        template <typename Setup, typename Body>
+        BenchResult runBenchmark(const std::string& name, size_t nbItems, const Setup& setup, const Body& body)
+        {
+            const auto nbRepetitions = std::max<size_t>(BenchConfig::get().nbRepetitions, 1);
+
+            {
+                auto state = setup();
+                body(state);
+            }
+
+            std::vector<double> durations;
+
+            durations.reserve(nbRepetitions);
+
+            for (size_t i = 0; i < nbRepetitions; ++i)
+            {
+                auto state = setup();
+
+                const auto start = std::chrono::steady_clock::now();
+
+                body(state);
+
+                const auto end = std::chrono::steady_clock::now();
+
+                durations.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+
+            std::sort(durations.begin(), durations.end());
+
+            BenchResult result;
+
+            result.name = name;
+            result.nbItems = nbItems;
+            result.nbRepetitions = nbRepetitions;
+            result.min = durations.front();
+
+            const auto half = nbRepetitions / 2;
+            result.median = nbRepetitions % 2 == 0 ? (durations[half - 1] + durations[half]) / 2.0 : durations[half];
+
+            double sum = 0.0;
+
+            for (auto duration : durations)
+                sum += duration;
+
+            result.mean = sum / nbRepetitions;
+
+            double variance = 0.0;
+
+            for (auto duration : durations)
+                variance += (duration - result.mean) * (duration - result.mean);
+
+            result.stddev = std::sqrt(variance / nbRepetitions);
+
+            result.itemsPerSecond = result.median > 0.0 ? nbItems * 1e9 / result.median : 0.0;
+
+            std::cout << std::left << std::setw(48) << name
+                      << " median: " << std::right << std::setw(12) << static_cast<int64_t>(result.median) << " ns"
+                      << " min: " << std::setw(12) << static_cast<int64_t>(result.min) << " ns"
+                      << " stddev: " << std::setw(6) << std::fixed << std::setprecision(1) << (result.mean > 0.0 ? 100.0 * result.stddev / result.mean : 0.0) << "%"
+                      << " items/s: " << static_cast<int64_t>(result.itemsPerSecond) << std::endl;
+
+            BenchReporter::get().add(result);
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+
+#include "ECS/entitysystem.h"
+#include "2D/collisionsystem.h"
+#include "UI/uisystem.h"
+
+#include "benchharness.h"
+
+namespace pg
+{
+    namespace benchmark
+    {
+        namespace
+        {
+            constexpr size_t NBCOLLIDERS = 2000;
+
+            /** Size of the square where the colliders are spread */
+            constexpr float WORLDSIZE = 2000.0f;
+
+            constexpr float COLLIDERSIZE = 10.0f;
+
+            struct CollisionFixture
+            {
+                CollisionFixture()
+                {
+                    ecs.createSystem<UiComponentSystem>();
+                    sys = ecs.createSystem<CollisionSystem>();
+
+                    std::mt19937 rng(BENCHSEED);
+                    std::uniform_real_distribution<float> position(0.0f, WORLDSIZE);
+
+                    entities = ecs.createEntities(NBCOLLIDERS);
+
+                    frames.resize(NBCOLLIDERS);
+
+                    // The collision component is attached first, as the game does, so it knows its entity when the group picks it up
+                    for (size_t i = 0; i < NBCOLLIDERS; ++i)
+                    {
+                        ecs.attach<CollisionComponent>(entities[i]);
+
+                        frames[i].setX(position(rng));
+                        frames[i].setY(position(rng));
+                        frames[i].setWidth(COLLIDERSIZE);
+                        frames[i].setHeight(COLLIDERSIZE);
+                    }
+                }
+
+                /** Attach the ui components, each one enters the collision group and gets inserted in the grid */
+                void insertAll()
+                {
+                    for (size_t i = 0; i < NBCOLLIDERS; ++i)
+                        ecs.attach<UiComponent>(entities[i], frames[i]);
+                }
+
+                EntitySystem ecs;
+
+                CollisionSystem *sys;
+
+                std::vector<EntityRef> entities;
+
+                /** Position and size of the colliders */
+                std::vector<UiComponent> frames;
+            };
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(collision_benchmark, insert)
+        {
+            // The collision group inserts each new collider in the grid and resolves its collisions
+            runBenchmark("Collision/insert", NBCOLLIDERS,
+                []() { return std::make_unique<CollisionFixture>(); },
+                [](std::unique_ptr<CollisionFixture>& fixture) {
+                    fixture->insertAll();
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(collision_benchmark, move)
+        {
+            // Outside of a run the entity changed event reaches the collision system on the spot
+            runBenchmark("Collision/move", NBCOLLIDERS,
+                []() {
+                    auto fixture = std::make_unique<CollisionFixture>();
+                    fixture->insertAll();
+                    return fixture;
+                },
+                [](std::unique_ptr<CollisionFixture>& fixture) {
+                    for (auto& entity : fixture->entities)
+                    {
+                        auto ui = entity.get<UiComponent>();
+
+                        ui->setX(static_cast<float>(ui->pos.x) + COLLIDERSIZE);
+                    }
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(collision_benchmark, query)
+        {
+            runBenchmark("Collision/query", NBCOLLIDERS,
+                []() {
+                    auto fixture = std::make_unique<CollisionFixture>();
+                    fixture->insertAll();
+                    return fixture;
+                },
+                [](std::unique_ptr<CollisionFixture>& fixture) {
+                    for (auto& entity : fixture->entities)
+                        fixture->sys->resolveCollisionList(entity.get<UiComponent>(), entity.get<CollisionComponent>());
+
+                    doNotOptimize(fixture->sys->detectedCollisions.size());
+                });
+        }
+    }
+}
@@ -0,0 +1,403 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "ECS/entitysystem.h"
+
+#include "benchharness.h"
+
+namespace pg
+{
+    namespace benchmark
+    {
+        namespace
+        {
+            constexpr size_t NBENTITIES = 10000;
+
+            /** Number of passes over the sets in the iteration benchmarks, a single pass is too short to be timed reliably */
+            constexpr size_t NBPASSES = 10;
+
+            struct Position
+            {
+                Position(float x, float y) : x(x), y(y) {}
+
+                float x, y;
+            };
+
+            struct Velocity
+            {
+                Velocity(float x, float y) : x(x), y(y) {}
+
+                float x, y;
+            };
+
+            struct PackedPosition : public PackedStorage
+            {
+                PackedPosition(float x, float y) : x(x), y(y) {}
+
+                float x, y;
+            };
+
+            struct PackedVelocity : public PackedStorage
+            {
+                PackedVelocity(float x, float y) : x(x), y(y) {}
+
+                float x, y;
+            };
+
+            struct MovementSystem : public System<Own<Position>, Own<Velocity>, StoragePolicy> { };
+
+            struct PackedMovementSystem : public System<Own<PackedPosition>, Own<PackedVelocity>, StoragePolicy> { };
+
+            struct MovementGroupSystem : public System<Ref<Position>, Ref<Velocity>, InitSys>
+            {
+                virtual void init() override { group = registerGroup<Position, Velocity>(); }
+
+                Group<Position, Velocity>* group = nullptr;
+            };
+
+            struct BenchEvent
+            {
+                BenchEvent(int value) : value(value) {}
+
+                int value;
+            };
+
+            struct BenchListenerSystem : public System<Listener<BenchEvent>>
+            {
+                virtual void onEvent(const BenchEvent& event) override { sum += event.value; }
+
+                int64_t sum = 0;
+            };
+
+            /** Send a burst of events during its next run, they get dispatched at the sync point of the run after */
+            struct BenchSenderSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    for (size_t i = 0; i < toSend; ++i)
+                        ecsRef->sendEvent(BenchEvent{static_cast<int>(i)});
+
+                    toSend = 0;
+                }
+
+                size_t toSend = 0;
+            };
+
+            /** Record structural changes during its next run, they get played back by the command dispatcher on the run after */
+            struct BenchCommandSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    for (size_t i = 0; i < toCreate; ++i)
+                    {
+                        auto entity = ecsRef->createEntity();
+
+                        ecsRef->attach<Position>(entity, static_cast<float>(i), 0.0f);
+
+                        if (i % 2 == 0)
+                            ecsRef->attach<Velocity>(entity, 1.0f, 1.0f);
+                    }
+
+                    toCreate = 0;
+
+                    if (not toRemove.empty())
+                    {
+                        ecsRef->removeEntities(toRemove);
+
+                        toRemove.clear();
+                    }
+                }
+
+                size_t toCreate = 0;
+
+                std::vector<EntityRef> toRemove;
+            };
+
+            struct EcsFixture
+            {
+                EcsFixture()
+                {
+                    ecs.createSystem<MovementSystem>();
+                    ecs.createSystem<PackedMovementSystem>();
+
+                    entities = ecs.createEntities(NBENTITIES);
+                }
+
+                /** Attach a position to all the entities and a velocity to one entity every velocityStride, picked at random */
+                template <typename Pos, typename Vel>
+                void populate(size_t velocityStride)
+                {
+                    for (auto& entity : entities)
+                        ecs.attach<Pos>(entity, 0.0f, 0.0f);
+
+                    const auto list = shuffled();
+
+                    for (size_t i = 0; i < list.size(); i += velocityStride)
+                        ecs.attach<Vel>(list[i], 1.0f, 1.0f);
+                }
+
+                /** Entities in a random order that is the same from one run to another */
+                std::vector<EntityRef> shuffled() const
+                {
+                    auto list = entities;
+
+                    std::mt19937 rng(BENCHSEED);
+                    std::shuffle(list.begin(), list.end(), rng);
+
+                    return list;
+                }
+
+                EntitySystem ecs;
+
+                std::vector<EntityRef> entities;
+            };
+
+            std::unique_ptr<EcsFixture> makeFixture()
+            {
+                return std::make_unique<EcsFixture>();
+            }
+
+            template <typename Pos>
+            void runAttach(const std::string& name)
+            {
+                runBenchmark(name, NBENTITIES,
+                    []() { return makeFixture(); },
+                    [](std::unique_ptr<EcsFixture>& fixture) {
+                        for (auto& entity : fixture->entities)
+                            fixture->ecs.attach<Pos>(entity, 1.0f, 2.0f);
+                    });
+            }
+
+            template <typename Pos, typename Vel>
+            void runDetach(const std::string& name)
+            {
+                runBenchmark(name, NBENTITIES,
+                    []() {
+                        auto fixture = makeFixture();
+                        fixture->populate<Pos, Vel>(NBENTITIES);
+
+                        // Random order so most removals move the last component of the set
+                        fixture->entities = fixture->shuffled();
+
+                        return fixture;
+                    },
+                    [](std::unique_ptr<EcsFixture>& fixture) {
+                        for (auto& entity : fixture->entities)
+                            fixture->ecs.detach<Pos>(entity);
+                    });
+            }
+
+            template <typename Pos, typename Vel>
+            void runIterate(const std::string& name)
+            {
+                runBenchmark(name, NBENTITIES * NBPASSES,
+                    []() {
+                        auto fixture = makeFixture();
+                        fixture->populate<Pos, Vel>(NBENTITIES);
+                        return fixture;
+                    },
+                    [](std::unique_ptr<EcsFixture>& fixture) {
+                        for (size_t pass = 0; pass < NBPASSES; ++pass)
+                        {
+                            for (const auto& pos : fixture->ecs.view<Pos>())
+                                pos->x += 1.0f;
+                        }
+
+                        doNotOptimize(fixture->ecs.view<Pos>()[1]->x);
+                    });
+            }
+
+            template <typename Pos, typename Vel>
+            void runJoin(const std::string& name, size_t velocityStride)
+            {
+                runBenchmark(name, NBENTITIES * NBPASSES,
+                    [velocityStride]() {
+                        auto fixture = makeFixture();
+                        fixture->populate<Pos, Vel>(velocityStride);
+                        return fixture;
+                    },
+                    [](std::unique_ptr<EcsFixture>& fixture) {
+                        float sum = 0.0f;
+
+                        for (size_t pass = 0; pass < NBPASSES; ++pass)
+                        {
+                            for (const auto& elem : fixture->ecs.view<Pos, Vel>())
+                                sum += elem.template get<Pos>()->x + elem.template get<Vel>()->x;
+                        }
+
+                        doNotOptimize(sum);
+                    });
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(component_set_benchmark, attach)
+        {
+            runAttach<Position>("ComponentSet/attach");
+            runAttach<PackedPosition>("ComponentSet/attach_packed");
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(component_set_benchmark, detach)
+        {
+            runDetach<Position, Velocity>("ComponentSet/detach");
+            runDetach<PackedPosition, PackedVelocity>("ComponentSet/detach_packed");
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(component_set_benchmark, iterate)
+        {
+            runIterate<Position, Velocity>("ComponentSet/iterate");
+            runIterate<PackedPosition, PackedVelocity>("ComponentSet/iterate_packed");
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(view_benchmark, join)
+        {
+            runJoin<Position, Velocity>("View/join_half", 2);
+            runJoin<Position, Velocity>("View/join_sparse", 100);
+            runJoin<PackedPosition, PackedVelocity>("View/join_half_packed", 2);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(group_benchmark, churn)
+        {
+            // Every entity leaves and enters the group once
+            runBenchmark("Group/churn", NBENTITIES,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->ecs.createSystem<MovementGroupSystem>();
+                    fixture->populate<Position, Velocity>(1);
+                    fixture->entities = fixture->shuffled();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    for (auto& entity : fixture->entities)
+                    {
+                        fixture->ecs.detach<Velocity>(entity);
+                        fixture->ecs.attach<Velocity>(entity, 2.0f, 2.0f);
+                    }
+                });
+
+            runBenchmark("OwningGroup/churn", NBENTITIES,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->populate<PackedPosition, PackedVelocity>(1);
+                    fixture->ecs.getSystem<PackedMovementSystem>()->registerOwningGroup<PackedPosition, PackedVelocity>();
+                    fixture->entities = fixture->shuffled();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    for (auto& entity : fixture->entities)
+                    {
+                        fixture->ecs.detach<PackedVelocity>(entity);
+                        fixture->ecs.attach<PackedVelocity>(entity, 2.0f, 2.0f);
+                    }
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(group_benchmark, iterate)
+        {
+            runBenchmark("OwningGroup/iterate_half", NBENTITIES * NBPASSES,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->populate<PackedPosition, PackedVelocity>(2);
+                    fixture->ecs.getSystem<PackedMovementSystem>()->registerOwningGroup<PackedPosition, PackedVelocity>();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    auto group = fixture->ecs.getSystem<PackedMovementSystem>()->registerOwningGroup<PackedPosition, PackedVelocity>();
+
+                    float sum = 0.0f;
+
+                    for (size_t pass = 0; pass < NBPASSES; ++pass)
+                        group->each([&sum](PackedPosition* pos, PackedVelocity* vel) { sum += pos->x + vel->x; });
+
+                    doNotOptimize(sum);
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(event_benchmark, send_event)
+        {
+            constexpr size_t nbEvents = 100000;
+
+            // Outside of a run the events are dispatched on the spot
+            runBenchmark("Event/send_immediate", nbEvents,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->ecs.createSystem<BenchListenerSystem>();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    for (size_t i = 0; i < nbEvents; ++i)
+                        fixture->ecs.sendEvent(BenchEvent{static_cast<int>(i)});
+
+                    doNotOptimize(fixture->ecs.getSystem<BenchListenerSystem>()->sum);
+                });
+
+            // Events queued during a run, the timed run dispatches them at its sync point
+            runBenchmark("Event/deferred_dispatch", nbEvents,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->ecs.createSystem<BenchListenerSystem>();
+                    fixture->ecs.createSystem<BenchSenderSystem>()->toSend = nbEvents;
+                    fixture->ecs.executeOnce();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    fixture->ecs.executeOnce();
+
+                    doNotOptimize(fixture->ecs.getSystem<BenchListenerSystem>()->sum);
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(command_dispatcher_benchmark, process)
+        {
+            // 10k entity creations and 15k component attachments recorded during a run and played back on the next one
+            runBenchmark("CommandDispatcher/process_create", NBENTITIES,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->ecs.createSystem<BenchCommandSystem>()->toCreate = NBENTITIES;
+                    fixture->ecs.executeOnce();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    fixture->ecs.executeOnce();
+                });
+
+            runBenchmark("CommandDispatcher/process_remove", NBENTITIES,
+                []() {
+                    auto fixture = makeFixture();
+                    fixture->populate<Position, Velocity>(2);
+                    fixture->ecs.createSystem<BenchCommandSystem>()->toRemove = fixture->shuffled();
+                    fixture->ecs.executeOnce();
+                    return fixture;
+                },
+                [](std::unique_ptr<EcsFixture>& fixture) {
+                    fixture->ecs.executeOnce();
+                });
+        }
+    }
+}
@@ -1,15 +1,71 @@
 #include "gtest/gtest.h"
 
 #include <iostream>
+#include <string>
 
 #include <SDL.h>
 
+#include "benchharness.h"
+
+namespace
+{
+   /** Return the value of an argument of the form --name=value, or an empty string if arg is another argument */
+   std::string readArgument(const std::string& arg, const std::string& name)
+   {
+      const auto prefix = "--" + name + "=";
+
+      if (arg.rfind(prefix, 0) == 0)
+         return arg.substr(prefix.size());
+
+      return "";
+   }
+}
+
 /**
- * Entry point for the test
+ * Entry point for the benchmarks
+ *
+ * Accept all the gtest flags (--gtest_filter to select the benchmarks) plus:
+ * --bench_repetitions=N   Number of timed runs of each benchmark
+ * --bench_out=path        Json file receiving the results
+ * --bench_baseline=path   Json file of a previous run, the run fails if a benchmark got slower than the tolerance
+ * --bench_tolerance=x     Allowed relative slow down against the baseline (default 0.1)
  */
 int main(int argc, char **argv)
 {
    std::cout << "Start all the benchmarks" << std::endl;
    ::testing::InitGoogleTest( &argc, argv );
-   return RUN_ALL_TESTS();
+
+   auto& config = pg::benchmark::BenchConfig::get();
+
+   // InitGoogleTest removed its own flags, only ours are left
+   for (int i = 1; i < argc; ++i)
+   {
+      const std::string arg = argv[i];
+
+      if (auto value = readArgument(arg, "bench_repetitions"); not value.empty())
+         config.nbRepetitions = std::stoul(value);
+      else if (auto value = readArgument(arg, "bench_out"); not value.empty())
+         config.outputPath = value;
+      else if (auto value = readArgument(arg, "bench_baseline"); not value.empty())
+         config.baselinePath = value;
+      else if (auto value = readArgument(arg, "bench_tolerance"); not value.empty())
+         config.tolerance = std::stod(value);
+      else
+         std::cout << "Unknown argument: " << arg << std::endl;
+   }
+
+   auto res = RUN_ALL_TESTS();
+
+   auto& reporter = pg::benchmark::BenchReporter::get();
+
+   if (not reporter.getResults().empty())
+   {
+      if (reporter.writeJson(config.outputPath))
+         std::cout << "Wrote " << reporter.getResults().size() << " results in " << config.outputPath << std::endl;
+
+      if (not config.baselinePath.empty() and reporter.compareWithBaseline(config.baselinePath, config.tolerance) > 0)
+         res = 1;
+   }
+
+   return res;
 }
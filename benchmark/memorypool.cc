@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
 
 #include <chrono>
+#include <thread>
+#include <random>
+#include <functional>
+#include <memory_resource>
 
 #include "Memory/memorypool.h"
 
@@ -155,6 +159,104 @@ namespace pg
             }
         }
 
+        auto threadsToTest = {1, 2, 4, 8};
+
+        /** Number of allocations or releases done by each thread in the churn benchmarks */
+        constexpr size_t churnOperations = 1000000;
+
+        /** Number of objects alive at once for each thread in the churn benchmarks */
+        constexpr size_t churnLiveObjects = 1024;
+
+        /**
+         * @brief Run a multi threaded churn: each thread keeps a window of live objects and randomly replaces them
+         *
+         * @param name Name of the allocator to print
+         * @param nbThreads Number of threads doing the churn
+         * @param alloc Function called to get a new object from a thread
+         * @param dealloc Function called to give an object back from a thread
+         * @param onThreadExit Optional function called by each thread once its churn is done
+         */
+        template <typename Alloc, typename Dealloc>
+        void runChurn(const std::string& name, unsigned int nbThreads, const Alloc& alloc, const Dealloc& dealloc, const std::function<void()>& onThreadExit = {})
+        {
+            std::vector<std::thread> threads;
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            for (size_t t = 0; t < nbThreads; ++t)
+            {
+                threads.emplace_back([&alloc, &dealloc, &onThreadExit, t]() {
+                    std::mt19937 gen(static_cast<unsigned int>(t));
+                    std::uniform_int_distribution<size_t> dist(0, churnLiveObjects - 1);
+
+                    std::vector<BasicObject*> objects(churnLiveObjects);
+
+                    for (auto& object : objects)
+                        object = alloc();
+
+                    for (size_t i = 0; i < churnOperations; ++i)
+                    {
+                        auto& object = objects[dist(gen)];
+
+                        dealloc(object);
+                        object = alloc();
+                    }
+
+                    for (auto& object : objects)
+                        dealloc(object);
+
+                    if (onThreadExit)
+                        onThreadExit();
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            std::cout << name << " churn with " << nbThreads << " threads took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
+        }
+
+        /** Pmr pool owned by the calling thread, objects are always released by the thread that allocated them in the churn */
+        std::pmr::unsynchronized_pool_resource& threadPmrResource()
+        {
+            thread_local std::pmr::unsynchronized_pool_resource resource;
+
+            return resource;
+        }
+
+        void runMemoryPoolBulk(unsigned int size)
+        {
+            AllocatorPool<BasicObject> pool;
+
+            std::vector<BasicObject*> objects(size);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            pool.allocateBulk(size, objects.data());
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            std::cout << "Memory Pool Bulk Allocation for " << size << " objects took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
+
+            start = std::chrono::high_resolution_clock::now();
+
+            pool.releaseBulk(objects.data(), size);
+
+            end = std::chrono::high_resolution_clock::now();
+
+            std::cout << "Memory Pool Bulk Deallocation for " << size << " objects took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
+
+            start = std::chrono::high_resolution_clock::now();
+
+            const auto freed = pool.shrink();
+
+            end = std::chrono::high_resolution_clock::now();
+
+            std::cout << "Memory Pool Shrink of " << freed << " chunks took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
+        }
+
         // ----------------------------------------------------------------------------------------
         // ---------------------------        Test separator        -------------------------------
         // ----------------------------------------------------------------------------------------
@@ -198,5 +300,97 @@ namespace pg
                 runStdRealloc(value);
             }
         }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(memorypool_benchmark, bulk)
+        {
+            for (auto value : valueToTest)
+            {
+                runMemoryPoolBulk(value);
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(churn_benchmark, std_new_delete)
+        {
+            for (auto nbThreads : threadsToTest)
+            {
+                runChurn("Std new/delete", nbThreads, []() { return new BasicObject(); }, [](BasicObject* object) { delete object; });
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(churn_benchmark, locked_memorypool)
+        {
+            for (auto nbThreads : threadsToTest)
+            {
+                AllocatorPool<BasicObject> pool;
+                std::mutex mutex;
+
+                runChurn("Locked Memory Pool", nbThreads,
+                    [&]() { std::lock_guard<std::mutex> lock(mutex); return pool.allocate(); },
+                    [&](BasicObject* object) { std::lock_guard<std::mutex> lock(mutex); pool.release(object); });
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(churn_benchmark, concurrent_memorypool)
+        {
+            for (auto nbThreads : threadsToTest)
+            {
+                ConcurrentAllocatorPool<BasicObject> pool;
+
+                runChurn("Concurrent Memory Pool", nbThreads,
+                    [&]() { return pool.allocate(); },
+                    [&](BasicObject* object) { pool.release(object); },
+                    [&]() { pool.flush(); });
+
+                std::cout << "Concurrent Memory Pool freed " << pool.shrink() << " chunks after churn" << std::endl;
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(churn_benchmark, pmr_synchronized_pool)
+        {
+            for (auto nbThreads : threadsToTest)
+            {
+                std::pmr::synchronized_pool_resource resource;
+                std::pmr::polymorphic_allocator<BasicObject> allocator(&resource);
+
+                runChurn("Pmr synchronized pool", nbThreads,
+                    [&]() { auto object = allocator.allocate(1); ::new(object) BasicObject(); return object; },
+                    [&](BasicObject* object) { object->~BasicObject(); allocator.deallocate(object, 1); });
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(churn_benchmark, pmr_unsynchronized_pool_per_thread)
+        {
+            for (auto nbThreads : threadsToTest)
+            {
+                // Best case for pmr: each thread owns its pool so no synchronisation is needed at all
+                runChurn("Pmr unsynchronized pool per thread", nbThreads,
+                    []() {
+                        auto object = static_cast<BasicObject*>(threadPmrResource().allocate(sizeof(BasicObject), alignof(BasicObject)));
+                        return ::new(object) BasicObject();
+                    },
+                    [](BasicObject* object) {
+                        object->~BasicObject();
+                        threadPmrResource().deallocate(object, sizeof(BasicObject), alignof(BasicObject));
+                    });
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "serialization.h"
+#include "UI/uisystem.h"
+
+#include "benchharness.h"
+
+namespace pg
+{
+    namespace benchmark
+    {
+        namespace
+        {
+            constexpr size_t NBOBJECTS = 2000;
+
+            struct SerializeFixture
+            {
+                SerializeFixture()
+                {
+                    std::mt19937 rng(BENCHSEED);
+                    std::uniform_real_distribution<float> value(0.0f, 1000.0f);
+
+                    components.resize(NBOBJECTS);
+                    names.reserve(NBOBJECTS);
+
+                    for (size_t i = 0; i < NBOBJECTS; ++i)
+                    {
+                        components[i].setX(value(rng));
+                        components[i].setY(value(rng));
+                        components[i].setWidth(value(rng));
+                        components[i].setHeight(value(rng));
+
+                        names.push_back("ui" + std::to_string(i));
+                    }
+                }
+
+                /** Serialize all the components, as Serializer::serializeObject does, without writing any file */
+                void serializeAll()
+                {
+                    serialized.clear();
+                    serialized.reserve(NBOBJECTS);
+
+                    for (const auto& component : components)
+                    {
+                        Archive archive;
+
+                        serialize(archive, component);
+
+                        archive.container << std::endl;
+
+                        serialized.push_back(archive.container.str());
+                    }
+                }
+
+                /** Serialize all the components with the binary archive */
+                void serializeAllBinary()
+                {
+                    serialized.clear();
+                    serialized.reserve(NBOBJECTS);
+
+                    for (const auto& component : components)
+                    {
+                        BinaryArchive archive;
+
+                        serialize(archive, component);
+
+                        serialized.push_back(archive.str());
+                    }
+                }
+
+                /** The whole document as it would be written in a save file */
+                std::string document() const
+                {
+                    std::ostringstream stream;
+
+                    for (size_t i = 0; i < NBOBJECTS; ++i)
+                        stream << names[i] << ": " << serialized[i];
+
+                    return stream.str();
+                }
+
+                std::vector<UiComponent> components;
+                std::vector<std::string> names;
+                std::vector<std::string> serialized;
+            };
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serializer_benchmark, serialize)
+        {
+            runBenchmark("Serializer/serialize_ui_component", NBOBJECTS,
+                []() { return std::make_unique<SerializeFixture>(); },
+                [](std::unique_ptr<SerializeFixture>& fixture) {
+                    fixture->serializeAll();
+
+                    doNotOptimize(fixture->serialized.back());
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serializer_benchmark, deserialize)
+        {
+            runBenchmark("Serializer/deserialize_ui_component", NBOBJECTS,
+                []() {
+                    auto fixture = std::make_unique<SerializeFixture>();
+                    fixture->serializeAll();
+
+                    // A text object starts with its name, as in a save file, otherwise the parser rejects it
+                    for (size_t i = 0; i < NBOBJECTS; ++i)
+                        fixture->serialized[i] = fixture->names[i] + ": " + fixture->serialized[i];
+
+                    return fixture;
+                },
+                [](std::unique_ptr<SerializeFixture>& fixture) {
+                    float sum = 0.0f;
+
+                    for (size_t i = 0; i < NBOBJECTS; ++i)
+                    {
+                        auto component = deserialize<UiComponent>(UnserializedObject(fixture->serialized[i], fixture->names[i]));
+
+                        sum += component.width;
+                    }
+
+                    doNotOptimize(sum);
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serializer_benchmark, serialize_binary)
+        {
+            runBenchmark("Serializer/serialize_ui_component_binary", NBOBJECTS,
+                []() { return std::make_unique<SerializeFixture>(); },
+                [](std::unique_ptr<SerializeFixture>& fixture) {
+                    fixture->serializeAllBinary();
+
+                    doNotOptimize(fixture->serialized.back());
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serializer_benchmark, deserialize_binary)
+        {
+            runBenchmark("Serializer/deserialize_ui_component_binary", NBOBJECTS,
+                []() {
+                    auto fixture = std::make_unique<SerializeFixture>();
+                    fixture->serializeAllBinary();
+                    return fixture;
+                },
+                [](std::unique_ptr<SerializeFixture>& fixture) {
+                    float sum = 0.0f;
+
+                    for (size_t i = 0; i < NBOBJECTS; ++i)
+                    {
+                        auto component = deserialize<UiComponent>(UnserializedObject::fromBinary(fixture->serialized[i], fixture->names[i]));
+
+                        sum += component.width;
+                    }
+
+                    doNotOptimize(sum);
+                });
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serializer_benchmark, read_document)
+        {
+            // Split of a whole save document into its objects, as done when a Serializer opens a file
+            runBenchmark("Serializer/read_document", NBOBJECTS,
+                []() {
+                    auto fixture = std::make_unique<SerializeFixture>();
+                    fixture->serializeAll();
+                    fixture->serialized = {fixture->document()};
+                    return fixture;
+                },
+                [](std::unique_ptr<SerializeFixture>& fixture) {
+                    auto map = Serializer::readData(ARCHIVEVERSION, fixture->serialized.front());
+
+                    doNotOptimize(map.size());
+                });
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <any>
+
 #include "ECS/system.h"
 
 #include "Input/inputcomponent.h"
@@ -25,7 +25,7 @@ namespace pg
 
                         UnserializedObject attribute(str, child.name, false);
 
-                        holder.children.push_back(attribute);
+                        holder.addChild(attribute);
                     }
                     else
                     {
@@ -33,7 +33,7 @@ namespace pg
 
                         deserializeCurrentEntityHelper(klass, child);
 
-                        holder.children.push_back(klass);
+                        holder.addChild(klass);
                     }
                 }
             }
@@ -199,7 +199,7 @@ namespace pg
 
             deserializeCurrentEntityHelper(obj, archive.mainNode);
 
-            if (obj.children.size() < 1)
+            if (obj.getNbChildren() < 1)
             {
                 LOG_ERROR(DOM, "Entity root node has no children, should never happen !");
 
@@ -208,8 +208,8 @@ namespace pg
 
             auto entity = ecsRef->getEntity(currentId);
 
-            // obj.children[0] is the root node of the entity's components
-            for (const auto& child : obj.children[0].children)
+            // obj[0] is the root node of the entity's components
+            for (const auto& child : obj[0].getChildren())
             {
                 if (child.isClassObject())
                 {
@@ -181,7 +181,8 @@ namespace pg
 
         // LOG_INFO(DOM, "Resolving collision list");
 
-        std::set<_unique_id> touchedIds;
+        // Transient set rebuilt for each component, kept in the frame arena to not hit the heap on every insertion
+        FrameSet<_unique_id> touchedIds(ecsRef->frameAllocator<_unique_id>());
 
         // Get all ids in the same cell as our comp
         for (const auto& layer : comp->cells)
@@ -302,11 +303,19 @@ namespace pg
         return 0;
     }
 
-    void CollisionSystem::onEvent(const EntityChangedEvent& event)
+    void CollisionSystem::onEvents(const std::vector<EntityChangedEvent>& events)
     {
         LOG_THIS_MEMBER(DOM);
 
-        auto entity = ecsRef->getEntity(event.id);
+        for (const auto& event : events)
+            onEventUpdate(event.id);
+    }
+
+    void CollisionSystem::onEventUpdate(_unique_id entityId)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        auto entity = ecsRef->getEntity(entityId);
         
         if (not entity or not entity->has<UiComponent>() or not entity->has<CollisionComponent>())
             return;
@@ -190,7 +190,7 @@ namespace pg
         }
     };
 
-    struct CollisionSystem : public System<Own<CollisionComponent>, Ref<UiComponent>, Listener<EntityChangedEvent>, InitSys>
+    struct CollisionSystem : public System<Own<CollisionComponent>, ReadRef<UiComponent>, BatchListener<EntityChangedEvent>, InitSys>
     {
         // Todo make a ctor that load properties (pageSize, cellSi) from serialization
         CollisionSystem();
@@ -207,7 +207,9 @@ namespace pg
 
         _unique_id findNeareastId(constant::Vector2D pos, size_t layerId, size_t radius);
 
-        virtual void onEvent(const EntityChangedEvent& event) override;
+        virtual void onEvents(const std::vector<EntityChangedEvent>& events) override;
+
+        void onEventUpdate(_unique_id entityId);
 
         virtual void execute() override;
 
@@ -174,21 +174,7 @@ namespace pg
 
     void Simple2DObjectSystem::execute()
     {
-        if (not changed)
-            return;
-
-        renderCallList.clear();
-
-        const auto& renderCallView = view<Simple2DRenderCall>();
-
-        renderCallList.reserve(renderCallView.nbComponents());
-
-        for (const auto& renderCall : renderCallView)
-        {
-            renderCallList.push_back(renderCall->call);
-        }
-
-        changed = false;
+        syncRenderCalls<Simple2DRenderCall>(view<Simple2DRenderCall>());
     }
 
     RenderCall Simple2DObjectSystem::createRenderCall(CompRef<UiComponent> ui, CompRef<Simple2DObject> obj)
@@ -219,21 +205,25 @@ namespace pg
         return call;
     }
 
-    void Simple2DObjectSystem::onEvent(const EntityChangedEvent& event)
+    void Simple2DObjectSystem::onEvents(const std::vector<EntityChangedEvent>& events)
     {
         LOG_THIS_MEMBER(DOM);
 
-        auto entity = ecsRef->getEntity(event.id);
-        
-        if (not entity or not entity->has<Simple2DRenderCall>())
-            return; 
+        for (const auto& event : events)
+        {
+            auto entity = ecsRef->getEntity(event.id);
+            
+            if (not entity or not entity->has<Simple2DRenderCall>())
+                continue; 
 
-        auto ui = entity->get<UiComponent>();
-        auto shape = entity->get<Simple2DObject>();
+            auto ui = entity->get<UiComponent>();
+            auto shape = entity->get<Simple2DObject>();
 
-        entity->get<Simple2DRenderCall>()->call = createRenderCall(ui, shape);
+            entity->get<Simple2DRenderCall>()->call = createRenderCall(ui, shape);
 
-        changed = true;
+            // Only this call needs to be copied again in the render call list
+            ecsRef->markChanged<Simple2DRenderCall>(event.id);
+        }
     }
 
     CompList<UiComponent, Simple2DObject> makeSimple2DShape(EntitySystem *ecs, const Shape2D& shape, float width, float height, const constant::Vector3D& colors)
@@ -66,7 +66,7 @@ namespace pg
         RenderCall call;
     };
 
-    struct Simple2DObjectSystem : public AbstractRenderer, System<Own<Simple2DObject>, Own<Simple2DRenderCall>, Ref<UiComponent>, Listener<EntityChangedEvent>, NamedSystem, InitSys>
+    struct Simple2DObjectSystem : public AbstractRenderer, System<Own<Simple2DObject>, Own<Simple2DRenderCall>, ReadRef<UiComponent>, BatchListener<EntityChangedEvent>, NamedSystem, InitSys>
     {
         Simple2DObjectSystem(MasterRenderer* masterRenderer) : AbstractRenderer(masterRenderer, RenderStage::Render) { }
         virtual ~Simple2DObjectSystem() { }
@@ -79,7 +79,7 @@ namespace pg
 
         RenderCall createRenderCall(CompRef<UiComponent> ui, CompRef<Simple2DObject> obj);
 
-        virtual void onEvent(const EntityChangedEvent& event) override;
+        virtual void onEvents(const std::vector<EntityChangedEvent>& events) override;
 
         uint64_t materialId = 0;
     };
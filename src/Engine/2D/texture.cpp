@@ -130,21 +130,7 @@ namespace pg
 
     void Texture2DComponentSystem::execute()
     {
-        if (not changed)
-            return;
-
-        renderCallList.clear();
-
-        const auto& renderCallView = view<TextureRenderCall>();
-
-        renderCallList.reserve(renderCallView.nbComponents());
-
-        for (const auto& renderCall : renderCallView)
-        {
-            renderCallList.push_back(renderCall->call);
-        }
-
-        changed = false;
+        syncRenderCalls<TextureRenderCall>(view<TextureRenderCall>());
     }
 
     RenderCall Texture2DComponentSystem::createRenderCall(CompRef<UiComponent> ui, CompRef<Texture2DComponent> obj)
@@ -259,11 +245,12 @@ namespace pg
         return call;
     }
 
-    void Texture2DComponentSystem::onEvent(const EntityChangedEvent& event)
+    void Texture2DComponentSystem::onEvents(const std::vector<EntityChangedEvent>& events)
     {
         LOG_THIS_MEMBER(DOM);
 
-        onEventUpdate(event.id);
+        for (const auto& event : events)
+            onEventUpdate(event.id);
     }
 
     void Texture2DComponentSystem::onEventUpdate(_unique_id entityId)
@@ -280,6 +267,7 @@ namespace pg
 
         entity->get<TextureRenderCall>()->call = createRenderCall(ui, shape);
 
-        changed = true;
+        // Only this call needs to be copied again in the render call list
+        ecsRef->markChanged<TextureRenderCall>(entityId);
     }
 }
\ No newline at end of file
@@ -107,7 +107,7 @@ namespace pg
         RenderCall call;
     };
 
-    struct Texture2DComponentSystem : public AbstractRenderer, System<Own<Texture2DComponent>, Own<TextureRenderCall>, Listener<EntityChangedEvent>, Ref<UiComponent>, NamedSystem, InitSys>
+    struct Texture2DComponentSystem : public AbstractRenderer, System<Own<Texture2DComponent>, Own<TextureRenderCall>, BatchListener<EntityChangedEvent>, ReadRef<UiComponent>, NamedSystem, InitSys>
     {
         Texture2DComponentSystem(MasterRenderer* masterRenderer) : AbstractRenderer(masterRenderer, RenderStage::Render) { }
 
@@ -119,7 +119,7 @@ namespace pg
 
         RenderCall createRenderCall(CompRef<UiComponent> ui, CompRef<Texture2DComponent> obj);
 
-        virtual void onEvent(const EntityChangedEvent& event) override;
+        virtual void onEvents(const std::vector<EntityChangedEvent>& events) override;
 
         void onEventUpdate(_unique_id entityId);
 
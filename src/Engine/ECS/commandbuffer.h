@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+
+#include "entity.h"
+
+#include "Memory/lineararena.h"
+
+namespace pg
+{
+    // Type forwarding
+    class EntitySystem;
+
+    /**
+     * @brief Header of a deferred component creation
+     *
+     * The record lives in the arena of a command buffer, the component is stored right after it in a TypedComponentCreateRecord.
+     */
+    struct ComponentCreateRecord
+    {
+        /** Type id of the component, used to sort the records by component set */
+        _unique_id typeId;
+
+        /** Entity receiving the component */
+        EntityRef entity;
+
+        /** Grow the component set of this type once for a whole run of records */
+        void (*reserve)(EntitySystem*, size_t, _unique_id);
+
+        /** Move the component in its component set */
+        void (*apply)(EntitySystem*, ComponentCreateRecord*);
+
+        /** Destroy the pending component once it is applied */
+        void (*destroy)(ComponentCreateRecord*);
+    };
+
+    template <typename Type>
+    struct TypedComponentCreateRecord : public ComponentCreateRecord
+    {
+        template <typename... Args>
+        TypedComponentCreateRecord(Args&&... args) : component{std::forward<Args>(args)...} {}
+
+        Type component;
+    };
+
+    /**
+     * @brief A deferred component deletion
+     */
+    struct ComponentDeleteRecord
+    {
+        /** Type id of the component to detach */
+        _unique_id typeId;
+
+        /** Entity losing the component */
+        Entity *entity;
+    };
+
+    /**
+     * @brief Structural changes recorded by a single thread between two sync points of the ecs
+     *
+     * Each worker of the ecs executor records in its own buffer so recording never contends with other threads.
+     * The buffer is double buffered: at the sync point the commands recorded so far are flipped out for playback
+     * while new commands keep going to the other set.
+     */
+    class CommandBuffer
+    {
+    public:
+        struct Commands
+        {
+            inline bool empty() const
+            {
+                return createdEntities.empty() and deletedEntities.empty() and createdComponents.empty() and deletedComponents.empty();
+            }
+
+            /** Storage of the pending entities and components */
+            LinearArena arena;
+
+            std::vector<Entity*> createdEntities;
+            std::vector<Entity*> deletedEntities;
+            std::vector<ComponentCreateRecord*> createdComponents;
+            std::vector<ComponentDeleteRecord> deletedComponents;
+        };
+
+        /** Lock the buffer and get the commands being recorded */
+        inline Commands& lock(std::unique_lock<std::mutex>& guard)
+        {
+            guard = std::unique_lock<std::mutex>(mutex);
+
+            return commands[recordingIndex];
+        }
+
+        /** Get the commands recorded so far and start recording in the other set */
+        inline Commands& flip()
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+
+            auto& recorded = commands[recordingIndex];
+
+            recordingIndex = 1 - recordingIndex;
+
+            return recorded;
+        }
+
+    private:
+        Commands commands[2];
+
+        size_t recordingIndex = 0;
+
+        /** Only contended when the buffer is flipped at the sync point */
+        std::mutex mutex;
+    };
+}
@@ -1,5 +1,7 @@
 #include "commanddispatcher.h"
 
+#include <algorithm>
+
 #include "entity.h"
 #include "entitysystem.h"
 
@@ -10,6 +12,58 @@ namespace pg
         constexpr const char * const DOM = "Command Dispatcher";
     }
 
+    CommandDispatcher::~CommandDispatcher()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        // Free the pending commands that never got processed
+        for (auto& buffer : buffers)
+        {
+            clearCommands(buffer->flip());
+            clearCommands(buffer->flip());
+        }
+    }
+
+    void CommandDispatcher::setNbWorkers(size_t nbWorkers)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        for (auto& buffer : buffers)
+        {
+            clearCommands(buffer->flip());
+            clearCommands(buffer->flip());
+        }
+
+        buffers.clear();
+
+        for (size_t i = 0; i < nbWorkers + 1; i++)
+            buffers.push_back(std::make_unique<CommandBuffer>());
+    }
+
+    CommandBuffer::Commands& CommandDispatcher::lockBuffer(std::unique_lock<std::mutex>& guard)
+    {
+        const auto workerId = ecsRef->executor.this_worker_id();
+
+        if (workerId >= 0 and static_cast<size_t>(workerId) + 1 < buffers.size())
+            return buffers[workerId]->lock(guard);
+
+        auto& commands = buffers.back()->lock(guard);
+
+        // The command comes from outside of the systems, the loop may be idling
+        ecsRef->wakeUp();
+
+        return commands;
+    }
+
+    Entity* CommandDispatcher::createPendingEntity(CommandBuffer::Commands& commands, _unique_id id)
+    {
+        auto entity = ::new(commands.arena.allocate<Entity>()) Entity(id, ecsRef);
+
+        commands.createdEntities.push_back(entity);
+
+        return entity;
+    }
+
     /**
      * @brief Enqueue the creation of a new entity
      * 
@@ -19,15 +73,46 @@ namespace pg
     {
         LOG_THIS_MEMBER(DOM);
 
-        auto entity = new Entity(ecsRef->registry.idGenerator.generateId(), ecsRef);
+        const auto id = ecsRef->entityIdGenerator.generateId();
 
-        if (not entityCQueue.enqueue(EntityCommand{entity, EntityCommand::EntityCommandType::creation}))
-        {
-            LOG_ERROR(DOM, "Could not enqueue the creation of entity " << entity->id);
-            return nullptr;
-        }
+        std::unique_lock<std::mutex> guard;
+
+        auto& commands = lockBuffer(guard);
 
-        return {entity, false};
+        return {createPendingEntity(commands, id), false};
+    }
+
+    /**
+     * @brief Enqueue the creation of a batch of entities
+     * 
+     * All the ids are generated at once and the whole batch is recorded under a single lock
+     * 
+     * @param nbEntities Number of entities to create
+     * @return std::vector<EntityRef> References to the newly created entities
+     */
+    std::vector<EntityRef> CommandDispatcher::createEntities(size_t nbEntities)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::vector<EntityRef> refs;
+
+        if (nbEntities == 0)
+            return refs;
+
+        const auto ids = ecsRef->entityIdGenerator.generateIdList(nbEntities);
+
+        refs.reserve(nbEntities);
+
+        std::unique_lock<std::mutex> guard;
+
+        auto& commands = lockBuffer(guard);
+
+        commands.createdEntities.reserve(commands.createdEntities.size() + nbEntities);
+
+        for (size_t i = 0; i < nbEntities; i++)
+            refs.emplace_back(createPendingEntity(commands, ids[i]), false);
+
+        return refs;
     }
 
     /**
@@ -39,83 +124,180 @@ namespace pg
     {
         LOG_THIS_MEMBER(DOM);
 
-        if (not entityDQueue.enqueue(EntityCommand{entity, EntityCommand::EntityCommandType::deletion}))
-        {
-            LOG_ERROR(DOM, "Could not enqueue the deletion of entity " << entity->id);
-        }
+        std::unique_lock<std::mutex> guard;
+
+        lockBuffer(guard).deletedEntities.push_back(entity);
     }
 
     /**
-     * @brief Process all the pending commands
+     * @brief Enqueue the deletion of a batch of entities
+     * 
+     * @param entities The entities to be deleted
      */
-    void CommandDispatcher::process()
+    void CommandDispatcher::deleteEntities(const std::vector<Entity*>& entities)
     {
         LOG_THIS_MEMBER(DOM);
 
-        // Entity commands
-        EntityCommand item1(nullptr, EntityCommand::EntityCommandType::creation);
-        EntityCommand item2(nullptr, EntityCommand::EntityCommandType::deletion);
+        std::unique_lock<std::mutex> guard;
+
+        auto& deletedEntities = lockBuffer(guard).deletedEntities;
+
+        deletedEntities.insert(deletedEntities.end(), entities.begin(), entities.end());
+    }
+
+    /**
+     * @brief Enqueue the deletion of a component
+     * 
+     * @param entity Entity of the component to be detached
+     * @param compId Id of the component to be detached
+     */
+    void CommandDispatcher::detachComp(Entity* entity, _unique_id compId)
+    {
+        LOG_THIS_MEMBER(DOM);
 
-        bool found1 = entityCQueue.try_dequeue(item1);
-        bool found2 = entityDQueue.try_dequeue(item2);
+        std::unique_lock<std::mutex> guard;
+
+        lockBuffer(guard).deletedComponents.push_back(ComponentDeleteRecord{compId, entity});
+    }
+
+    /**
+     * @brief Destroy the pending entities and components of played back commands
+     * 
+     * The vectors and the arena keep their memory so recording the next commands doesn't allocate
+     * 
+     * @param commands The commands to clear
+     */
+    void CommandDispatcher::clearCommands(CommandBuffer::Commands& commands)
+    {
+        for (auto record : commands.createdComponents)
+            record->destroy(record);
+
+        for (auto entity : commands.createdEntities)
+            entity->~Entity();
+
+        commands.createdEntities.clear();
+        commands.deletedEntities.clear();
+        commands.createdComponents.clear();
+        commands.deletedComponents.clear();
+
+        commands.arena.reset();
+    }
 
-        // Component commands
-        ComponentCreateCommand item3;
-        ComponentDeleteCommand item4;        
-        
-        bool found3 = componentCQueue.try_dequeue(item3);
-        bool found4 = componentDQueue.try_dequeue(item4);
+    /**
+     * @brief Process all the pending commands
+     */
+    void CommandDispatcher::process()
+    {
+        LOG_THIS_MEMBER(DOM);
 
-        // Put all the components in this map to be sure to only delete the components once even if two different system ask to remove it at the same time !
-        std::map<Entity*, _unique_id> componentsToBeDeleted;
+        playback.clear();
 
-        // First try to delete all the components requested
-        while (found4)
+        for (auto& buffer : buffers)
         {
-            componentsToBeDeleted.emplace(item4.entity, item4.compId);
-            // ecsRef->registry.detachComponentFromEntity(item4.entity, item4.compId);
+            auto& commands = buffer->flip();
 
-            found4 = componentDQueue.try_dequeue(item4);
+            if (not commands.empty())
+                playback.push_back(&commands);
         }
 
-        for (const auto& comp : componentsToBeDeleted)
+        if (playback.empty())
+            return;
+
+        // First delete all the components requested, deduplicated as two different system can ask to remove the same component
+        componentsToBeDeleted.clear();
+
+        for (auto commands : playback)
+            componentsToBeDeleted.insert(componentsToBeDeleted.end(), commands->deletedComponents.begin(), commands->deletedComponents.end());
+
+        std::sort(componentsToBeDeleted.begin(), componentsToBeDeleted.end(), [](const ComponentDeleteRecord& lhs, const ComponentDeleteRecord& rhs) {
+            return lhs.typeId < rhs.typeId or (lhs.typeId == rhs.typeId and lhs.entity->id < rhs.entity->id);
+        });
+
+        auto lastComponent = std::unique(componentsToBeDeleted.begin(), componentsToBeDeleted.end(), [](const ComponentDeleteRecord& lhs, const ComponentDeleteRecord& rhs) {
+            return lhs.typeId == rhs.typeId and lhs.entity == rhs.entity;
+        });
+
+        for (auto it = componentsToBeDeleted.begin(); it != lastComponent; ++it)
         {
-            ecsRef->registry.detachComponentFromEntity(comp.first, comp.second);
+            ecsRef->registry.detachComponentFromEntity(it->entity, it->typeId);
         }
 
-        // Put all the entities in this set to be sure to only delete the entities once even if two different system ask to remove it at the same time !
-        std::set<Entity*> entitiesToBeDeleted;
+        // Then delete all the entities requested, also deduplicated
+        entitiesToBeDeleted.clear();
 
-        // Then try to delete all the entities requested
-        while (found2)
-        {
-            entitiesToBeDeleted.insert(item2.entity);
-            // ecsRef->deleteEntityFromPool(item2.entity);
+        for (auto commands : playback)
+            entitiesToBeDeleted.insert(entitiesToBeDeleted.end(), commands->deletedEntities.begin(), commands->deletedEntities.end());
 
-            found2 = entityDQueue.try_dequeue(item2);
-        }
+        std::sort(entitiesToBeDeleted.begin(), entitiesToBeDeleted.end());
 
-        for (auto entity : entitiesToBeDeleted)
+        auto lastEntity = std::unique(entitiesToBeDeleted.begin(), entitiesToBeDeleted.end());
+
+        for (auto it = entitiesToBeDeleted.begin(); it != lastEntity; ++it)
         {
-            ecsRef->deleteEntityFromPool(entity);
+            ecsRef->deleteEntityFromPool(*it);
         }
 
-        // Then try to create all the new entities requested
-        while (found1)
+        // Then create all the new entities requested, growing the entity pool only once
+        size_t nbNewEntities = 0;
+
+        for (auto commands : playback)
+            nbNewEntities += commands->createdEntities.size();
+
+        if (nbNewEntities > 0)
         {
-            ecsRef->addEntityToPool(item1.entity);
-            delete item1.entity;
+            ecsRef->entityPool.reserveBatch(nbNewEntities, ecsRef->entityIdGenerator.nbIndexes());
 
-            found1 = entityCQueue.try_dequeue(item1);
+            for (auto commands : playback)
+            {
+                for (auto entity : commands->createdEntities)
+                {
+                    // An entity deleted in the same tick as its creation is never added, its id was never live so it can be reused
+                    if (std::binary_search(entitiesToBeDeleted.begin(), lastEntity, entity))
+                        ecsRef->entityIdGenerator.releaseId(entity->id);
+                    else
+                        ecsRef->addEntityToPool(entity);
+                }
+            }
         }
 
-        // Finally try to create all the components requested
-        while (found3)
+        // Finally create all the components requested, sorted by type then entity so each component set is filled in one pass
+        componentsToBeCreated.clear();
+
+        for (auto commands : playback)
+            componentsToBeCreated.insert(componentsToBeCreated.end(), commands->createdComponents.begin(), commands->createdComponents.end());
+
+        std::stable_sort(componentsToBeCreated.begin(), componentsToBeCreated.end(), [](const ComponentCreateRecord* lhs, const ComponentCreateRecord* rhs) {
+            return lhs->typeId < rhs->typeId or (lhs->typeId == rhs->typeId and entityIndex(lhs->entity.id) < entityIndex(rhs->entity.id));
+        });
+
+        for (size_t start = 0; start < componentsToBeCreated.size();)
         {
-            if (not item3.entity.empty())
-                item3.addInEcs(ecsRef, item3.entity, item3.component);
+            const auto typeId = componentsToBeCreated[start]->typeId;
 
-            found3 = componentCQueue.try_dequeue(item3);
+            size_t end = start;
+            _unique_id maxIndex = 0;
+
+            while (end < componentsToBeCreated.size() and componentsToBeCreated[end]->typeId == typeId)
+            {
+                maxIndex = std::max(maxIndex, entityIndex(componentsToBeCreated[end]->entity.id));
+                end++;
+            }
+
+            componentsToBeCreated[start]->reserve(ecsRef, end - start, maxIndex);
+
+            for (size_t i = start; i < end; i++)
+            {
+                auto record = componentsToBeCreated[i];
+
+                // Skip the components of entities that got deleted, or never created, in this tick
+                if (not record->entity.empty() and ecsRef->entityPool.has(record->entity.id))
+                    record->apply(ecsRef, record);
+            }
+
+            start = end;
         }
+
+        for (auto commands : playback)
+            clearCommands(*commands);
     }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <vector>
+#include <memory>
+
 #include "entity.h"
+#include "commandbuffer.h"
 
 #include "Memory/concurrentqueue.h"
 
@@ -39,96 +43,33 @@ namespace pg
      * This system is responsible for creating and running ECS system commands
      * Should be used for every commands that need to be executed asynchronously such as
      * creating or deleting an Entity or a component.
+     * 
+     * Structural changes are recorded in per thread command buffers and played back in bulk at the sync point:
+     * deletions are deduplicated, and component creations are sorted by (component type, entity) so each
+     * component set grows once and gets filled in a single pass.
      */
     class CommandDispatcher
     {
     public:
         typedef moodycamel::ConcurrentQueue<SysCommand>::producer_token_t CommandToken;
 
-        /**
-         * @brief Structure holding the different types of entity commands that the dispatcher can handle
-         */
-        struct EntityCommand
-        {
-            /**
-             * @brief Enum of all the different dispatchable entity commands
-             */
-            enum class EntityCommandType
-            {
-                creation = 0,
-                deletion = 1
-            };
-
-            EntityCommand(Entity *entity, const EntityCommandType& type) : entity(entity), type(type) {}
-
-            /** Underlaying entity of this command */
-            Entity *entity;
-            /** Type of action to execute in the dispatcher */
-            EntityCommandType type;
-        };
-
-        /**
-         * @brief Structure holding the different types of components commands that the dispatcher can handle
-         */
-        struct ComponentCreateCommand
-        {
-            ComponentCreateCommand() : component(nullptr) {}
-
-            ComponentCreateCommand(const ComponentCreateCommand& other) : entity(other.entity), component(other.component), addInEcs(other.addInEcs) {}
-
-            template <typename Type>
-            ComponentCreateCommand(EntityRef entity, Type *component) : entity(entity)
-            {
-                this->component = component;
-
-                setupFunctions<Type>();
-            }
-
-            void operator=(const ComponentCreateCommand& other)
-            {
-                entity = other.entity;
-                component = other.component;
-                addInEcs = other.addInEcs;
-            }
-
-            template <typename Type>
-            void setupFunctions();
-
-            EntityRef entity;
-            void *component;
-
-            void(*addInEcs)(EntitySystem*, EntityRef, void*);
-        };
-
-        struct ComponentDeleteCommand
-        {
-            ComponentDeleteCommand() {}
-
-            ComponentDeleteCommand(const ComponentDeleteCommand& other) : entity(other.entity), compId(other.compId) {}
-
-            ComponentDeleteCommand(Entity* entity, _unique_id compId) : entity(entity), compId(compId)
-            {
-            }
-
-            void operator=(const ComponentDeleteCommand& other)
-            {
-                entity = other.entity;
-                compId = other.compId;
-            }
-
-            Entity* entity;
-            _unique_id compId;
-        };
-
     public:
-        CommandDispatcher(EntitySystem *ecs) : ecsRef(ecs) { LOG_THIS_MEMBER("Command Dispatcher"); }
+        CommandDispatcher(EntitySystem *ecs) : ecsRef(ecs) { LOG_THIS_MEMBER("Command Dispatcher"); setNbWorkers(0); }
+
+        ~CommandDispatcher();
 
         /** Enqueue the creation of a new entity */
         EntityRef createEntity();
 
+        /** Enqueue the creation of a batch of entities */
+        std::vector<EntityRef> createEntities(size_t nbEntities);
+
         /** Enqueue the deletion of an entity */
         void deleteEntity(Entity* entity);
 
+        /** Enqueue the deletion of a batch of entities */
+        void deleteEntities(const std::vector<Entity*>& entities);
+
         /**
          * @brief Attach a new component to an entity
          * 
@@ -136,23 +77,22 @@ namespace pg
          * @tparam Args Type of the arguments of the component to be attached
          * @param entity Entity where the component will be attached
          * @param args Arguments used to create the component to be attached
-         * @return Type* A pointer to the newly attached component
+         * @return Type* A pointer to the pending component, valid until the next process
          */
         template <typename Type, typename... Args>
-        Type* attachComp(EntityRef entity, Args&&... args)
-        {
-            LOG_THIS_MEMBER("Command Dispatcher");
-
-            Type* comp = new Type{std::forward<Args>(args)...};
+        Type* attachComp(EntityRef entity, Args&&... args);
 
-            if (not componentCQueue.enqueue(ComponentCreateCommand{entity, comp}))
-            {
-                LOG_ERROR("Command Dispatcher", "Could not enqueue the creation of component " << typeid(Type).name());
-                return nullptr;
-            }
-
-            return comp;
-        }
+        /**
+         * @brief Attach a new component to each entity of a list, recording the whole batch under a single lock
+         * 
+         * @tparam Type Type of the components to be attached
+         * @tparam Generator Type of the function generating the components
+         * @param entities Entities where the components will be attached
+         * @param generator Function called as generator(i) to build the component of entities[i]
+         * @return std::vector<Type*> The pending components, valid until the next process
+         */
+        template <typename Type, typename Generator>
+        std::vector<Type*> attachCompBulk(const std::vector<EntityRef>& entities, const Generator& generator);
 
         /**
          * @brief Detach a component from an entity
@@ -160,15 +100,7 @@ namespace pg
          * @param entity Entity of the component to be detached
          * @param compid Id of the component to be detached
          */
-        void detachComp(Entity* entity, _unique_id compId)
-        {
-            LOG_THIS_MEMBER("Command Dispatcher");
-
-            if (not componentDQueue.enqueue(ComponentDeleteCommand{entity, compId}))
-            {
-                LOG_ERROR("Command Dispatcher", "Could not enqueue the deletion of component " << compId);
-            }
-        }
+        void detachComp(Entity* entity, _unique_id compId);
 
         /**
          * @brief Enqueue a new system command in the dispatcher
@@ -208,24 +140,46 @@ namespace pg
             return sysQueue.enqueue(token, cmd);
         }
 
+        /**
+         * @brief Create one command buffer per worker of the executor, plus one shared by all the other threads
+         * 
+         * @param nbWorkers Number of workers of the ecs executor
+         */
+        void setNbWorkers(size_t nbWorkers);
+
         /** Process all the pending commands */
         void process();
 
     private:
-        /** Pointer to the entity system */
-        EntitySystem *const ecsRef;
+        /**
+         * @brief Lock and get the commands of the buffer of the calling thread
+         * 
+         * Workers of the ecs executor get their own buffer, any other thread records in the shared buffer
+         */
+        CommandBuffer::Commands& lockBuffer(std::unique_lock<std::mutex>& guard);
+
+        /** Create a pending entity in the arena of the commands */
+        Entity* createPendingEntity(CommandBuffer::Commands& commands, _unique_id id);
+
+        /** Fill the type id and the functions of a component record */
+        template <typename Type>
+        void setupComponentRecord(TypedComponentCreateRecord<Type>* record, EntityRef entity);
 
-        /** Queue for the entity creation commands */
-        moodycamel::ConcurrentQueue<EntityCommand> entityCQueue;
+        /** Destroy everything held by played back commands and reset their arena for the next round */
+        void clearCommands(CommandBuffer::Commands& commands);
 
-        /** Queue for the entity deletion commands */
-        moodycamel::ConcurrentQueue<EntityCommand> entityDQueue;
+    private:
+        /** Pointer to the entity system */
+        EntitySystem *const ecsRef;
 
-        /** Queue for the component creation commands */
-        moodycamel::ConcurrentQueue<ComponentCreateCommand> componentCQueue;
+        /** One buffer per worker of the executor, the last one is shared by all the threads outside of the executor */
+        std::vector<std::unique_ptr<CommandBuffer>> buffers;
 
-        /** Queue for the component deletion commands */
-        moodycamel::ConcurrentQueue<ComponentDeleteCommand> componentDQueue;
+        /** Commands flipped out of the buffers for the playback, kept to reuse their memory */
+        std::vector<CommandBuffer::Commands*> playback;
+        std::vector<ComponentDeleteRecord> componentsToBeDeleted;
+        std::vector<Entity*> entitiesToBeDeleted;
+        std::vector<ComponentCreateRecord*> componentsToBeCreated;
 
         /** Queue for the system commands */
         moodycamel::ConcurrentQueue<SysCommand> sysQueue;
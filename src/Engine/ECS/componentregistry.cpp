@@ -1,16 +1,57 @@
 #include "componentregistry.h"
 
+#include "entitysystem.h"
+
 #include "Interpreter/interpretersystem.h"
 
 namespace pg
 {
     UniqueIdGenerator ComponentRegistry::globalIdGenerator;
 
+    std::atomic<size_t> ComponentRegistry::eventIndexGenerator {0};
+
     ComponentRegistry::ComponentRegistry(EntitySystem *ecs) : ecsRef(ecs)
     {
         LOG_THIS_MEMBER("ComponentRegistry");
+
+        for (auto& channel : eventChannels)
+            channel.store(nullptr, std::memory_order_relaxed);
+
+        for (auto& id : typeIds)
+            id.store(0, std::memory_order_relaxed);
     } 
 
+    tf::Executor* ComponentRegistry::getExecutor() const noexcept
+    {
+        return ecsRef ? ecsRef->getExecutor() : nullptr;
+    }
+
+    uint64_t ComponentRegistry::getNbDispatchedEvents() const
+    {
+        uint64_t total = 0;
+
+        for (const auto& channel : eventChannels)
+        {
+            if (auto c = channel.load(std::memory_order_acquire))
+                total += c->getNbDispatched();
+        }
+
+        return total;
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> ComponentRegistry::getEventCounts() const
+    {
+        std::vector<std::pair<std::string, uint64_t>> counts;
+
+        for (const auto& channel : eventChannels)
+        {
+            if (auto c = channel.load(std::memory_order_acquire))
+                counts.emplace_back(c->getEventName(), c->getNbDispatched());
+        }
+
+        return counts;
+    }
+
     ComponentRegistry::~ComponentRegistry()
     {
         LOG_THIS_MEMBER("Component Registry");
@@ -20,6 +61,9 @@ namespace pg
         for (auto group : groupStorageMap)
             delete static_cast<AbstractGroup*>(group.second);
 
+        for (auto& channel : eventChannels)
+            delete channel.load();
+
         LOG_INFO("Component Registry", "Component Registry deleted !");
     }
 
@@ -28,18 +72,29 @@ namespace pg
         LOG_THIS_MEMBER("Component Registry");
         
         // Store the listerer using the listener pointer value to be able to delete it later
-        eventStorageMap[eventId].emplace((intptr_t)listener, [eventId, listener](const std::any& event) {
-            listener->onEvent(eventId, std::any_cast<const std::shared_ptr<ClassInstance>&>(event));
-        });
+        scriptEventStorageMap[eventId].emplace((intptr_t)listener, listener);
     }
 
     void ComponentRegistry::removeEventListener(_unique_id eventId, InterpreterSystem *listener)
     {
         LOG_THIS_MEMBER("Component Registry");
 
-        if (const auto& it = eventStorageMap[eventId].find((intptr_t)listener); it != eventStorageMap[eventId].end())
+        if (const auto& it = scriptEventStorageMap[eventId].find((intptr_t)listener); it != scriptEventStorageMap[eventId].end())
         {
-            eventStorageMap[eventId].erase(it);
+            scriptEventStorageMap[eventId].erase(it);
+        }
+    }
+
+    void ComponentRegistry::processScriptEvent(_unique_id eventId, const std::shared_ptr<ClassInstance>& event)
+    {
+        LOG_THIS_MEMBER("Component Registry");
+
+        if (const auto& it = scriptEventStorageMap.find(eventId); it != scriptEventStorageMap.end())
+        {
+            for (auto& listener : it->second)
+            {
+                listener.second->onEvent(eventId, event);
+            }
         }
     }
 
@@ -47,6 +102,8 @@ namespace pg
     {
         LOG_INFO("ID", "Removing Id: " << id);
 
+        std::lock_guard<std::mutex> lock(idMapMutex);
+
         auto it = idMap.find(id);
 
         if (it == idMap.end())
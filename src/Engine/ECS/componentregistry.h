@@ -4,9 +4,12 @@
 #include <map>
 #include <unordered_map>
 #include <functional>
-#include <any>
+#include <array>
+#include <atomic>
+#include <mutex>
 
 #include "sparseset.h"
+#include "eventchannel.h"
 #include "entity.h"
 
 #include "logger.h"
@@ -40,6 +43,9 @@ namespace pg
 
     template <typename Type, typename... Types>
     struct Group;
+
+    template <typename Type, typename... Types>
+    struct OwningGroup;
     
     class EntitySystem;
 
@@ -118,6 +124,43 @@ namespace pg
         std::unordered_map<std::string, ElementType> values;
     };
 
+    /**
+     * @brief Type erased list of all the components of one type in a prefab
+     * 
+     * The components are deserialized once when the prefab is loaded, each instance of the prefab then gets a copy of them.
+     */
+    struct AbstractPrefabComponents
+    {
+        virtual ~AbstractPrefabComponents() {}
+
+        /** Deserialize a component and add it to the entity of index entityIndex in the prefab */
+        virtual void add(const UnserializedObject& serializedComponent, size_t entityIndex) = 0;
+
+        /** Attach a copy of the components to the entities of a new instance, entities being indexed as in the prefab */
+        virtual void instantiate(EntitySystem* ecs, const std::vector<EntityRef>& entities) const = 0;
+
+        virtual size_t size() const = 0;
+    };
+
+    template <typename Type>
+    struct PrefabComponents : public AbstractPrefabComponents
+    {
+        virtual void add(const UnserializedObject& serializedComponent, size_t entityIndex) override
+        {
+            components.push_back(deserialize<Type>(serializedComponent));
+            entityIndexes.push_back(entityIndex);
+        }
+
+        virtual void instantiate(EntitySystem* ecs, const std::vector<EntityRef>& entities) const override;
+
+        virtual size_t size() const override { return components.size(); }
+
+        std::vector<Type> components;
+
+        /** Index in the prefab of the entity of each component */
+        std::vector<size_t> entityIndexes;
+    };
+
     class ComponentRegistry
     {
     public:
@@ -170,24 +213,25 @@ namespace pg
         {
             LOG_THIS_MEMBER("Component Registry");
 
-            const auto& id = getTypeId<Event>();
-            
-            eventStorageMap[id].emplace((intptr_t)listener, [listener](const std::any& event)
-            {
-                listener->onEvent(std::any_cast<const Event&>(event));
-            });
+            getEventChannel<Event>()->addListener(listener);
         }
 
         template <typename Event, typename EventListener>
-        void removeEventListener(EventListener* listener)
+        void addBatchEventListener(EventListener* listener)
         {
             LOG_THIS_MEMBER("Component Registry");
 
-            const auto& id = getTypeId<Event>();
+            getEventChannel<Event>()->addBatchListener(listener);
+        }
 
-            if (const auto& it = eventStorageMap[id].find((intptr_t)listener); it != eventStorageMap[id].end())
+        template <typename Event, typename EventListener>
+        void removeEventListener(EventListener* listener)
+        {
+            LOG_THIS_MEMBER("Component Registry");
+
+            if (auto channel = findEventChannel<Event>())
             {
-                eventStorageMap[id].erase(it);
+                channel->removeListener((intptr_t)listener);
             }
         }
 
@@ -234,38 +278,73 @@ namespace pg
             }
         }
 
-        void addEventListener(EntityRef entity, _unique_id eventId, std::function<void(const std::any&)> callback)
+        template <typename Event>
+        void addEntityEventListener(EntityRef entity, const std::function<void(const Event&)>& callback)
         {
             LOG_THIS_MEMBER("Component Registry");
             
-            eventStorageMap[eventId].emplace(entity.id, callback);
+            getEventChannel<Event>()->addCallback(entity.id, callback);
         }
 
-        void removeEventListener(EntityRef entity, _unique_id eventId)
+        template <typename Event>
+        void removeEntityEventListener(EntityRef entity)
         {
             LOG_THIS_MEMBER("Component Registry");
 
-            if (const auto& it = eventStorageMap[eventId].find(entity.id); it != eventStorageMap[eventId].end())
+            if (auto channel = findEventChannel<Event>())
             {
-                eventStorageMap[eventId].erase(it);
+                channel->removeListener(entity.id);
             }
         }
 
+        /**
+         * @brief Dispatch an event to all its listeners right away
+         */
         template <typename Event>
         void processEvent(const Event& event)
         {
             LOG_THIS_MEMBER("Component Registry");
 
-            const std::any a = event;
-
-            const auto& id = getTypeId<Event>();
-
-            for (auto& eventListener : eventStorageMap[id])
+            if (auto channel = findEventChannel<Event>())
             {
-                eventListener.second(a);
+                channel->dispatch(event);
             }
         }
 
+        /**
+         * @brief Store an event in the queue of its channel, it is dispatched when the channel is processed
+         *
+         * @return AbstractEventChannel* The channel holding the event if it needs to be scheduled,
+         * nullptr if the event got coalesced in a batch that is already scheduled
+         */
+        template <typename Event>
+        AbstractEventChannel* queueEvent(const Event& event)
+        {
+            LOG_THIS_MEMBER("Component Registry");
+
+            auto channel = getEventChannel<Event>();
+
+            return channel->enqueue(event) ? channel : nullptr;
+        }
+
+        /**
+         * @brief Dispatch an event sent by a script to the interpreter systems listening to it
+         */
+        void processScriptEvent(_unique_id eventId, const std::shared_ptr<ClassInstance>& event);
+
+        /** Get the channel carrying the events of type Event, creating it if needed */
+        template <typename Event>
+        inline const AbstractEventChannel* getEventChannelOf()
+        {
+            return getEventChannel<Event>();
+        }
+
+        /** Number of events dispatched by all the channels since the start of the ecs */
+        uint64_t getNbDispatchedEvents() const;
+
+        /** Number of events dispatched since the start of the ecs for each event type that has a channel */
+        std::vector<std::pair<std::string, uint64_t>> getEventCounts() const;
+
         inline bool hasGroup(_unique_id groupId) const
         {
             return groupStorageMap.count(groupId) > 0;
@@ -314,20 +393,88 @@ namespace pg
 
             return static_cast<Group<Type, Types...>*>(groupStorageMap.at(id));
         }
+
+        template <typename Type, typename... Types>
+        void storeOwningGroup(OwningGroup<Type, Types...>* group) noexcept
+        {
+            LOG_THIS_MEMBER("Component Registry");
+
+            const auto& id = getTypeId<OwningGroup<Type, Types...>>();
+
+#ifdef PROD
+            if (const auto& it = groupStorageMap.find(id); it != groupStorageMap.end())
+            {
+                LOG_ERROR("Component Registry", "Trying to recreate an owning group that already existing with id: " << id << "Exiting");
+                return;
+            }
+#endif
+
+            groupStorageMap.emplace(id, group);
+        }
+
+        template <typename Type, typename... Types>
+        OwningGroup<Type, Types...>* retrieveOwningGroup() const
+        {
+            LOG_THIS_MEMBER("Component Registry");
+
+            const auto& id = getTypeId<OwningGroup<Type, Types...>>();
+
+#ifdef PROD
+            if (const auto& it = groupStorageMap.find(id); it == groupStorageMap.end())
+            {
+                LOG_ERROR("Component Registry", "Trying to retrieve an owning group that doesn't exist, Exiting");
+
+                throw std::runtime_error(Strfy() <<  "Owning group [" << typeid(Type).name() << "] is not registered");
+            }
+#endif
+
+            return static_cast<OwningGroup<Type, Types...>*>(groupStorageMap.at(id));
+        }
     
+        /**
+         * @brief Get the id of a type in this registry, generating it on first use
+         *
+         * Systems can be created (and so new types seen) while other systems are looking up ids.
+         * Ids live in a fixed array indexed by the global id of the type so a lookup is a single atomic load,
+         * only the generation of a new id takes the lock.
+         */
         template <typename Type>
         _unique_id getTypeId() const noexcept
         {
-            auto globalId = getGlobalGenericId<Type>();
+            const auto globalId = getGlobalGenericId<Type>();
+
+            if (globalId < MAXTYPEIDS)
+            {
+                if (auto id = typeIds[globalId].load(std::memory_order_acquire); id != 0)
+                    return id;
+            }
+
+            std::lock_guard<std::mutex> lock(idMapMutex);
+
+            if (globalId < MAXTYPEIDS)
+            {
+                // Another thread may have generated the id while we were waiting for the lock
+                auto id = typeIds[globalId].load(std::memory_order_relaxed);
 
+                if (id == 0)
+                {
+                    LOG_MILE("ID", "Generating a new id for" << typeid(Type).name());
+
+                    id = idGenerator.generateId();
+                    typeIds[globalId].store(id, std::memory_order_release);
+                }
+
+                return id;
+            }
+
+            // Past the capacity of the array the ids fall back to the map
             auto it = idMap.find(globalId);
 
-            // Todo add a variable to keep track of the running state of the ECS
             if (it == idMap.end())
             {
                 LOG_MILE("ID", "Generating a new id for" << typeid(Type).name());
 
-                return idMap[globalId] = idGenerator.generateId();
+                it = idMap.emplace(globalId, idGenerator.generateId()).first;
             }
 
             return it->second;
@@ -344,6 +491,8 @@ namespace pg
 
             LOG_MILE("ID", "Removing Type: " << typeid(Type).name() << " has global id: " << globalId);
 
+            std::lock_guard<std::mutex> lock(idMapMutex);
+
             auto it = idMap.find(globalId);
 
             if (it == idMap.end())
@@ -354,6 +503,27 @@ namespace pg
 
         void removeTypeId(_unique_id id);
 
+        /** Dense index of a component type in the entity signatures, MAXCOMPONENTTYPES if no system owns this type */
+        inline size_t getComponentIndex(_unique_id componentId) const noexcept
+        {
+            return componentId < componentIndexes.size() ? componentIndexes[componentId] : MAXCOMPONENTTYPES;
+        }
+
+        /**
+         * @brief Call func with the type id of each component set in a signature
+         * 
+         * The signature is taken by copy so func can safely detach the components from the entity
+         */
+        template <typename Func>
+        void forEachComponent(ComponentSignature signature, const Func& func) const
+        {
+            for (size_t i = 0; i < componentTypeIds.size(); ++i)
+            {
+                if (signature.test(i))
+                    func(componentTypeIds[i]);
+            }
+        }
+
         inline void detachComponentFromEntity(Entity* entity, _unique_id id) const
         {
             componentDeleteMap.at(id)(entity);
@@ -366,7 +536,7 @@ namespace pg
 
         inline void deserializeComponentToEntity(const UnserializedObject& serializedString, EntityRef entity) const
         {
-            const auto& name = serializedString.getObjectType();
+            const auto name = std::string(serializedString.getObjectType());
 
             const auto& it = componentDeserializeMap.find(name);
 
@@ -382,10 +552,37 @@ namespace pg
             }
         }
 
+        /** Create an empty component list for a prefab from the name of the type, null if no system owns a type of this name */
+        inline std::unique_ptr<AbstractPrefabComponents> makePrefabComponents(const std::string& name) const
+        {
+            const auto& it = componentPrefabMap.find(name);
+
+            if (it == componentPrefabMap.end())
+            {
+                LOG_ERROR("Component Registry", "No prefab component list for comp: " << name);
+
+                return nullptr;
+            }
+
+            return it->second();
+        }
+
         inline EntitySystem* world() const noexcept { return ecsRef; }
 
+        /** Get the executor of the ECS owning this registry, null if there is none */
+        tf::Executor* getExecutor() const noexcept;
+
+        /** Generate a new id in the type space, safe to call while other threads look up type ids */
+        inline _unique_id generateTypeId() const noexcept
+        {
+            std::lock_guard<std::mutex> lock(idMapMutex);
+
+            return idGenerator.generateId();
+        }
+
         // Common singleton system
     public:
+        /** Generator of the type ids, guarded by idMapMutex */
         mutable UniqueIdGenerator idGenerator;
 
     public:
@@ -398,11 +595,9 @@ namespace pg
         template <typename Event>
         inline size_t eventStorageMapSize() const noexcept
         {
-            const auto& id = getTypeId<Event>();
-
-            if (const auto& it = eventStorageMap.find(id); it != eventStorageMap.end())
+            if (auto channel = findEventChannel<Event>())
             {
-                return it->second.size(); 
+                return channel->nbListeners(); 
             } 
 
             LOG_ERROR("Component Registry", "Could not find event: " << typeid(Event).name());
@@ -414,29 +609,153 @@ namespace pg
         template <typename Type>
         _unique_id getGlobalGenericId() const noexcept
         {
-            static const _unique_id id = globalIdGenerator.generateId();
+            static const _unique_id id = globalIdGenerator.generateId<true>();
             return id;
         }
 
         static UniqueIdGenerator globalIdGenerator;
 
+        /** Give the next free bit of the entity signatures to a component type (or its existing one) */
+        size_t registerComponentIndex(_unique_id componentId)
+        {
+            if (auto index = getComponentIndex(componentId); index != MAXCOMPONENTTYPES)
+                return index;
+
+            if (componentTypeIds.size() >= MAXCOMPONENTTYPES)
+            {
+                LOG_ERROR("Component Registry", "Too many component types, the entity signature can only hold " << MAXCOMPONENTTYPES);
+
+                throw std::runtime_error(Strfy() << "Component [" << componentId << "] exceeds the maximum number of component types");
+            }
+
+            if (componentId >= componentIndexes.size())
+                componentIndexes.resize(componentId + 1, MAXCOMPONENTTYPES);
+
+            componentIndexes[componentId] = componentTypeIds.size();
+            componentTypeIds.push_back(componentId);
+
+            return componentIndexes[componentId];
+        }
+
+        /** Dense index of an event type, shared by all the registries */
+        template <typename Event>
+        static size_t getEventIndex() noexcept
+        {
+            static const size_t index = eventIndexGenerator++;
+            return index;
+        }
+
+        /** Get the channel of an event type or nullptr if nobody ever listened to or queued this event */
+        template <typename Event>
+        EventChannel<Event>* findEventChannel() const noexcept
+        {
+            const auto index = getEventIndex<Event>();
+
+            if (index >= MAXEVENTTYPES)
+                return nullptr;
+
+            return static_cast<EventChannel<Event>*>(eventChannels[index].load(std::memory_order_acquire));
+        }
+
+        /** Get the channel of an event type, creating it if needed */
+        template <typename Event>
+        EventChannel<Event>* getEventChannel()
+        {
+            const auto index = getEventIndex<Event>();
+
+            if (index >= MAXEVENTTYPES)
+            {
+                LOG_ERROR("Component Registry", "Too many event types, can't register event: " << typeid(Event).name());
+
+                throw std::runtime_error(Strfy() << "Event [" << typeid(Event).name() << "] exceeds the maximum number of event types");
+            }
+
+            if (auto channel = eventChannels[index].load(std::memory_order_acquire))
+                return static_cast<EventChannel<Event>*>(channel);
+
+            std::lock_guard<std::mutex> lock(eventChannelMutex);
+
+            auto channel = eventChannels[index].load(std::memory_order_relaxed);
+
+            if (not channel)
+            {
+                channel = new EventChannel<Event>(this);
+                eventChannels[index].store(channel, std::memory_order_release);
+            }
+
+            return static_cast<EventChannel<Event>*>(channel);
+        }
+
+        /** Maximum number of distinct event types, channels live in a fixed array so they can be looked up without locking */
+        static constexpr size_t MAXEVENTTYPES = 512;
+
+        static std::atomic<size_t> eventIndexGenerator;
+
+        /** Maximum number of distinct types with a lock free id lookup, the others go through idMap */
+        static constexpr size_t MAXTYPEIDS = 4096;
+
+        /** Id of each type in this registry indexed by its global id, 0 until generated */
+        mutable std::array<std::atomic<_unique_id>, MAXTYPEIDS> typeIds;
+
         mutable std::unordered_map<_unique_id, _unique_id> idMap;
 
+        /** Guard of the generation of new ids: typeIds writes, idMap and idGenerator */
+        mutable std::mutex idMapMutex;
+
     private:
         EntitySystem* const ecsRef;
 
         std::unordered_map<_unique_id, void*> componentStorageMap;
+        /** Component index of each type id, indexed by type id */
+        std::vector<size_t> componentIndexes;
+        /** Type id of each component index */
+        std::vector<_unique_id> componentTypeIds;
         std::unordered_map<_unique_id, std::function<void(Entity*)>> componentDeleteMap;
         std::unordered_map<_unique_id, std::function<void(Archive&, const Entity*)>> componentSerializeMap;
         std::unordered_map<std::string, std::function<void(const UnserializedObject&, EntityRef)>> componentDeserializeMap;
+        std::unordered_map<std::string, std::function<std::unique_ptr<AbstractPrefabComponents>()>> componentPrefabMap;
         std::unordered_map<_unique_id, void*> groupStorageMap;
-        std::unordered_map<_unique_id, std::unordered_map<intptr_t, std::function<void(const std::any&)>>> eventStorageMap;
+        std::array<std::atomic<AbstractEventChannel*>, MAXEVENTTYPES> eventChannels;
+        std::mutex eventChannelMutex;
+        std::unordered_map<_unique_id, std::unordered_map<intptr_t, InterpreterSystem*>> scriptEventStorageMap;
         std::unordered_map<std::string, std::unordered_map<intptr_t, std::function<void(const StandardEvent&)>>> standardEventStorageMap;
     };
 
     template<>
     void ComponentRegistry::processEvent(const StandardEvent& event);
 
+    template <typename Event>
+    bool EventChannel<Event>::processOne()
+    {
+        if constexpr (HasCoalescingKey<Event>::value)
+        {
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+
+                batch.swap(pending);
+                pendingIndexes.clear();
+            }
+
+            if (batch.empty())
+                return false;
+
+            dispatchBatch(batch);
+
+            batch.clear();
+
+            return true;
+        }
+
+        DequeuedEvent event;
+
+        if (not events.try_dequeue(event))
+            return false;
+
+        registry->processEvent(*event.value);
+
+        return true;
+    }
+
     template <class Type>
     struct Ref 
     {
@@ -486,6 +805,41 @@ namespace pg
         Own<Type> *ref;
     };
 
+    /**
+     * @brief Read only flavour of Ref
+     *
+     * A system holding a ReadRef promises to only read the components of this type,
+     * so it can be scheduled alongside any other system reading the same components.
+     */
+    template <class Type>
+    struct ReadRef
+    {
+        ReadRef() { LOG_THIS_MEMBER("ReadRef"); }
+
+        virtual ~ReadRef() { LOG_THIS_MEMBER("ReadRef"); }
+
+        void setRegistry(ComponentRegistry* registry)
+        {
+            LOG_THIS_MEMBER("ReadRef");
+
+            ref = registry->retrieve<Type>();
+        }
+
+        inline typename ComponentSet<Type>::ComponentSetList view() const
+        {
+            LOG_THIS_MEMBER("ReadRef");
+
+            return ref->view();
+        }
+
+        inline _unique_id getId() const
+        {
+            return ref->getId();
+        }
+
+        Own<Type> *ref = nullptr;
+    };
+
     template <class Type>
     struct Own : public Ref<Type>
     {
@@ -509,6 +863,9 @@ namespace pg
 
             // Store a pointer to this owner object in the registry
             registry->store<Type>(this);
+
+            // Parallel loops over this component run on the ecs executor
+            components.setExecutor(registry->getExecutor());
         }
 
         /**
@@ -547,7 +904,7 @@ namespace pg
             auto comp = components.addComponent(entity, std::forward<Args>(args)...);
 
             // Add the component to the entity
-            entity->componentList.emplace(_componentId);
+            entity->signature.set(_componentIndex);
 
             // Call the on component creation callbacks to register the component in potential groups
             for (const auto& callback : onComponentCreation)
@@ -570,10 +927,7 @@ namespace pg
                 callback.second(entity);
 
             // Erase the component from the entity
-            auto it = std::find(entity->componentList.begin(), entity->componentList.end(), _componentId);
-            
-            if (it != entity->componentList.end())
-                entity->componentList.erase(it);
+            entity->signature.reset(_componentIndex);
 
             // Remove the component from the sparse set
             if (components.has(entity->id))
@@ -615,6 +969,12 @@ namespace pg
         std::map<_unique_id, void(*)(EntityRef)> onComponentDeletion;
 
         _unique_id _componentId = 0;
+
+        /** Bit of this component in the entity signatures */
+        size_t _componentIndex = MAXCOMPONENTTYPES;
+
+        /** Id of the owning group that sorts the component set (0 if no group owns it) */
+        _unique_id _owningGroupId = 0;
     };
 
     template <typename Comp>
@@ -638,6 +998,13 @@ namespace pg
 
         inline bool empty() const { return component == nullptr; }
 
+        /**
+         * @brief Check if the referenced component still exists in the ecs
+         * 
+         * @return false if the component or its entity got deleted, even if the entity index was reused by a newer entity
+         */
+        bool isAlive() const;
+
         bool initialized;
         Comp* component;
         _unique_id entityId;
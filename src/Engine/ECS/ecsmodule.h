@@ -61,11 +61,10 @@ namespace pg
                 auto compList = makeList(this, {});
                 
                 size_t j = 0;
-                for (const auto& compId : entity->componentList)
-                {
-                    addToList(compList, this->token, {std::to_string(j), compId.getId()});
+                ecsRef->getComponentRegistry()->forEachComponent(entity->signature, [&](_unique_id compId) {
+                    addToList(compList, this->token, {std::to_string(j), compId});
                     j++;
-                }
+                });
 
                 addToList(entityList, this->token, {std::to_string(entity->id), compList});
             }
@@ -134,16 +133,9 @@ namespace pg
             {
                 auto sys = std::static_pointer_cast<ClassInstance>(arg);
 
-                // Todo enable sys creation during runtime
-                if (not ecsRef->isRunning())
-                {
-                    ecsRef->createInterpreterSystem(env, sys);
-                    visitor->setEcsSysFlag();
-                }
-                else
-                {
-                    LOG_ERROR("Ecs Module", "Trying to instanciate a system while ecs is running");
-                }
+                // While the ecs is running, the system starts with the next tick
+                ecsRef->createInterpreterSystem(env, sys);
+                visitor->setEcsSysFlag();
             }
 
             return nullptr; 
@@ -247,6 +239,120 @@ namespace pg
         mutable std::unordered_map<std::string, _unique_id> uniqueIds;
     };
 
+    class GetProfileFunction : public Function
+    {
+        using Function::Function;
+    public:
+        void setUp(EntitySystem *ecsRef)
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            setArity(0, 0);
+
+            this->ecsRef = ecsRef;
+        }
+
+        virtual ValuablePtr call(ValuableQueue&) override
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            auto profileList = makeList(this, {});
+
+            for (const auto& average : ecsRef->getProfiler()->getAverageDurations())
+            {
+                addToList(profileList, this->token, {average.first, static_cast<float>(average.second)});
+            }
+
+            return profileList; 
+        }
+
+        EntitySystem *ecsRef;
+    };
+
+    class GetEventCountsFunction : public Function
+    {
+        using Function::Function;
+    public:
+        void setUp(EntitySystem *ecsRef)
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            setArity(0, 0);
+
+            this->ecsRef = ecsRef;
+        }
+
+        virtual ValuablePtr call(ValuableQueue&) override
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            auto countList = makeList(this, {});
+
+            for (const auto& count : ecsRef->getComponentRegistry()->getEventCounts())
+            {
+                addToList(countList, this->token, {count.first, static_cast<size_t>(count.second)});
+            }
+
+            return countList; 
+        }
+
+        EntitySystem *ecsRef;
+    };
+
+    class SetProfilerEnabledFunction : public Function
+    {
+        using Function::Function;
+    public:
+        void setUp(EntitySystem *ecsRef)
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            setArity(1, 1);
+
+            this->ecsRef = ecsRef;
+        }
+
+        virtual ValuablePtr call(ValuableQueue& args) override
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            auto enabled = args.front()->getElement();
+            args.pop();
+
+            ecsRef->getProfiler()->setEnabled(enabled.get<bool>());
+
+            return nullptr;
+        }
+
+        EntitySystem *ecsRef;
+    };
+
+    class SaveProfilerTraceFunction : public Function
+    {
+        using Function::Function;
+    public:
+        void setUp(EntitySystem *ecsRef)
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            setArity(1, 1);
+
+            this->ecsRef = ecsRef;
+        }
+
+        virtual ValuablePtr call(ValuableQueue& args) override
+        {
+            LOG_THIS_MEMBER("Ecs Module");
+
+            auto path = args.front()->getElement();
+            args.pop();
+
+            return makeVar(ecsRef->getProfiler()->saveChromeTrace(path.toString()));
+        }
+
+        EntitySystem *ecsRef;
+    };
+
     struct EcsModule : public SysModule
     {
         EcsModule(EntitySystem *ecsRef)
@@ -259,6 +365,10 @@ namespace pg
             addSystemFunction<NewUniqueId>("generateNewId", ecsRef);
             addSystemFunction<NewUniqueIdFromString>("getIdFrom", ecsRef);
             addSystemFunction<DeleteEntityFromId>("deleteEntityFromId", ecsRef);            
+            addSystemFunction<GetProfileFunction>("getProfile", ecsRef);
+            addSystemFunction<GetEventCountsFunction>("getEventCounts", ecsRef);
+            addSystemFunction<SetProfilerEnabledFunction>("setProfilerEnabled", ecsRef);
+            addSystemFunction<SaveProfilerTraceFunction>("saveProfilerTrace", ecsRef);
         }
     };
 
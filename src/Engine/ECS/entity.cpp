@@ -20,21 +20,14 @@ namespace pg
 
         auto ecs = entity.world();
 
-        size_t refIdCount = 0;
+        const auto registry = ecs->getComponentRegistry();
 
-        for (const auto& comp : entity.componentList)
-        {
-            if (comp.entityHeldType == Entity::EntityHeld::EntityHeldType::id)
-            {
-                ecs->getComponentRegistry()->serializeComponentFromEntity(archive, &entity, comp.getId());
-            }
-            else
-            {
-                serialize(archive, "idRef" + std::to_string(refIdCount++), comp.getId());
-            }
-        }
+        registry->forEachComponent(entity.signature, [&archive, &entity, registry](_unique_id componentId) {
+            registry->serializeComponentFromEntity(archive, &entity, componentId);
+        });
 
-        serialize(archive, "nbRefId", refIdCount);
+        // Kept for compatibility with older saves, entities no longer hold references to other entities
+        serialize(archive, "nbRefId", static_cast<size_t>(0));
 
         archive.endSerialization();
     }
@@ -44,6 +37,11 @@ namespace pg
         return id == rhs.id;
     }
 
+    bool EntityRef::isAlive() const
+    {
+        return id != 0 and ecsRef and ecsRef->getEntity(id) != nullptr;
+    }
+
     void EntityRef::operator=(const EntityRef& rhs)
     {
         LOG_THIS_MEMBER(DOM);
@@ -59,7 +57,8 @@ namespace pg
         {
             id = rhs.id;
 
-            auto ent = rhs.ecsRef->getEntity(id);
+            // An empty ref (default constructed) is not bound to any ecs
+            auto ent = rhs.ecsRef ? rhs.ecsRef->getEntity(id) : nullptr;
 
             if (id != 0 and ent)
             {
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <set>
+#include <bitset>
 #include <algorithm>
 
 #include "Memory/memorypool.h"
@@ -19,78 +19,25 @@ namespace pg
     template <typename Type>
     struct CompRef;
 
-    struct EntityChangedEvent { _unique_id id; };
+    /** Sent each time the ui of an entity changes, coalesced so listeners get it once per entity per tick */
+    struct EntityChangedEvent
+    {
+        _unique_id id;
+
+        inline _unique_id coalescingKey() const { return id; }
+    };
+
+    /** Maximum number of component types owned in an ecs, this is the width of the entity signature */
+    constexpr size_t MAXCOMPONENTTYPES = 128;
+
+    /** Bitmask holding one bit per component type, indexed by the dense component index given by the registry */
+    typedef std::bitset<MAXCOMPONENTTYPES> ComponentSignature;
 
     class Entity
     {
     friend class EntitySystem;
     friend class CommandDispatcher;
     friend class AllocatorPool<Entity>;
-    public:
-        struct EntityHeld
-        {
-            union EntityHeldId
-            {
-                explicit EntityHeldId(Entity *ent) : entity(ent) {}
-                explicit EntityHeldId(_unique_id id) : id(id) {}
-
-                Entity *entity;
-                _unique_id id;
-            };
-
-            enum class EntityHeldType
-            {
-                entity,
-                id
-            };
-
-            explicit EntityHeld(Entity* entity) : entityHeldId(entity), entityHeldType(EntityHeldType::entity) { }
-            explicit EntityHeld(const _unique_id& id) : entityHeldId(id), entityHeldType(EntityHeldType::id) { }
-            explicit EntityHeld(const EntityHeld& other) : entityHeldId(other.entityHeldId), entityHeldType(other.entityHeldType) { }
-
-            constexpr bool operator==(_unique_id id) const
-            {
-                if (entityHeldType == EntityHeldType::entity)
-                    return entityHeldId.entity->id == id;
-                else
-                    return entityHeldId.id == id;
-            }
-
-            void operator=(Entity* entity)
-            {
-                entityHeldId.entity = entity;
-                entityHeldType = EntityHeldType::entity;
-            }
-
-            void operator=(_unique_id id)
-            {
-                entityHeldId.id = id;
-                entityHeldType = EntityHeldType::id;
-            }
-
-            void operator=(const EntityHeld& rhs)
-            {
-                entityHeldId = rhs.entityHeldId;
-                entityHeldType = rhs.entityHeldType;
-            }
-
-            _unique_id getId() const
-            {
-                if (entityHeldType == EntityHeldType::entity)
-                    return entityHeldId.entity->id;
-                else
-                    return entityHeldId.id;
-            }
-
-            operator _unique_id() const
-            {
-                return getId();
-            }
-
-            EntityHeldId entityHeldId;
-            EntityHeldType entityHeldType;
-        };
-
     public:
         // Default copy and move constructor
         // Entity(Entity& mE)              = default;
@@ -98,10 +45,8 @@ namespace pg
         // Entity(Entity&& mE)             = default;
         // Entity& operator=(Entity&& mE)  = default;
         
-        inline bool has(const _unique_id& otherId) const noexcept
-        {
-            return std::find(componentList.begin(), componentList.end(), otherId) != componentList.end();
-        }
+        /** Check if the entity has the component of type id componentId */
+        inline bool has(const _unique_id& componentId) const noexcept;
 
         template <typename Comp>
         inline bool has() const noexcept;
@@ -113,9 +58,8 @@ namespace pg
 
         _unique_id id;
 
-        // Todo make this mutable because it is only used for memoisation purposes
-        // std::unordered_map<_unique_id, Entity*> componentList;
-        std::set<EntityHeld> componentList;
+        /** One bit set per component held by this entity */
+        ComponentSignature signature;
 
         //Todo overload operator delete to call ecsRef->deleteEntity(this);
 
@@ -168,6 +112,13 @@ namespace pg
 
         inline bool empty() const { return entity == nullptr; }
 
+        /**
+         * @brief Check if the referenced entity still exists in the ecs
+         * 
+         * @return false if the entity got deleted, even if its index was reused by a newer entity
+         */
+        bool isAlive() const;
+
         bool initialized;
         Entity* entity;
         _unique_id id;
@@ -19,11 +19,43 @@ namespace
 {
     static constexpr char const * DOM = "ECS";
 
+    size_t nbExecutorThreads()
+    {
 #ifdef DEBUG
-    static constexpr size_t NBEXECUTORTHREADS = 1;
+        return 1;
+#elif defined(__EMSCRIPTEN__)
+        // The pthread pool of the web build is fixed at link time (PTHREAD_POOL_SIZE)
+        return 3;
 #else
-    static constexpr size_t NBEXECUTORTHREADS = 3;
+        // Keep one core for the main thread (window events and rendering)
+        const size_t nbCores = std::thread::hardware_concurrency();
+
+        return nbCores > 1 ? nbCores - 1 : 1;
 #endif
+    }
+
+    bool isReachable(const std::unordered_map<pg::_unique_id, std::vector<pg::_unique_id>>& successors, pg::_unique_id from, pg::_unique_id to)
+    {
+        std::vector<pg::_unique_id> stack = {from};
+        std::set<pg::_unique_id> visited;
+
+        while (not stack.empty())
+        {
+            auto current = stack.back();
+            stack.pop_back();
+
+            if (current == to)
+                return true;
+
+            if (not visited.insert(current).second)
+                continue;
+
+            if (auto it = successors.find(current); it != successors.end())
+                stack.insert(stack.end(), it->second.begin(), it->second.end());
+        }
+
+        return false;
+    }
 }
 
 namespace pg
@@ -37,47 +69,25 @@ namespace pg
     // Todo set executor depending on the configuration / env !
     // Todo better save system init
     // Maybe put the number of executors in the save file
-    EntitySystem::EntitySystem(const std::string& savePath) : registry(this), cmdDispatcher(this), saveManager(savePath), executor(NBEXECUTORTHREADS)
+    EntitySystem::EntitySystem(const std::string& savePath) : registry(this), cmdDispatcher(this), saveManager(savePath), executor(nbExecutorThreads())
     {
         LOG_THIS_MEMBER(DOM);
 
         LOG_INFO(DOM, "Starting ecs...");
 
-        saveManager.addToRegistry(&registry);
-
-        LOG_INFO(DOM, "Added save manager in ecs");
-
-        // Add the event and command dispatcher as the first element of the task flow
-        basicTask = taskflow.emplace([this]() {
-            static auto start = std::chrono::steady_clock::now();
-            static auto end = std::chrono::steady_clock::now();
-            static size_t nbExecution = 0;
-
-            end = std::chrono::steady_clock::now();
+        entityPool.setExecutor(&executor);
 
-            // During the command dispatcher no other system should be running
-            // So it should be safe to allow for creation and deletion of entities/components on the spot
-            running = false;
-            eventDispatcher.process(); 
-                        
-            cmdDispatcher.process();
+        cmdDispatcher.setNbWorkers(executor.num_workers());
 
-            if (not stopRequested)
-                running = true;
+        frameArenas.setNbSlots(executor.num_workers());
 
-            saveManager.execute();
+        basicTaskProfileId = profiler.registerName("Basic Task");
+        eventProfileId = profiler.registerName("Event Dispatcher");
+        commandProfileId = profiler.registerName("Command Dispatcher");
 
-            nbExecution++;
+        saveManager.addToRegistry(&registry);
 
-            if (std::chrono::duration_cast<std::chrono::seconds>(end - start).count() >= 1)
-            {
-                LOG_MILE(DOM, "Number of execution of the system in the last seconds: " << nbExecution);
-                currentNbOfExecution = nbExecution;
-                nbExecution = 0;
-                start = end;
-            }
-            
-            }).name("Basic Task");
+        LOG_INFO(DOM, "Added save manager in ecs");
 
         LOG_INFO(DOM, "Ecs started !");
     }
@@ -103,16 +113,44 @@ namespace pg
     EntityRef EntitySystem::createEntity()
     {
         LOG_THIS_MEMBER("ECS");
+
+        profiler.addEntitiesCreated(1);
         
         if (running)
             return cmdDispatcher.createEntity();
         else
         {
-            const auto& id = registry.idGenerator.generateId();
+            const auto& id = entityIdGenerator.generateId();
             return entityPool.addComponent(id, id, this);
         }
     }
 
+    std::vector<EntityRef> EntitySystem::createEntities(size_t nbEntities)
+    {
+        LOG_THIS_MEMBER("ECS");
+
+        profiler.addEntitiesCreated(nbEntities);
+
+        if (running)
+            return cmdDispatcher.createEntities(nbEntities);
+
+        std::vector<EntityRef> entities;
+
+        if (nbEntities == 0)
+            return entities;
+
+        const auto ids = entityIdGenerator.generateIdList(nbEntities);
+
+        entityPool.reserveBatch(nbEntities, entityIdGenerator.nbIndexes());
+
+        entities.reserve(nbEntities);
+
+        for (const auto& id : ids)
+            entities.emplace_back(entityPool.addComponent(id, id, this));
+
+        return entities;
+    }
+
     void EntitySystem::removeEntity(Entity* entity)
     {
         LOG_THIS_MEMBER("ECS");
@@ -130,16 +168,41 @@ namespace pg
             deleteEntityFromPool(entity);
     }
 
-    void EntitySystem::deleteSystem(_unique_id id)
+    void EntitySystem::removeEntities(const std::vector<EntityRef>& entities)
     {
         LOG_THIS_MEMBER("ECS");
 
-        // Todo: add support for system deletion during runtime
+        std::vector<Entity*> toRemove;
+
+        toRemove.reserve(entities.size());
+
+        for (auto entity : entities)
+        {
+            if (not entity.empty())
+                toRemove.push_back(entity);
+        }
+
         if (running)
         {
-            LOG_ERROR("ECS", "System deletion during runtime is not supported");
-            return;
+            cmdDispatcher.deleteEntities(toRemove);
         }
+        else
+        {
+            for (auto entity : toRemove)
+                deleteEntityFromPool(entity);
+        }
+    }
+
+    void EntitySystem::deleteSystem(_unique_id id)
+    {
+        LOG_THIS_MEMBER("ECS");
+
+        queueSystemChange([this, id]() { removeSystem(id); });
+    }
+
+    void EntitySystem::removeSystem(_unique_id id)
+    {
+        LOG_THIS_MEMBER("ECS");
 
         if (auto it = systems.find(id); it == systems.end())
         {
@@ -158,17 +221,7 @@ namespace pg
             }
 
             // Remove the system task from the taskflow
-            if (system->executionPolicy == ExecutionPolicy::Sequential or system->executionPolicy == ExecutionPolicy::Independent)
-            {
-                // Try to find the task in the task list
-                if (auto itTask = tasks.find(id); itTask != tasks.end())
-                {
-                    // Remove the task from the taskflow
-                    const auto& task = itTask->second;
-                    taskflow.erase(task);
-                    tasks.erase(itTask);
-                }
-            }
+            removeSystemTask(id);
 
             // Delete the system
             delete system;
@@ -176,6 +229,47 @@ namespace pg
         }
     }
 
+    void EntitySystem::queueSystemChange(std::function<void()>&& change)
+    {
+        {
+            std::lock_guard<std::mutex> lock(systemChangeMutex);
+
+            if (executing)
+            {
+                pendingSystemChanges.push_back(std::move(change));
+                wakeUp();
+                return;
+            }
+        }
+
+        change();
+    }
+
+    void EntitySystem::applyPendingSystemChanges()
+    {
+        LOG_THIS_MEMBER("ECS");
+
+        std::vector<std::function<void()>> changes;
+
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(systemChangeMutex);
+
+                if (pendingSystemChanges.empty())
+                    return;
+
+                changes.swap(pendingSystemChanges);
+            }
+
+            // A change can queue other changes (a system creating a system in its init), those are applied in the next loop
+            for (auto& change : changes)
+                change();
+
+            changes.clear();
+        }
+    }
+
     void EntitySystem::executeOnce()
     {
         LOG_THIS_MEMBER("ECS");
@@ -183,19 +277,124 @@ namespace pg
         if (running)
             return;
 
+        if (taskflowDirty)
+            buildTaskflow();
+
+        {
+            std::lock_guard<std::mutex> lock(systemChangeMutex);
+            executing = true;
+        }
+
         running = true;
 
         executor.run(taskflow).wait();
 
         running = false;
+
+        {
+            std::lock_guard<std::mutex> lock(systemChangeMutex);
+            executing = false;
+        }
+
+        applyPendingSystemChanges();
     }
 
     void EntitySystem::executeAll()
     {
         LOG_THIS_MEMBER(DOM);
 
-        // runs the taskflow until we stop the system
-        executor.run_until(taskflow, [&running = running](){ return not running; });
+        // Runs the taskflow until we stop the system.
+        // Each run ends with no system task in flight, this is where the systems created or deleted during the run are applied.
+        while (running)
+        {
+            applyPendingSystemChanges();
+
+            if (taskflowDirty)
+                buildTaskflow();
+
+            tickStartTime.store(profiler.now(), std::memory_order_relaxed);
+            nbSystemRuns.store(0, std::memory_order_relaxed);
+
+            executor.run(taskflow).wait();
+
+            waitForNextTick();
+        }
+    }
+
+    void EntitySystem::waitForNextTick()
+    {
+        const auto now = profiler.now();
+        const auto clockNow = std::chrono::steady_clock::now();
+        const auto period = tickPeriod.load(std::memory_order_relaxed);
+
+        int64_t tickTime = now;
+
+        if (period > 0)
+        {
+            nextTickTime = std::max(nextTickTime, tickStartTime.load(std::memory_order_relaxed)) + period;
+
+            // When a tick took more than a whole period, restart the timestep from now instead of running a burst of ticks
+            if (nextTickTime < now)
+                nextTickTime = now;
+
+            tickTime = nextTickTime;
+        }
+
+        int64_t wakeUpTime = tickTime;
+
+        if (nbSystemRuns.load(std::memory_order_relaxed) == 0)
+        {
+            int64_t nextRunTime = now + MAXIDLESLEEP;
+
+            for (const auto& systemTask : systemTasks)
+                nextRunTime = std::min(nextRunTime, systems.at(systemTask.id)->nextRunTime());
+
+            wakeUpTime = std::max(wakeUpTime, nextRunTime);
+        }
+
+        std::unique_lock<std::mutex> lock(tickMutex);
+
+        // The work queued from other threads only cuts the idle part of the wait short, the fixed timestep is always honoured
+        tickCondition.wait_until(lock, clockNow + std::chrono::nanoseconds(wakeUpTime - now), [this]() {
+            return stopRequested or wakeUpRequested.load(std::memory_order_acquire);
+        });
+
+        tickCondition.wait_until(lock, clockNow + std::chrono::nanoseconds(tickTime - now), [this]() { return stopRequested; });
+
+        // Everything queued until now is processed by the coming tick
+        wakeUpRequested.store(false, std::memory_order_release);
+    }
+
+    void EntitySystem::setTickRate(double rate)
+    {
+        LOG_THIS_MEMBER("ECS");
+
+        if (rate < 0)
+        {
+            LOG_ERROR("ECS", "Invalid tick rate: " << rate);
+            return;
+        }
+
+        tickPeriod.store(rate > 0 ? static_cast<int64_t>(1000000000.0 / rate) : 0, std::memory_order_relaxed);
+    }
+
+    double EntitySystem::getTickRate() const
+    {
+        const auto period = tickPeriod.load(std::memory_order_relaxed);
+
+        return period > 0 ? 1000000000.0 / period : 0.0;
+    }
+
+    float EntitySystem::getInterpolationAlpha() const
+    {
+        const auto period = tickPeriod.load(std::memory_order_relaxed);
+
+        if (period <= 0)
+            return 1.0f;
+
+        const auto elapsed = profiler.now() - tickStartTime.load(std::memory_order_relaxed);
+
+        return std::clamp(static_cast<float>(elapsed) / period, 0.0f, 1.0f);
     }
 
     Entity* EntitySystem::getEntity(const std::string& name) const
@@ -204,4 +403,234 @@ namespace pg
 
         return getEntity(getSystem<EntityNameSystem>()->getEntityId(name));
     }
-}
\ No newline at end of file
+
+    void EntitySystem::addSystemTask(AbstractSystem* system, std::function<void()>&& work)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        // Only add the system to the taskflow if the execution policy is set to sequential, parallel or independent !
+        if (system->executionPolicy == ExecutionPolicy::Sequential or system->executionPolicy == ExecutionPolicy::Independent)
+        {
+            // The task only runs the system when its schedule says it is due
+            auto scheduledWork = [this, system, work = std::move(work)]()
+            {
+                if (not system->consumeTurn(profiler.now()))
+                    return;
+
+                nbSystemRuns.fetch_add(1, std::memory_order_relaxed);
+
+                work();
+            };
+
+            systemTasks.push_back(SystemTask{system->_id, std::move(scheduledWork), nullptr});
+        }
+        else if (system->executionPolicy == ExecutionPolicy::Parallel)
+        {
+            auto parallelSystem = dynamic_cast<ParallelPolicy*>(system);
+
+            if (not parallelSystem)
+            {
+                LOG_ERROR(DOM, "System [" << system->_id << "] has a parallel policy but doesn't implement ParallelPolicy, it won't be executed !");
+                return;
+            }
+
+            auto subflow = std::make_unique<tf::Taskflow>();
+
+            parallelSystem->parallelExecute(*subflow);
+
+            systemTasks.push_back(SystemTask{system->_id, nullptr, std::move(subflow)});
+        }
+        else
+        {
+            return;
+        }
+
+        // A new system only adds edges from the systems registered before it, so it can be linked in the current taskflow
+        if (not taskflowDirty)
+        {
+            createTaskNode(systemTasks.back());
+
+            deriveDependencies(systemTasks.size() - 1);
+
+            LOG_INFO(DOM, "System task [" << system->_id << "] linked in the taskflow");
+        }
+    }
+
+    void EntitySystem::removeSystemTask(_unique_id id)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        auto it = std::find_if(systemTasks.begin(), systemTasks.end(), [id](const SystemTask& task) { return task.id == id; });
+
+        if (it == systemTasks.end())
+            return;
+
+        systemTasks.erase(it);
+
+        taskOrderings.erase(std::remove_if(taskOrderings.begin(), taskOrderings.end(), [id](const std::pair<_unique_id, _unique_id>& ordering) {
+            return ordering.first == id or ordering.second == id;
+        }), taskOrderings.end());
+
+        // Removing a node can break the transitive orderings that made some derived edges unnecessary, so rebuild everything
+        taskflowDirty = true;
+    }
+
+    bool EntitySystem::hasSystemTask(_unique_id id) const
+    {
+        return std::find_if(systemTasks.begin(), systemTasks.end(), [id](const SystemTask& task) { return task.id == id; }) != systemTasks.end();
+    }
+
+    void EntitySystem::buildTaskflow()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        taskflow.clear();
+
+        taskNodes.clear();
+        taskSuccessors.clear();
+
+        // Add the event and command dispatcher as the first element of the task flow
+        basicTask = taskflow.emplace([this]() { executeBasicTask(); }).name("Basic Task");
+
+        // Every task precedes the publish task, so no system can be writing a component while it is copied
+        publishTask = taskflow.emplace([this]() { publishSnapshots(); }).name("Publish Task");
+
+        publishTask.succeed(basicTask);
+
+        for (const auto& systemTask : systemTasks)
+            createTaskNode(systemTask);
+
+        // Dependency graph between the systems, used to not add an edge between systems that are already ordered
+        // and to never close a cycle with the manual orderings.
+        for (const auto& ordering : taskOrderings)
+        {
+            taskNodes.at(ordering.first).succeed(taskNodes.at(ordering.second));
+
+            taskSuccessors[ordering.second].push_back(ordering.first);
+        }
+
+        size_t nbDerivedEdges = 0;
+
+        for (size_t j = 0; j < systemTasks.size(); j++)
+            nbDerivedEdges += deriveDependencies(j);
+
+        LOG_INFO(DOM, "Taskflow built with " << systemTasks.size() << " system tasks, " << taskOrderings.size() << " manual orderings and " << nbDerivedEdges << " derived dependencies");
+
+        taskflowDirty = false;
+    }
+
+    void EntitySystem::createTaskNode(const SystemTask& systemTask)
+    {
+        auto task = systemTask.subflow ? taskflow.composed_of(*systemTask.subflow) : taskflow.emplace(systemTask.work);
+
+        task.name(std::to_string(systemTask.id));
+
+        // Independent systems don't wait for the basic task
+        if (systems.at(systemTask.id)->executionPolicy != ExecutionPolicy::Independent)
+            task.succeed(basicTask);
+
+        publishTask.succeed(task);
+
+        taskNodes[systemTask.id] = task;
+    }
+
+    size_t EntitySystem::deriveDependencies(size_t index)
+    {
+        const auto& secondId = systemTasks[index].id;
+        const auto second = systems.at(secondId);
+
+        if (second->executionPolicy == ExecutionPolicy::Independent)
+            return 0;
+
+        size_t nbDerivedEdges = 0;
+
+        for (size_t i = 0; i < index; i++)
+        {
+            const auto& firstId = systemTasks[i].id;
+            const auto first = systems.at(firstId);
+
+            if (first->executionPolicy == ExecutionPolicy::Independent or not first->conflictsWith(second))
+                continue;
+
+            if (isReachable(taskSuccessors, firstId, secondId) or isReachable(taskSuccessors, secondId, firstId))
+                continue;
+
+            taskNodes.at(secondId).succeed(taskNodes.at(firstId));
+
+            taskSuccessors[firstId].push_back(secondId);
+
+            nbDerivedEdges++;
+        }
+
+        return nbDerivedEdges;
+    }
+
+    bool EntitySystem::isExecutorWorker()
+    {
+        const auto workerId = executor.this_worker_id();
+
+        return workerId >= 0 and static_cast<size_t>(workerId) < frameArenas.getNbSlots();
+    }
+
+    LinearArena& EntitySystem::getFrameArena()
+    {
+        if (not isExecutorWorker())
+            throw std::runtime_error("The frame arenas can only be used directly by the executor workers, use frameAllocator instead");
+
+        return frameArenas.getArena(executor.this_worker_id());
+    }
+
+    void EntitySystem::executeBasicTask()
+    {
+        static auto start = std::chrono::steady_clock::now();
+        static auto end = std::chrono::steady_clock::now();
+        static size_t nbExecution = 0;
+
+        end = std::chrono::steady_clock::now();
+
+        // During the command dispatcher no other system should be running
+        // So it should be safe to allow for creation and deletion of entities/components on the spot
+        running = false;
+
+        const auto taskStart = profiler.now();
+
+        eventDispatcher.process(); 
+
+        const auto eventEnd = profiler.now();
+                    
+        cmdDispatcher.process();
+
+        profiler.record(eventProfileId, taskStart, eventEnd);
+        profiler.record(commandProfileId, eventEnd, profiler.now());
+
+        nbTicks++;
+
+        // Release the transient data of two frames ago, the data of the last frame stays valid during this one
+        frameArenas.nextFrame();
+
+        if (not stopRequested)
+            running = true;
+
+        saveManager.execute();
+
+        profiler.record(basicTaskProfileId, taskStart, profiler.now());
+
+        profiler.endFrame(registry.getNbDispatchedEvents());
+
+        nbExecution++;
+
+        if (std::chrono::duration_cast<std::chrono::seconds>(end - start).count() >= 1)
+        {
+            LOG_MILE(DOM, "Number of execution of the system in the last seconds: " << nbExecution);
+            currentNbOfExecution = nbExecution;
+            nbExecution = 0;
+            start = end;
+        }
+    }
+
+    void EntitySystem::publishSnapshots()
+    {
+        for (auto& snapshot : snapshots)
+            snapshot->publish(nbTicks);
+    }
+}
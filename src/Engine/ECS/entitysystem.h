@@ -3,6 +3,11 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include <taskflow.hpp>
 
@@ -11,20 +16,19 @@
 #include "system.h"
 #include "commanddispatcher.h"
 #include "savemanager.h"
+#include "profiler.h"
+#include "snapshot.h"
 
 #include "serialization.h"
 
 #include "logger.h"
 #include "Memory/memorypool.h"
+#include "Memory/frameallocator.h"
 
 #include "Interpreter/interpretersystem.h"
 
 namespace pg
 {
-    // Todo create a queue that hold all entity id that got deleted to reattribute them later on
-
-    // Todo Create a different id gen for systems so that components id are smaller and more packed
-    
     // Forward declarations
     class ComponentRegistry;
     struct AbstractSystem;
@@ -33,8 +37,6 @@ namespace pg
     // This event is fired when the window is resized
     struct ResizeEvent { float width, height; };
 
-    // Todo add batching for entity and component creation/deletion
-
     template <class T>                                                  
     class HasOnCreation
     {       
@@ -68,6 +70,9 @@ namespace pg
         EntityRef entity;
     };
 
+    template <typename... Comps>
+    class CompListView;
+
     class EntitySystem
     {
     friend class Entity;
@@ -78,28 +83,34 @@ namespace pg
     friend struct OnStandardEventComponent;
     
     private:
+        /**
+         * @brief Keep the order in which deferred events were sent
+         *
+         * The events themselves are stored by value in the queue of their channel,
+         * this queue only holds the channel of each event so they are dispatched in the order they were sent.
+         */
         class EventDispatcher
         {
         public:
             EventDispatcher() {};
 
-            inline bool enqueueEvent(std::function<void()>&& event)
+            inline bool enqueueEvent(AbstractEventChannel* channel)
             {
-                return events.enqueue(event);
+                return events.enqueue(channel);
             }
 
             void process()
             {
-                std::function<void()> event;
+                AbstractEventChannel* channel;
 
-                while (events.try_dequeue(event))
+                while (events.try_dequeue(channel))
                 {
-                    event();
+                    channel->processOne();
                 }
             }
 
         private:
-            moodycamel::ConcurrentQueue<std::function<void()>> events;
+            moodycamel::ConcurrentQueue<AbstractEventChannel*> events;
         };
 
     public:
@@ -119,6 +130,11 @@ namespace pg
             stopRequested = false;
             running = true;
 
+            {
+                std::lock_guard<std::mutex> lock(systemChangeMutex);
+                executing = true;
+            }
+
             runningThread = std::thread(&EntitySystem::executeAll, this);
         }
 
@@ -132,23 +148,40 @@ namespace pg
             // if (not running)
             //     return;
 
-            stopRequested = true;
+            {
+                std::lock_guard<std::mutex> lock(tickMutex);
+                stopRequested = true;
+            }
+
             running = false;
 
+            // Don't let the loop finish its wait for the next tick
+            tickCondition.notify_all();
+
             executor.wait_for_all();
 
             if (runningThread.joinable())
                 runningThread.join();
+
+            {
+                std::lock_guard<std::mutex> lock(systemChangeMutex);
+                executing = false;
+            }
+
+            // Nothing runs anymore, the changes requested during the last tick can be applied right away
+            applyPendingSystemChanges();
         }
 
         /**
          * @brief Generate a new unique identifier (on a 64bit generator)
          * 
-         * @return _unique_id A unique identifier for Systems and Entities
+         * @return _unique_id A unique identifier in the type space (Systems, Components, Events)
+         * 
+         * Entities ids come from a separate generator, see EntityIdGenerator
          */
         inline _unique_id generateId() noexcept
         {
-            return registry.idGenerator.generateId();
+            return registry.generateTypeId();
         }
 
         /**
@@ -158,6 +191,17 @@ namespace pg
          */
         EntityRef createEntity();
 
+        /**
+         * @brief Create a batch of entities at once
+         * 
+         * All the ids are generated in one go and the entity pool only grows once for the whole batch.
+         * While the ecs is running, the whole batch is dispatched as a single command.
+         * 
+         * @param nbEntities Number of entities to create
+         * @return std::vector<EntityRef> References to the entities created
+         */
+        std::vector<EntityRef> createEntities(size_t nbEntities);
+
         /**
          * @brief Remove an Entity object
          * 
@@ -165,6 +209,13 @@ namespace pg
          */
         void removeEntity(Entity* entity);
 
+        /**
+         * @brief Remove a batch of entities at once
+         * 
+         * @param entities The entities to delete from the ecs
+         */
+        void removeEntities(const std::vector<EntityRef>& entities);
+
         /**
          * @brief Overload of the removeEntity function
          * 
@@ -180,6 +231,9 @@ namespace pg
          * 
          * All the different option are set during contruction of the system check the ctor of System for more info
          * 
+         * While the ecs is executing, the system is constructed right away but its registration is deferred to the sync point
+         * between two ticks (see queueSystemChange), so it starts running on the next tick without stopping the ecs.
+         * 
          * @tparam Sys The type of the system to create
          * @tparam Args The types of the arguments of the system
          * @param args The arguments to pass to the ctor of the newly created system
@@ -190,30 +244,24 @@ namespace pg
         {
             LOG_THIS_MEMBER("ECS");
 
-            // Todo: add support for system creation during runtime
-            if (running)
-            {
-                LOG_ERROR("ECS", "System creation during runtime is not supported");
-                return nullptr;
-            }
-
             auto system = new Sys(args...);
 
             system->_id = registry.getTypeId<Sys>();
 
             system->ecsRef = this;
 
-            system->addToRegistry(&registry);
+            queueSystemChange([this, system]()
+            {
+                system->addToRegistry(&registry);
+
+                // Named systems only get their name in addToRegistry
+                const auto profileId = profiler.registerName(system->name != "UnNamed" ? system->name : typeid(Sys).name());
 
-            systems.emplace(system->_id, system);
+                systems.emplace(system->_id, system);
 
-            // Only add the system to the taskflow if the execution policy is set to sequential or independent !
-            if (system->executionPolicy == ExecutionPolicy::Sequential)
-            {
-                auto task = taskflow.emplace([system]()
+                addSystemTask(system, [this, system, profileId]()
                 {
-                    // Todo time the whole exec of a run of the taskflow
-                    auto start = std::chrono::steady_clock::now();
+                    auto start = profiler.now();
             
                     try
                     {
@@ -224,77 +272,20 @@ namespace pg
                         LOG_ERROR("ECS", "Exception thrown whhile execution sys: " << typeid(Sys).name() << ", error: " << e.what());
                     }
 
-                    auto end = std::chrono::steady_clock::now();
-
-                    if (std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() >= 3000000)
-                        std::cout << "System " << system->name << " execute took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
-                
-                }).name(std::to_string(system->_id));
-
-                // Put the task after every other basic task
-                task.succeed(basicTask);
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
-            else if (system->executionPolicy == ExecutionPolicy::Independent)
-            {
-                auto task = taskflow.emplace([system](){system->execute();}).name(std::to_string(system->_id));
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
+                    profiler.record(profileId, start, profiler.now());
+                });
+            });
 
             return system;
         }
 
+        /** Delete the system of type Sys, deferred to the sync point between two ticks while the ecs is executing */
         template <class Sys>
-        void deleteSystem()
+        inline void deleteSystem()
         {
             LOG_THIS_MEMBER("ECS");
 
-            // Todo: add support for system deletion during runtime
-            if (running)
-            {
-                LOG_ERROR("ECS", "System deletion during runtime is not supported");
-                return;
-            }
-
-            auto id = registry.getTypeId<Sys>();
-
-            if (auto it = systems.find(id); it == systems.end())
-            {
-                LOG_ERROR("ECS", "System [" << id << "] is not registered so it cannot be deleted");
-                return;
-            }
-            else
-            {
-                auto system = it->second;
-
-                if (not system)
-                {
-                    LOG_ERROR("ECS", "System [" << id << "] is already deleted");
-                    systems.erase(it);
-                    return;
-                }
-
-                // Remove the system task from the taskflow
-                if (system->executionPolicy == ExecutionPolicy::Sequential or system->executionPolicy == ExecutionPolicy::Independent)
-                {
-                    // Try to find the task in the task list
-                    if (auto itTask = tasks.find(id); itTask != tasks.end())
-                    {
-                        // Remove the task from the taskflow
-                        const auto& task = itTask->second;
-                        taskflow.erase(task);
-                        tasks.erase(itTask);
-                    }
-                }
-
-                // Delete the system
-                delete system;
-                systems.erase(it);
-            }
+            deleteSystem(registry.getTypeId<Sys>());
         }
 
         template <class Sys, class DerivedSys, typename... Args>
@@ -310,95 +301,60 @@ namespace pg
 
             system->ecsRef = this;
 
-            system->addToRegistry(&registry);
+            queueSystemChange([this, system]()
+            {
+                system->addToRegistry(&registry);
 
-            systems.emplace(system->_id, system);
+                // Named systems only get their name in addToRegistry
+                const auto profileId = profiler.registerName(system->name != "UnNamed" ? system->name : typeid(Sys).name());
 
-            // Only add the system to the taskflow if the execution policy is set to sequential or independent !
-            if (system->executionPolicy == ExecutionPolicy::Sequential)
-            {
-                auto task = taskflow.emplace([system]()
+                systems.emplace(system->_id, system);
+
+                addSystemTask(system, [this, system, profileId]()
                 {
-                    // Todo time the whole exec of a run of the taskflow
-                    auto start = std::chrono::steady_clock::now();
+                    auto start = profiler.now();
             
                     system->execute();
 
-                    auto end = std::chrono::steady_clock::now();
-
-                    if (std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() >= 3000000)
-                        std::cout << "System " << system->name << " execute took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
-                
-                }).name(std::to_string(system->_id));
-
-                // Put the task after every other basic task
-                task.succeed(basicTask);
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
-            else if (system->executionPolicy == ExecutionPolicy::Independent)
-            {
-                auto task = taskflow.emplace([system](){system->execute();}).name(std::to_string(system->_id));
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
+                    profiler.record(profileId, start, profiler.now());
+                });
+            });
 
             return sys;
         }
 
+        /**
+         * @brief Create a system defined in a script
+         * 
+         * Like createSystem, the registration is deferred to the next sync point while the ecs is executing.
+         */
         template <typename... Args>
         InterpreterSystem* createInterpreterSystem(const Args&... args)
         {
             LOG_THIS_MEMBER("ECS");
 
-            // Todo: add support for system creation during runtime
-            if (running)
-            {
-                LOG_ERROR("ECS", "System creation during runtime is not supported");
-                return nullptr;
-            }
-
             auto system = new InterpreterSystem(args...);
-            system->_id = registry.idGenerator.generateId();
+            system->_id = registry.generateTypeId();
 
             system->ecsRef = this;
 
-            system->addToRegistry(&registry);
+            const auto profileId = profiler.registerName(system->name);
 
-            systems.emplace(system->_id, system);
-
-            // Only add the system to the taskflow if the execution policy is set to sequential or independent !
-            if (system->executionPolicy == ExecutionPolicy::Sequential)
+            queueSystemChange([this, system, profileId]()
             {
-                auto task = taskflow.emplace([system]()
+                system->addToRegistry(&registry);
+
+                systems.emplace(system->_id, system);
+
+                addSystemTask(system, [this, system, profileId]()
                 {
-                    // Todo time the whole exec of a run of the taskflow
-                    auto start = std::chrono::steady_clock::now();
+                    auto start = profiler.now();
             
                     system->execute();
 
-                    auto end = std::chrono::steady_clock::now();
-
-                    if (std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() >= 3000000)
-                        std::cout << "System " << system->name << " execute took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
-
-                }).name(std::to_string(system->_id));
-
-                // Put the task after every other basic task
-                task.succeed(basicTask);
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
-            else if (system->executionPolicy == ExecutionPolicy::Independent)
-            {
-                auto task = taskflow.emplace([system](){system->execute();}).name(std::to_string(system->_id));
-
-                // Register the task in case we need to call precede and succeed
-                tasks[system->_id] = task;
-            }
+                    profiler.record(profileId, start, profiler.now());
+                });
+            });
 
             return system;
         }
@@ -406,6 +362,8 @@ namespace pg
         /**
          * Overload of deleteSystem mainly used for deleting Interpreter system
          * 
+         * While the ecs is executing, the deletion is deferred to the sync point between two ticks
+         * 
          * @param id Id of the system to delete
          */
         void deleteSystem(_unique_id id);
@@ -419,32 +377,44 @@ namespace pg
             auto sys1Id = registry.getTypeId<SysAfter>();
             auto sys2Id = registry.getTypeId<SysBefore>();
 
-            auto it1 = tasks.find(sys1Id);
-            auto it2 = tasks.find(sys2Id);
-            
-            if (it1 != tasks.end() and it2 != tasks.end())
-            {
-                it1->second.succeed(it2->second);
-                LOG_INFO("ECS", "System " << sys1Id << " will run after system " << sys2Id << " !");
-            }
-            else if (it1 == tasks.end() and it2 != tasks.end())
-            {
-                LOG_ERROR("ECS", "Systems " << sys1Id << " is not a registered task in ecs can't reorder task !");
-            }
-            else if (it1 != tasks.end() and it2 == tasks.end())
-            {
-                LOG_ERROR("ECS", "Systems " << sys2Id << " is not a registered task in ecs can't reorder task !");
-            }
-            else
+            // Deferred like the system creations, so an ordering between systems created in the same tick is applied after them
+            queueSystemChange([this, sys1Id, sys2Id]()
             {
-                LOG_ERROR("ECS", "Both systems " << sys1Id << " and " << sys2Id << " are not registered task in ecs can't reorder their task !");
-            }
+                auto has1 = hasSystemTask(sys1Id);
+                auto has2 = hasSystemTask(sys2Id);
+                
+                if (has1 and has2)
+                {
+                    // The edge is only added to the taskflow when it is rebuilt, so the derived dependencies never create a cycle with it
+                    if (std::find(taskOrderings.begin(), taskOrderings.end(), std::make_pair(sys1Id, sys2Id)) == taskOrderings.end())
+                        taskOrderings.emplace_back(sys1Id, sys2Id);
+
+                    taskflowDirty = true;
+
+                    LOG_INFO("ECS", "System " << sys1Id << " will run after system " << sys2Id << " !");
+                }
+                else if (not has1 and has2)
+                {
+                    LOG_ERROR("ECS", "Systems " << sys1Id << " is not a registered task in ecs can't reorder task !");
+                }
+                else if (has1 and not has2)
+                {
+                    LOG_ERROR("ECS", "Systems " << sys2Id << " is not a registered task in ecs can't reorder task !");
+                }
+                else
+                {
+                    LOG_ERROR("ECS", "Both systems " << sys1Id << " and " << sys2Id << " are not registered task in ecs can't reorder their task !");
+                }
+            });
         }
 
-        inline void dumbTaskflow() const
+        inline void dumbTaskflow()
         {
             LOG_THIS_MEMBER("ECS");
 
+            if (taskflowDirty)
+                buildTaskflow();
+
             taskflow.dump(std::cout);
         }
 
@@ -490,6 +460,8 @@ namespace pg
                 
                 auto res = CompRef<Type>(component, entity.id, this, not running);
 
+                profiler.addComponentsCreated(1);
+
                 if constexpr(std::is_base_of_v<Ctor, Type>)
                     res->onCreation(entity);
 
@@ -505,6 +477,66 @@ namespace pg
             return CompRef<Type>();
         }
 
+        /**
+         * @brief Attach a component to each entity of a list
+         * 
+         * @tparam Type Type of the components to attach
+         * @tparam Generator Type of the function generating the components
+         * @param entities Entities where the components will be attached
+         * @param generator Function called as generator(i) returning the component to attach to entities[i]
+         * @return std::vector<CompRef<Type>> References to the attached components, in the same order as the entities
+         * 
+         * The component set (and its pool) is grown once for the whole batch. While the ecs is running,
+         * the whole batch is dispatched as a single command instead of one command per component.
+         */
+        template <typename Type, typename Generator>
+        std::vector<CompRef<Type>> attachBulk(const std::vector<EntityRef>& entities, const Generator& generator) noexcept
+        {
+            LOG_THIS_MEMBER("ECS");
+
+            std::vector<CompRef<Type>> res;
+
+            try
+            {
+                res.reserve(entities.size());
+
+                if (running)
+                {
+                    auto components = cmdDispatcher.attachCompBulk<Type>(entities, generator);
+
+                    for (size_t i = 0; i < entities.size(); i++)
+                        res.emplace_back(components[i], entities[i].id, this, false);
+                }
+                else
+                {
+                    auto owner = registry.retrieve<Type>();
+
+                    owner->components.reserveBatch(entities.size(), maxEntityIndex(entities));
+
+                    for (size_t i = 0; i < entities.size(); i++)
+                    {
+                        auto entity = entities[i];
+
+                        res.emplace_back(owner->internalCreateComponent(entity, generator(i)), entity.id, this);
+                    }
+                }
+
+                profiler.addComponentsCreated(entities.size());
+
+                if constexpr(std::is_base_of_v<Ctor, Type>)
+                {
+                    for (size_t i = 0; i < entities.size(); i++)
+                        res[i]->onCreation(entities[i]);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("ECS", "Can't attach the batch of components [" << typeid(Type).name() << "]: " << e.what());
+            }
+
+            return res;
+        }
+
         // template <typename Type, typename EntityHolderType, typename... Args>
         // CompRef<Type> attach(EntityHolderType entity, Args&&... args) noexcept { return attach(entity.entity, args...); }
 
@@ -545,7 +577,11 @@ namespace pg
             
             if (running)
             {
-                eventDispatcher.enqueueEvent([event, this](){ LOG_THIS("ECS"); registry.processEvent(event); });
+                if (auto channel = registry.queueEvent(event))
+                {
+                    eventDispatcher.enqueueEvent(channel);
+                    wakeUp();
+                }
             }
             else
             {
@@ -572,6 +608,14 @@ namespace pg
         template <typename Comp>
         inline Comp* getComponent(_unique_id id) const { LOG_THIS_MEMBER("ECS"); return registry.retrieve<Comp>()->getComponent(id); }
 
+        /**
+         * @brief Flag the component of type Comp of an entity as changed, so it is returned by view<Comp>().changedSince()
+         * 
+         * @param id Id of the entity whose component changed
+         */
+        template <typename Comp>
+        inline void markChanged(_unique_id id) { LOG_THIS_MEMBER("ECS"); registry.retrieve<Comp>()->components.markChanged(id); }
+
         inline ComponentSet<Entity>::ComponentSetList view() const
         {
             LOG_THIS_MEMBER("ECS");
@@ -589,20 +633,211 @@ namespace pg
             return registry.retrieve<Comp>()->view();
         }
 
+        /**
+         * @brief Get a view of all the entities that have all the requested components
+         * 
+         * @tparam Comps Types of the components to join
+         * @return CompListView<Comps...> A view yielding a CompList for each entity having all the components
+         * 
+         * The view iterates over the smallest of the component sets and probes the other ones,
+         * so no group is needed to iterate over multiple components at once.
+         */
+        template <typename Comp, typename Comp2, typename... Comps>
+        inline CompListView<Comp, Comp2, Comps...> view() const
+        {
+            LOG_THIS_MEMBER("ECS");
+
+            return CompListView<Comp, Comp2, Comps...>(this, &registry.retrieve<Comp>()->components, &registry.retrieve<Comp2>()->components, &registry.retrieve<Comps>()->components...);
+        }
+
         inline ElementType getSavedData(const std::string& id) const { return saveManager.getValue(id); }
 
         inline bool isRunning() const { return running; }
 
         inline size_t getNbSystems() const { return systems.size(); }
 
-        inline size_t getNbTasks() const { return tasks.size(); }
+        inline size_t getNbTasks() const { return systemTasks.size(); }
+
+        /** Get the executor running the taskflow of the ecs, usable to run parallel loops within systems */
+        inline tf::Executor* getExecutor() noexcept { return &executor; }
+
+        /** Get the profiler recording the duration of the systems and the counters of each frame */
+        inline Profiler* getProfiler() noexcept { return &profiler; }
+
+        /**
+         * @brief Get the frame arena of the calling executor worker
+         *
+         * Memory taken from this arena is released in bulk at the sync point of the ecs and stays valid until the end of the next frame,
+         * it is meant for the transient data that systems rebuild every frame.
+         *
+         * @warning Only the workers of the executor own an arena, any other thread (main thread, render thread, ...)
+         * must go through frameAllocator() instead. Throws if called from outside of the executor.
+         */
+        LinearArena& getFrameArena();
+
+        /** Check if the calling thread is a worker of the executor of this ecs */
+        bool isExecutorWorker();
+
+        /**
+         * @brief Get an allocator for the containers of transient data living in the frame arenas (FrameVector, FrameSet, ...)
+         *
+         * Callable from any thread: an executor worker gets its own arena without locking,
+         * the other threads share an arena guarded by a mutex.
+         */
+        template <typename Type>
+        inline FrameStdAllocator<Type> frameAllocator()
+        {
+            if (isExecutorWorker())
+                return FrameStdAllocator<Type>(&getFrameArena());
+
+            return FrameStdAllocator<Type>(&frameArenas.getSharedArena(), &frameArenas.getSharedMutex());
+        }
+
+        /** Get the frame allocator of the ecs */
+        inline const FrameAllocator& getFrameAllocator() const { return frameArenas; }
+
+        /**
+         * @brief Create a snapshot of all the components of type Comp, published at the end of each tick
+         * 
+         * Lets another thread (e.g. the render thread) read a consistent copy of the components without any lock,
+         * see ComponentSnapshot. A system owning Comp must already be created.
+         * 
+         * @tparam Comp Type of the components to copy
+         * @tparam View Type stored in the snapshot, constructed from a const Comp&
+         * @return ComponentSnapshot<Comp, View>* The snapshot, owned by the ecs
+         */
+        template <typename Comp, typename View = Comp>
+        ComponentSnapshot<Comp, View>* createSnapshot()
+        {
+            LOG_THIS_MEMBER("ECS");
+
+            auto snapshot = std::make_shared<ComponentSnapshot<Comp, View>>(&registry.retrieve<Comp>()->components);
+
+            // Published by the publish task, so it can only be added between two runs
+            // The queued change shares the ownership, so the snapshot is freed even if the change is never applied
+            queueSystemChange([this, snapshot]() { snapshots.push_back(snapshot); });
+
+            return snapshot.get();
+        }
+
+        /** Number of ticks since the creation of the ecs, a snapshot published during tick n has n as its tick */
+        inline size_t getNbTicks() const { return nbTicks; }
 
         // Todo add this in the fps system
         inline size_t getCurrentNbOfExecution() const { return currentNbOfExecution; }
 
+        /**
+         * @brief Set the number of ticks per second of the loop started with start()
+         * 
+         * With a rate, the ticks are started on a fixed timestep and the loop sleeps until the next one is due.
+         * With a rate of 0 (the default) the loop runs as fast as it can, but it still sleeps when no system was due
+         * during the last tick (see FixedRate and OnEventPolicy).
+         * 
+         * @param rate Number of ticks per second, 0 to not limit the loop
+         */
+        void setTickRate(double rate);
+
+        /** Get the number of ticks per second of the loop, 0 if it is not limited */
+        double getTickRate() const;
+
+        /**
+         * @brief Get the progression of the time since the start of the current tick, relative to the tick duration
+         * 
+         * Meant for the render thread to interpolate between the state of the last two ticks, so the frame pacing of the
+         * rendering doesn't depend on the tick rate of the ecs.
+         * The MasterRenderer exposes it to the materials as the "InterpolationAlpha" system parameter at each render.
+         * 
+         * @return float A value in [0, 1], always 1 if the tick rate is not limited
+         */
+        float getInterpolationAlpha() const;
+
     private:
         friend void serialize<>(Archive& archive, const EntitySystem& ecs);
 
+        /**
+         * @brief Task of a system that is part of the taskflow
+         */
+        struct SystemTask
+        {
+            /** Id of the system running this task */
+            _unique_id id;
+
+            /** Work done by the task during each run of the taskflow */
+            std::function<void()> work;
+
+            /** Taskflow built by a parallel system, composed in the main taskflow in place of work */
+            std::unique_ptr<tf::Taskflow> subflow;
+        };
+
+        /**
+         * @brief Register the task of a system depending on its execution policy
+         * 
+         * @param system The system to register
+         * @param work Function to run on each run of the taskflow (unused for parallel systems)
+         */
+        void addSystemTask(AbstractSystem* system, std::function<void()>&& work);
+
+        /** Remove the task of a system and all the manual orderings that involve it */
+        void removeSystemTask(_unique_id id);
+
+        /** Check if a system is part of the taskflow */
+        bool hasSystemTask(_unique_id id) const;
+
+        /**
+         * @brief Rebuild the whole taskflow from the registered system tasks
+         * 
+         * Every system task runs after the basic task (except for independent systems), then the manual orderings are applied.
+         * Finally each pair of conflicting systems (see AbstractSystem::conflictsWith) that are not already ordered
+         * get an edge following their registration order, every other system is free to run concurrently.
+         */
+        void buildTaskflow();
+
+        /** Create the node of a system task in the taskflow, without any of its dependencies on other systems */
+        void createTaskNode(const SystemTask& systemTask);
+
+        /** Order the system task at index after all the previously registered tasks it conflicts with, return the number of added edges */
+        size_t deriveDependencies(size_t index);
+
+        /**
+         * @brief Apply a change of the systems (creation, deletion or ordering) at a safe point
+         * 
+         * While the ecs is executing, the change is stored and applied between two runs of the taskflow, when no system task
+         * is running. Otherwise it is applied on the spot.
+         */
+        void queueSystemChange(std::function<void()>&& change);
+
+        /** Apply all the system changes queued during the last run, including those queued by the changes themselves */
+        void applyPendingSystemChanges();
+
+        /** Delete a system and remove its task from the taskflow right away */
+        void removeSystem(_unique_id id);
+
+        /**
+         * @brief Wait until the next tick of the loop is due
+         * 
+         * The next tick is due at the next step of the fixed timestep if a tick rate is set. If no system ran during the last tick,
+         * the loop also waits for the next fixed rate system, for at most MAXIDLESLEEP. This idle part of the wait is cut short
+         * by wakeUp() so events and commands sent from other threads are processed right away, stop() ends the whole wait.
+         */
+        void waitForNextTick();
+
+        /** Wake the loop up if it is idling between two ticks, called whenever some work is queued while the ecs is running */
+        inline void wakeUp()
+        {
+            // Only the first call since the last tick needs to notify, the flag stays set until the loop consumes it
+            if (wakeUpRequested.exchange(true, std::memory_order_acq_rel))
+                return;
+
+            std::lock_guard<std::mutex> lock(tickMutex);
+            tickCondition.notify_one();
+        }
+
+        /** Run the event and command dispatchers, this is the work of the basic task */
+        void executeBasicTask();
+
+        /** Publish all the snapshots, this is the work of the publish task */
+        void publishSnapshots();
+
         void addEntityToPool(Entity* entity)
         {
             LOG_THIS_MEMBER("ECS");
@@ -628,28 +863,34 @@ namespace pg
                 return;
             }
 
-            while (not entity->componentList.empty())
+            // A pending entity (created in the same tick) or an already deleted one doesn't own its index,
+            // releasing it would hand out an index that is still in use
+            if (not entityPool.has(entity->id))
             {
-                const auto& comp = *entity->componentList.begin();
+                LOG_MILE("ECS", "Entity [" << entity->id << "] is not in the pool, nothing to delete");
+
+                return;
+            }
 
-                if (comp.entityHeldType == Entity::EntityHeld::EntityHeldType::id)
+            registry.forEachComponent(entity->signature, [this, entity](_unique_id componentId) {
+                try
                 {
-                    try
-                    {
-                        registry.detachComponentFromEntity(entity, comp.getId());
-                    }
-                    catch (const std::exception& e)
-                    {
-                        LOG_ERROR("ECS", "Can't detach component [" << comp.getId() << "] from entity [" << entity->id << "]: " << e.what());
-                    }
+                    registry.detachComponentFromEntity(entity, componentId);
                 }
-                else
+                catch (const std::exception& e)
                 {
-                    entity->componentList.erase(entity->componentList.begin());
+                    LOG_ERROR("ECS", "Can't detach component [" << componentId << "] from entity [" << entity->id << "]: " << e.what());
                 }
-            }
+            });
+
+            entity->signature.reset();
+
+            const auto id = entity->id;
 
             entityPool.removeComponent(entity);
+
+            // The index of the entity can now be reused by a new entity (with the next generation)
+            entityIdGenerator.releaseId(id);
         }
 
         template <typename Type>
@@ -663,10 +904,21 @@ namespace pg
 
                 // Todo add a mechanism to avoid creating a component that is already attached to the entity
 
-                registry.retrieve<Type>()->internalCreateComponent(entity, *component);
+                registry.retrieve<Type>()->internalCreateComponent(entity, std::move(*component));
             }
         }
 
+        /** Get the biggest entity index of a list, used to grow the sparse arrays only once per batch */
+        static _unique_id maxEntityIndex(const std::vector<EntityRef>& entities)
+        {
+            _unique_id maxIndex = 0;
+
+            for (const auto& entity : entities)
+                maxIndex = std::max(maxIndex, entityIndex(entity.id));
+
+            return maxIndex;
+        }
+
         template <typename Type>
         void detachComponentFromPool(Entity* entity)
         {
@@ -700,12 +952,20 @@ namespace pg
 
         SaveManager saveManager;
 
+        Profiler profiler;
+
+        /** Profiler name ids of the sections of the basic task */
+        uint32_t basicTaskProfileId, eventProfileId, commandProfileId;
+
         /** Store all systems added to the ECS */
         std::map<_unique_id, AbstractSystem*> systems;
 
         /** All the entities generated from the ECS */
         ComponentSet<Entity> entityPool;
 
+        /** Generator of the entity ids, recycling the index of the deleted entities */
+        EntityIdGenerator entityIdGenerator;
+
         /** Running thread of the ECS */
         std::thread runningThread;
 
@@ -715,13 +975,267 @@ namespace pg
         /** Main executor of the ecs */
         tf::Executor executor;
 
-        /** Map of all the task associated to systems */
-        std::unordered_map<_unique_id, tf::Task> tasks;
+        /** Arenas holding the transient data of the frames, one per worker of the executor plus one for the other threads */
+        FrameAllocator frameArenas;
+
+        /** Tasks of all the systems that are part of the taskflow, in order of registration */
+        std::vector<SystemTask> systemTasks;
+
+        /** Manual orderings of the systems requested with succeed(), stored as (after, before) pairs */
+        std::vector<std::pair<_unique_id, _unique_id>> taskOrderings;
+
+        /** Flag indicating that the taskflow needs to be rebuilt before the next run */
+        bool taskflowDirty = true;
 
         /** Last task of the mandatory ecs base systems */
         tf::Task basicTask;
+
+        /** Join point of the taskflow, it succeeds every other task and publishes the snapshots */
+        tf::Task publishTask;
+
+        /** Nodes of the system tasks in the current taskflow, used to link a new system without a full rebuild */
+        std::unordered_map<_unique_id, tf::Task> taskNodes;
+
+        /** Reachability of the nodes of the current taskflow (direct successors of each system) */
+        std::unordered_map<_unique_id, std::vector<_unique_id>> taskSuccessors;
+
+        /** Guard the pending system changes and the executing flag */
+        std::mutex systemChangeMutex;
+
+        /** System changes requested while the ecs was executing, applied in order at the next sync point */
+        std::vector<std::function<void()>> pendingSystemChanges;
+
+        /** True while a run of the taskflow is in progress or the ecs thread is started */
+        bool executing = false;
+
+        /** Longest sleep of the loop when no system is due, in ns */
+        static constexpr int64_t MAXIDLESLEEP = 1000000;
+
+        /** Duration of a tick of the loop in ns, 0 if the loop is not limited */
+        std::atomic<int64_t> tickPeriod {0};
+
+        /** Start time of the current tick in ns (on the profiler clock) */
+        std::atomic<int64_t> tickStartTime {0};
+
+        /** Time at which the next tick is due on the fixed timestep */
+        int64_t nextTickTime = 0;
+
+        /** Guard the wait of the loop between two ticks and the stop request */
+        std::mutex tickMutex;
+
+        /** Notified by stop() and wakeUp() to interrupt the wait of the loop between two ticks */
+        std::condition_variable tickCondition;
+
+        /** Set when some work was queued since the last tick, so the loop doesn't idle before processing it */
+        std::atomic<bool> wakeUpRequested {false};
+
+        /** Number of system tasks that were due and ran during the current tick */
+        std::atomic<size_t> nbSystemRuns {0};
+
+        /** Snapshots of components published at the end of each tick */
+        std::vector<std::shared_ptr<AbstractComponentSnapshot>> snapshots;
+
+        /** Number of runs of the basic task since the creation of the ecs */
+        size_t nbTicks = 0;
     };
 
+    /**
+     * @brief A view over all the entities that have every component of Comps
+     * 
+     * This view walks the dense array of the smallest component set and probes all the other sets for each entity.
+     * Iterating over it is O(n) with n the size of the smallest set, and it doesn't allocate nor fire any event.
+     * 
+     * @warning Any operation on this view is invalid if one of the component set is updated
+     */
+    template <typename... Comps>
+    class CompListView
+    {
+    public:
+        /**
+         * @brief An Iterator for iterating over the entities of the view
+         * 
+         * The iterator skips all the entities of the smallest set that are missing at least one of the components
+         */
+        class Iterator
+        {
+        friend class CompListView;
+            // Public interface
+        public:
+            /** 
+             * @brief Overload of the pre increment operator
+             * 
+             * @return The current iterator pointing to the next complete entity
+             */
+            inline Iterator& operator++() { index++; skipIncomplete(); return *this; }
+
+            /**
+             * @brief Overload of the equal operator
+             * 
+             * @param rhs Value to compare to
+             * 
+             * @return true if the value are equal
+             * @return false otherwise
+             */
+            inline bool operator==(const Iterator& rhs) const { return index == rhs.index; }
+
+            /**
+             * @brief Overload of the not equal operator
+             * 
+             * @param rhs Value to compare to
+             * 
+             * @return true if the value are not equal
+             * @return false otherwise
+             */
+            inline bool operator!=(const Iterator& rhs) const { return index != rhs.index; }
+
+            /**
+             * @brief Overload of the * operator
+             * 
+             * @return CompList<Comps...> The entity and all its requested components
+             */
+            inline CompList<Comps...> operator*() const { return view->get(view->smallestSet->at(index)); }
+
+            // Protected constructor
+        protected:
+            Iterator(const CompListView *view, size_t index) : view(view), index(index) { skipIncomplete(); }
+
+            // Private interface
+        private:
+            /** Move the iterator forward until it points to an entity having all the components */
+            inline void skipIncomplete()
+            {
+                const auto size = view->smallestSet->nbElements();
+
+                while (index < size and not view->hasAll(view->smallestSet->at(index)))
+                    index++;
+            }
+
+            /** The view iterated over */
+            const CompListView *view;
+
+            /** Current position in the dense array of the smallest set */
+            size_t index;
+        };
+
+    public:
+        /**
+         * @brief Construct a new view
+         * 
+         * @param ecs The ecs holding the entities
+         * @param sets The component sets to join
+         */
+        CompListView(const EntitySystem *ecs, const ComponentSet<Comps>*... sets) : ecsRef(ecs), sets(sets...)
+        {
+            LOG_THIS_MEMBER("Comp List View");
+
+            const SparseSet* setList[] = {sets...};
+
+            smallestSet = setList[0];
+
+            for (const auto set : setList)
+            {
+                if (set->nbElements() < smallestSet->nbElements())
+                    smallestSet = set;
+            }
+        }
+
+        /**
+         * @brief Get the head iterator
+         * 
+         * @return Iterator An iterator at the first entity having all the components
+         */
+        inline Iterator begin() const { return Iterator(this, 1); }
+
+        /**
+         * @brief Get the tail iterator
+         * 
+         * @return Iterator An iterator at the end of the view
+         */
+        inline Iterator end() const { return Iterator(this, smallestSet->nbElements()); }
+
+        /**
+         * @brief Check if an entity has all the components of the view
+         * 
+         * @param id Id of the entity
+         * @return true if the entity is present in every component set of the view
+         * @return false otherwise
+         */
+        inline bool hasAll(_unique_id id) const { return (std::get<const ComponentSet<Comps>*>(sets)->has(id) and ...); }
+
+        /**
+         * @brief Get the components of an entity
+         * 
+         * @param id Id of the entity
+         * @return CompList<Comps...> The entity and all its requested components
+         * 
+         * @warning The entity must have all the components of the view, check it with hasAll
+         */
+        inline CompList<Comps...> get(_unique_id id) const
+        {
+            return CompList<Comps...>(ecsRef->getEntity(id), CompRef<Comps>(std::get<const ComponentSet<Comps>*>(sets)->atEntity(id), id, ecsRef)...);
+        }
+
+        /**
+         * @brief Call a function on every entity of the view, in parallel on the workers of the ECS executor
+         *
+         * @tparam Func Type of the function to call, it must be callable as func(const CompList<Comps...>&)
+         * @param func The function to call on each entity having all the components
+         * @param grain Minimum number of entries of the smallest set processed by a chunk
+         *
+         * Same as ComponentSetList::parallelForEach, the chunks are cut over the dense array of the smallest set.
+         *
+         * @warning func is called concurrently, it must only touch the components it receives
+         */
+        template <typename Func>
+        void parallelForEach(const Func& func, size_t grain = 256) const
+        {
+            LOG_THIS_MEMBER("Comp List View");
+
+            auto chunk = [this, &func](size_t start, size_t end)
+            {
+                for (size_t i = start; i < end; i++)
+                {
+                    const auto id = smallestSet->at(i);
+
+                    if (hasAll(id))
+                        func(get(id));
+                }
+            };
+
+            auto executor = std::get<0>(sets)->getExecutor();
+
+            if (not executor)
+            {
+                chunk(1, smallestSet->nbElements());
+                return;
+            }
+
+            // The chunks only read the ids of the smallest set, the components they write sit at unrelated positions
+            // of the other sets, so aligning the chunks on cache lines of the ids wouldn't prevent any false sharing
+            parallelFor(*executor, 1, smallestSet->nbElements(), grain, chunk);
+        }
+
+    private:
+        /** The ecs holding the entities */
+        const EntitySystem *ecsRef;
+
+        /** All the component sets joined by this view */
+        std::tuple<const ComponentSet<Comps>*...> sets;
+
+        /** The smallest set of the view, driving the iteration */
+        const SparseSet *smallestSet;
+    };
+
+    inline bool Entity::has(const _unique_id& componentId) const noexcept
+    {
+        if (not ecsRef)
+            return false;
+
+        const auto index = ecsRef->registry.getComponentIndex(componentId);
+
+        return index < MAXCOMPONENTTYPES and signature.test(index);
+    }
+
     template <typename Comp>
     inline bool Entity::has() const noexcept
     {
@@ -781,9 +1295,7 @@ namespace pg
         
         const auto& componentId = ecsRef->getId<Comp>();
 
-        const auto& it = std::find(componentList.begin(), componentList.end(), componentId);
-
-        if (it != componentList.end())
+        if (has(componentId))
         {
             auto ent = ecsRef->getEntity(id);
             auto initialized = id != 0 and ent;
@@ -837,11 +1349,14 @@ namespace pg
 
                 ecsRef->attach<Type>(entity, comp);
             });
+
+            componentPrefabMap.emplace(Type::getType(), []() { return std::make_unique<PrefabComponents<Type>>(); });
         }
 
         componentStorageMap.emplace(id, owner);
 
         owner->_componentId = id;
+        owner->_componentIndex = registerComponentIndex(id);
     }
 
     template <typename Type>
@@ -867,6 +1382,11 @@ namespace pg
             {
                 componentDeserializeMap.erase(it);
             }
+
+            if (const auto& it = componentPrefabMap.find(Type::getType()); it != componentPrefabMap.end())
+            {
+                componentPrefabMap.erase(it);
+            }
         }
 
         if (const auto& it = componentStorageMap.find(id); it != componentStorageMap.end())
@@ -877,6 +1397,22 @@ namespace pg
         removeTypeId<Type>();
     }
 
+    template <typename Type>
+    void PrefabComponents<Type>::instantiate(EntitySystem* ecs, const std::vector<EntityRef>& entities) const
+    {
+        LOG_THIS_MEMBER("Prefab");
+
+        std::vector<EntityRef> targets;
+
+        targets.reserve(entityIndexes.size());
+
+        for (const auto& index : entityIndexes)
+            targets.push_back(entities[index]);
+
+        // The whole type is attached in one batch, the component set is grown once and the components are copied in it
+        ecs->attachBulk<Type>(targets, [this](size_t i) -> const Type& { return components[i]; });
+    }
+
     template <typename Comp>
     void CompRef<Comp>::operator=(const CompRef& rhs)
     {
@@ -910,10 +1446,17 @@ namespace pg
         }
     }
 
+    template <typename Comp>
+    bool CompRef<Comp>::isAlive() const
+    {
+        return entityId != 0 and ecsRef and ecsRef->template getComponent<Comp>(entityId) != nullptr;
+    }
+
     template <typename Comp>
     Comp* CompRef<Comp>::operator->()
     {
-        if (initialized)
+        // Packed components can move in memory so they are always fetched back from the entity id
+        if (initialized and not ComponentSet<Comp>::packed)
             return component;
         else
         {
@@ -934,7 +1477,7 @@ namespace pg
     template <typename Comp>
     CompRef<Comp>::operator Comp*()
     {
-        if (initialized)
+        if (initialized and not ComponentSet<Comp>::packed)
             return component;
         else
         {
@@ -968,7 +1511,7 @@ namespace pg
 
         setN->onComponentDeletion.emplace(id, [](EntityRef entity) {
             LOG_MILE("Group", "On component deletion for entity " << entity->id << ", sending event !");
-            entity->world()->sendEvent(OnCompDeletionCheckForGroup<Group<Type, Types...>>{entity->id, entity->componentList});
+            entity->world()->sendEvent(OnCompDeletionCheckForGroup<Group<Type, Types...>>{entity->id, entity->signature});
         });
     }
 
@@ -1042,14 +1585,128 @@ namespace pg
         // Todo sort the group
     }
 
-    template <typename Type>
-    void CommandDispatcher::ComponentCreateCommand::setupFunctions()
+    template <typename Type, typename... Types>
+    bool OwningGroup<Type, Types...>::setRegistry(ComponentRegistry* registry)
+    {
+        LOG_THIS_MEMBER("Ecs Owning Group");
+
+        auto isOwned = [](auto* owner) { return owner->_owningGroupId != 0; };
+
+        if (isOwned(registry->retrieve<Type>()) or (isOwned(registry->retrieve<Types>()) or ...))
+        {
+            LOG_ERROR("Ecs Owning Group", "A component set of the group [" << id << "] is already owned by another group");
+            return false;
+        }
+
+        auto takeOwnership = [this](auto* owner) {
+            owner->_owningGroupId = id;
+
+            owner->onComponentCreation.emplace(id, [](EntityRef entity) {
+                LOG_MILE("Owning Group", "On component creation for entity " << entity.id << ", updating group !");
+                entity->world()->getComponentRegistry()->template retrieveOwningGroup<Type, Types...>()->onComponentCreated(entity.id);
+            });
+
+            owner->onComponentDeletion.emplace(id, [](EntityRef entity) {
+                LOG_MILE("Owning Group", "On component deletion for entity " << entity.id << ", updating group !");
+                entity->world()->getComponentRegistry()->template retrieveOwningGroup<Type, Types...>()->onComponentRemoved(entity.id);
+            });
+        };
+
+        takeOwnership(registry->retrieve<Type>());
+        (takeOwnership(registry->retrieve<Types>()), ...);
+
+        this->registry = registry;
+
+        sets = std::make_tuple(&registry->retrieve<Type>()->components, &registry->retrieve<Types>()->components...);
+
+        registry->storeOwningGroup<Type, Types...>(this);
+
+        return true;
+    }
+
+    template <typename Type, typename... Types>
+    void OwningGroup<Type, Types...>::process()
+    {
+        LOG_THIS_MEMBER("Ecs Owning Group");
+
+        const SparseSet* smallestSet = std::get<ComponentSet<Type>*>(sets);
+
+        std::apply([&smallestSet](auto*... set) {
+            ((smallestSet = set->nbElements() < smallestSet->nbElements() ? set : smallestSet), ...);
+        }, sets);
+
+        LOG_INFO("Ecs Owning Group", "Smallest set has: " + std::to_string(smallestSet->nbElements()) + " elements");
+
+        // Entities are only swapped with already visited positions so a single pass over the smallest set is enough
+        for (size_t i = 1; i < smallestSet->nbElements(); i++)
+        {
+            onComponentCreated(smallestSet->at(i));
+        }
+    }
+
+    template <typename Type, typename... Args>
+    Type* CommandDispatcher::attachComp(EntityRef entity, Args&&... args)
     {
         LOG_THIS_MEMBER("Command Dispatcher");
 
-        addInEcs = [](EntitySystem* ecs, EntityRef entity, void* component) {
-            ecs->addComponentToPool(entity, static_cast<Type*>(component));
-            delete static_cast<Type*>(component);
+        std::unique_lock<std::mutex> guard;
+
+        auto& commands = lockBuffer(guard);
+
+        auto record = ::new(commands.arena.allocate<TypedComponentCreateRecord<Type>>()) TypedComponentCreateRecord<Type>(std::forward<Args>(args)...);
+
+        setupComponentRecord<Type>(record, entity);
+
+        commands.createdComponents.push_back(record);
+
+        return &record->component;
+    }
+
+    template <typename Type, typename Generator>
+    std::vector<Type*> CommandDispatcher::attachCompBulk(const std::vector<EntityRef>& entities, const Generator& generator)
+    {
+        LOG_THIS_MEMBER("Command Dispatcher");
+
+        std::vector<Type*> components;
+
+        components.reserve(entities.size());
+
+        std::unique_lock<std::mutex> guard;
+
+        auto& commands = lockBuffer(guard);
+
+        commands.createdComponents.reserve(commands.createdComponents.size() + entities.size());
+
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            auto record = ::new(commands.arena.allocate<TypedComponentCreateRecord<Type>>()) TypedComponentCreateRecord<Type>(generator(i));
+
+            setupComponentRecord<Type>(record, entities[i]);
+
+            commands.createdComponents.push_back(record);
+
+            components.push_back(&record->component);
+        }
+
+        return components;
+    }
+
+    template <typename Type>
+    void CommandDispatcher::setupComponentRecord(TypedComponentCreateRecord<Type>* record, EntityRef entity)
+    {
+        record->typeId = ecsRef->registry.template getTypeId<Type>();
+        record->entity = entity;
+
+        record->reserve = [](EntitySystem* ecs, size_t nbComponents, _unique_id maxIndex) {
+            ecs->registry.retrieve<Type>()->components.reserveBatch(nbComponents, maxIndex);
+        };
+
+        record->apply = [](EntitySystem* ecs, ComponentCreateRecord* record) {
+            ecs->addComponentToPool(record->entity, &static_cast<TypedComponentCreateRecord<Type>*>(record)->component);
+        };
+
+        record->destroy = [](ComponentCreateRecord* record) {
+            static_cast<TypedComponentCreateRecord<Type>*>(record)->~TypedComponentCreateRecord<Type>();
         };
     }
 }
\ No newline at end of file
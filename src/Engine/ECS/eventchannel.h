@@ -0,0 +1,300 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+#include <atomic>
+#include <string>
+
+#include "Memory/concurrentqueue.h"
+
+#include "uniqueid.h"
+
+namespace pg
+{
+    class ComponentRegistry;
+
+    /**
+     * @brief Detect if an event can be coalesced
+     *
+     * An event is coalesced when it exposes a coalescingKey() member, all the deferred events sharing the same key
+     * within a tick are merged into the last one sent.
+     */
+    template <class T>
+    class HasCoalescingKey
+    {
+        template <class U, class = decltype(std::declval<const U&>().coalescingKey())>
+            static std::true_type check(int);
+        template <class>
+            static std::false_type check(...);
+    public:
+        static constexpr bool value = decltype(check<T>(0))::value;
+    };
+
+    /**
+     * @brief Type erased base of an event channel
+     *
+     * Used by the event dispatcher of the ecs to process deferred events without knowing their type.
+     */
+    struct AbstractEventChannel
+    {
+        virtual ~AbstractEventChannel() {}
+
+        /** Dispatch the oldest deferred event of the channel (or the whole batch for a coalesced channel), return false if there was none */
+        virtual bool processOne() = 0;
+
+        /** Number of listeners registered on this channel */
+        virtual size_t nbListeners() const = 0;
+
+        /** Name of the event type carried by this channel */
+        virtual std::string getEventName() const = 0;
+
+        /** Number of events dispatched by this channel since its creation */
+        inline uint64_t getNbDispatched() const { return nbDispatched.load(std::memory_order_relaxed); }
+
+    protected:
+        mutable std::atomic<uint64_t> nbDispatched {0};
+    };
+
+    /**
+     * @brief Hold all the listeners and the deferred events of one event type
+     *
+     * Listeners are stored contiguously as an object pointer and a plain function pointer,
+     * so dispatching an event doesn't need any boxing, hashing or std::function call.
+     * Deferred events are stored by value in a typed concurrent queue.
+     *
+     * If the event has a coalescingKey(), deferred events are instead accumulated in a pending batch where events sharing a key
+     * are merged, and the whole batch is delivered once per tick.
+     *
+     * @tparam Event The type of event carried by this channel
+     */
+    template <typename Event>
+    class EventChannel : public AbstractEventChannel
+    {
+        struct ListenerSlot
+        {
+            /** Key used to find the listener on removal (listener address or entity id) */
+            intptr_t key;
+            void *object;
+            void (*call)(void*, const Event&);
+        };
+
+        struct BatchSlot
+        {
+            intptr_t key;
+            void *object;
+            void (*call)(void*, const std::vector<Event>&);
+        };
+
+        /** Helper used to dequeue an event that may not be default constructible or assignable */
+        struct DequeuedEvent
+        {
+            DequeuedEvent& operator=(Event&& event) { value.emplace(std::move(event)); return *this; }
+
+            std::optional<Event> value;
+        };
+
+    public:
+        typedef std::function<void(const Event&)> Callback;
+
+        // The queue starts empty, its blocks are only allocated when events get deferred
+        EventChannel(ComponentRegistry *registry) : registry(registry), events(0) {}
+
+        template <typename EventListener>
+        void addListener(EventListener *listener)
+        {
+            addSlot((intptr_t)listener, listener, [](void *object, const Event& event) { static_cast<EventListener*>(object)->onEvent(event); });
+        }
+
+        template <typename EventListener>
+        void addBatchListener(EventListener *listener)
+        {
+            for (const auto& slot : batchListeners)
+            {
+                if (slot.key == (intptr_t)listener)
+                    return;
+            }
+
+            batchListeners.push_back(BatchSlot{(intptr_t)listener, listener, [](void *object, const std::vector<Event>& events) { static_cast<EventListener*>(object)->onEvents(events); }});
+        }
+
+        void addCallback(intptr_t key, const Callback& callback)
+        {
+            if (callbacks.find(key) != callbacks.end())
+                return;
+
+            auto it = callbacks.emplace(key, std::make_unique<Callback>(callback)).first;
+
+            addSlot(key, it->second.get(), [](void *object, const Event& event) { (*static_cast<Callback*>(object))(event); });
+        }
+
+        void removeListener(intptr_t key)
+        {
+            for (auto it = listeners.begin(); it != listeners.end(); ++it)
+            {
+                if (it->key == key)
+                {
+                    // Keep the order of registration for the remaining listeners
+                    listeners.erase(it);
+                    break;
+                }
+            }
+
+            for (auto it = batchListeners.begin(); it != batchListeners.end(); ++it)
+            {
+                if (it->key == key)
+                {
+                    batchListeners.erase(it);
+                    break;
+                }
+            }
+
+            callbacks.erase(key);
+        }
+
+        void dispatch(const Event& event) const
+        {
+            nbDispatched.fetch_add(1, std::memory_order_relaxed);
+
+            // Index based loop with a copy of the slot as a listener can register new listeners during the call
+            for (size_t i = 0; i < listeners.size(); ++i)
+            {
+                const auto slot = listeners[i];
+
+                slot.call(slot.object, event);
+            }
+
+            if (batchListeners.size() > 0)
+            {
+                // Reuse the scratch batch so an immediate dispatch doesn't allocate,
+                // a nested or concurrent dispatch finds it taken and falls back to a local batch
+                if (singleInUse.test_and_set(std::memory_order_acquire))
+                {
+                    const std::vector<Event> local {event};
+
+                    dispatchToBatchListeners(local);
+                }
+                else
+                {
+                    single.clear();
+                    single.push_back(event);
+
+                    dispatchToBatchListeners(single);
+
+                    singleInUse.clear(std::memory_order_release);
+                }
+            }
+        }
+
+        /** Deliver a batch of events, batch listeners get it in one call and the other listeners get one call per event */
+        void dispatchBatch(const std::vector<Event>& batch) const
+        {
+            nbDispatched.fetch_add(batch.size(), std::memory_order_relaxed);
+
+            dispatchToBatchListeners(batch);
+
+            for (const auto& event : batch)
+            {
+                for (size_t i = 0; i < listeners.size(); ++i)
+                {
+                    const auto slot = listeners[i];
+
+                    slot.call(slot.object, event);
+                }
+            }
+        }
+
+        /**
+         * @brief Defer an event
+         *
+         * @return true if the channel needs to be scheduled in the event dispatcher,
+         * a coalesced channel only needs it for the first event of a batch
+         */
+        bool enqueue(const Event& event)
+        {
+            if constexpr (HasCoalescingKey<Event>::value)
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+
+                const auto key = event.coalescingKey();
+
+                if (auto it = pendingIndexes.find(key); it != pendingIndexes.end())
+                {
+                    pending[it->second] = event;
+                    return false;
+                }
+
+                pendingIndexes.emplace(key, pending.size());
+                pending.push_back(event);
+
+                return pending.size() == 1;
+            }
+            else
+            {
+                events.enqueue(event);
+                return true;
+            }
+        }
+
+        virtual bool processOne() override;
+
+        virtual size_t nbListeners() const override { return listeners.size() + batchListeners.size(); }
+
+        virtual std::string getEventName() const override { return typeid(Event).name(); }
+
+    private:
+        void dispatchToBatchListeners(const std::vector<Event>& events) const
+        {
+            for (size_t i = 0; i < batchListeners.size(); ++i)
+            {
+                const auto slot = batchListeners[i];
+
+                slot.call(slot.object, events);
+            }
+        }
+
+        void addSlot(intptr_t key, void *object, void (*call)(void*, const Event&))
+        {
+            for (const auto& slot : listeners)
+            {
+                if (slot.key == key)
+                    return;
+            }
+
+            listeners.push_back(ListenerSlot{key, object, call});
+        }
+
+        ComponentRegistry *registry;
+
+        std::vector<ListenerSlot> listeners;
+
+        std::vector<BatchSlot> batchListeners;
+
+        /** Storage of the callbacks registered by entities, the slots only hold a pointer to them */
+        std::unordered_map<intptr_t, std::unique_ptr<Callback>> callbacks;
+
+        moodycamel::ConcurrentQueue<Event> events;
+
+        /** Pending batch of a coalesced channel */
+        std::vector<Event> pending;
+
+        /** Batch being delivered, kept around to reuse its memory from one tick to the other */
+        std::vector<Event> batch;
+
+        /** Single event batch handed to the batch listeners on an immediate dispatch, kept to reuse its memory */
+        mutable std::vector<Event> single;
+
+        /** Set while the single event batch is being delivered */
+        mutable std::atomic_flag singleInUse = ATOMIC_FLAG_INIT;
+
+        /** Position of each coalescing key in the pending batch */
+        std::unordered_map<_unique_id, size_t> pendingIndexes;
+
+        std::mutex pendingMutex;
+    };
+}
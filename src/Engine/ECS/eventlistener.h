@@ -26,6 +26,32 @@ namespace pg
         }
     };
 
+    /**
+     * @brief Receive the events of a tick as one batch
+     *
+     * Mostly useful for coalesced events (see HasCoalescingKey), the batch doesn't contain two events with the same key.
+     * Events dispatched right away (when the ecs is not running) are received as a batch of one.
+     */
+    template<typename Event>
+    struct BatchListener
+    {
+        virtual void onEvents(const std::vector<Event>& events) = 0;
+
+        void setRegistry(ComponentRegistry* registry)
+        {
+            LOG_THIS_MEMBER("BatchListener");
+
+            registry->addBatchEventListener<Event>(this);
+        }
+
+        void unsetRegistry(ComponentRegistry* registry)
+        {
+            LOG_THIS_MEMBER("BatchListener");
+
+            registry->removeEventListener<Event>(this);
+        }
+    };
+
     template<>
     struct Listener<StandardEvent>
     {
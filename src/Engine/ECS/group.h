@@ -35,6 +35,7 @@
 #include <vector>
 #include <set>
 #include <algorithm>
+#include <tuple>
 
 // Todo to replace with the thread pool manager
 #include <functional>
@@ -118,7 +119,8 @@ namespace pg
     {
         _unique_id id;
 
-        std::set<Entity::EntityHeld> compList;
+        /** Signature of the entity before the removal of the component */
+        ComponentSignature signature;
     };
 
     struct AbstractGroup
@@ -159,7 +161,7 @@ namespace pg
         {
             LOG_THIS_MEMBER("Ecs Group");
 
-            if (registry and std::includes(event.compList.begin(), event.compList.end(), compIdList.begin(), compIdList.end()))
+            if (registry and (event.signature & mask) == mask)
             {
                 LOG_MILE("Group", "Entity " << event.id << " is in group " << this->id);
 
@@ -215,6 +217,23 @@ namespace pg
         template <typename Set>
         inline void addEventToSet(Set setN);
 
+        /** Bit of a component type in the mask, a type without a signature index can't be part of a group */
+        inline size_t maskIndex(_unique_id componentId) const
+        {
+            LOG_THIS_MEMBER("Ecs Group");
+
+            const auto index = registry->getComponentIndex(componentId);
+
+            if (index >= MAXCOMPONENTTYPES)
+            {
+                LOG_ERROR("Ecs Group", "Component [" << componentId << "] has no index in the entity signature, can't build group [" << id << "]");
+
+                throw std::runtime_error(Strfy() << "Component [" << componentId << "] of group [" << id << "] has no index in the entity signature");
+            }
+
+            return index;
+        }
+
         template <typename Set>
         inline void populateList(SetHolder<Type, Types...> **list, size_t index, Set setN)
         {
@@ -222,7 +241,7 @@ namespace pg
 
             addEventToSet(setN);
 
-            compIdList.emplace(setN->getId());
+            mask.set(maskIndex(setN->getId()));
 
             addInList(list, index, setN->components);
         }
@@ -234,7 +253,7 @@ namespace pg
 
             addEventToSet(setN);
 
-            compIdList.emplace(setN->getId());
+            mask.set(maskIndex(setN->getId()));
 
             addInList(list, index, setN->components);
 
@@ -245,7 +264,7 @@ namespace pg
         {
             LOG_THIS_MEMBER("Ecs Group");
 
-            return std::includes(entity->componentList.begin(), entity->componentList.end(), compIdList.begin(), compIdList.end());
+            return (entity->signature & mask) == mask;
         }
 
         inline EntitySystem* world() const noexcept { LOG_THIS_MEMBER("Ecs Group"); return registry->world(); }
@@ -253,7 +272,8 @@ namespace pg
         _unique_id id;
         ComponentRegistry* registry;
         GroupSet<GroupElement<Type, Types...>> elements;
-        std::set<_unique_id> compIdList;
+        /** One bit set per component type of the group */
+        ComponentSignature mask;
 
         constexpr static size_t nbOfSets = sizeof...(Types) + 1;
         SetHolder<Type, Types...> *setList[nbOfSets];
@@ -261,4 +281,162 @@ namespace pg
         std::vector<std::function<void(EntityRef)>> onAddGroup;
         std::vector<std::function<void(EntitySystem*, _unique_id)>> onDelGroup;
     };
+
+    /**
+     * @brief A group that owns the component sets of all its members
+     * 
+     * A full owning group keeps the dense arrays of all its component sets sorted, so that the first N entries
+     * of each set are exactly the members of the group in the same order.
+     * Iterating over the group is then a straight linear scan of N components in each set, without any lookup.
+     * 
+     * The group is kept up to date synchronously when a component of one of its set is created or removed.
+     * 
+     * @warning A component set can only be owned by a single owning group !
+     */
+    template <typename Type, typename... Types>
+    struct OwningGroup : public AbstractGroup
+    {
+        OwningGroup(_unique_id id) : id(id) { LOG_THIS_MEMBER("Ecs Owning Group"); }
+        virtual ~OwningGroup() { LOG_THIS_MEMBER("Ecs Owning Group"); }
+
+        /**
+         * @brief Register the group in the registry and take the ownership of all its component sets
+         * 
+         * @param registry The registry holding the component sets
+         * @return true if the group could own all the sets
+         * @return false if one of the set is already owned by another group
+         */
+        bool setRegistry(ComponentRegistry* registry);
+
+        /** Sort all the component sets so all the entities already having every components are packed in the group */
+        void process();
+
+        /**
+         * @brief Function called when a component of one of the sets is created
+         * 
+         * @param entityId Id of the entity that got a new component
+         * 
+         * If the entity now has all the components of the group, it is moved at the end of the group in all the sets
+         */
+        void onComponentCreated(_unique_id entityId)
+        {
+            LOG_THIS_MEMBER("Ecs Owning Group");
+
+            if (isEntityInGroup(entityId) or not hasAll(entityId))
+                return;
+
+            const auto index = nbElements + 1;
+
+            moveInAllSets(entityId, index);
+
+            nbElements++;
+        }
+
+        /**
+         * @brief Function called when a component of one of the sets is about to be removed
+         * 
+         * @param entityId Id of the entity that is losing a component
+         * 
+         * If the entity was in the group, it is moved at the end of the group in all the sets and the group shrinks,
+         * so the swap and pop done by the set on removal never breaks the packing of the group
+         */
+        void onComponentRemoved(_unique_id entityId)
+        {
+            LOG_THIS_MEMBER("Ecs Owning Group");
+
+            if (not isEntityInGroup(entityId))
+                return;
+
+            const auto index = nbElements;
+
+            moveInAllSets(entityId, index);
+
+            nbElements--;
+        }
+
+        /**
+         * @brief Check if an entity is a member of the group
+         * 
+         * @param entityId Id of the entity
+         * @return true if the entity is packed in the group
+         * @return false otherwise
+         */
+        inline bool isEntityInGroup(_unique_id entityId) const
+        {
+            const auto index = std::get<ComponentSet<Type>*>(sets)->find(entityId);
+
+            return index != 0 and index <= nbElements;
+        }
+
+        /**
+         * @brief Check if an entity has all the components of the group
+         * 
+         * @param entityId Id of the entity
+         * @return true if the entity is present in every component set of the group
+         * @return false otherwise
+         */
+        inline bool hasAll(_unique_id entityId) const
+        {
+            return std::apply([entityId](auto*... set) { return (set->has(entityId) and ...); }, sets);
+        }
+
+        /**
+         * @brief Get the number of entities in the group
+         * 
+         * @return size_t The number of entities in the group
+         * 
+         * The members of the group are at the indexes 1 to size() (included) of all the sets
+         */
+        inline size_t size() const { return nbElements; }
+
+        /**
+         * @brief Get the id of the entity at a given index of the group
+         * 
+         * @param index Index in the group, from 1 to size()
+         * @return _unique_id The id of the entity
+         */
+        inline _unique_id entityAt(size_t index) const { return std::get<ComponentSet<Type>*>(sets)->at(index); }
+
+        /**
+         * @brief Get a component at a given index of the group
+         * 
+         * @tparam Comp Type of the component to get
+         * @param index Index in the group, from 1 to size()
+         * @return Comp* A pointer to the component
+         */
+        template <typename Comp>
+        inline Comp* get(size_t index) const { return (*std::get<ComponentSet<Comp>*>(sets))[index]; }
+
+        /**
+         * @brief Iterate over all the members of the group
+         * 
+         * @param func A callable taking a pointer to each component of the group (Type*, Types*...)
+         * 
+         * @warning The group must not be modified during the iteration
+         */
+        template <typename Func>
+        void each(const Func& func) const
+        {
+            LOG_THIS_MEMBER("Ecs Owning Group");
+
+            for (size_t i = 1; i <= nbElements; i++)
+                func(get<Type>(i), get<Types>(i)...);
+        }
+
+        /** Internal helper function used to move the components of an entity at the same index in all the sets */
+        inline void moveInAllSets(_unique_id entityId, size_t index)
+        {
+            std::apply([entityId, index](auto*... set) { (set->swapComponents(set->find(entityId), index), ...); }, sets);
+        }
+
+        _unique_id id;
+
+        ComponentRegistry* registry = nullptr;
+
+        /** All the component sets owned by this group */
+        std::tuple<ComponentSet<Type>*, ComponentSet<Types>*...> sets;
+
+        /** Number of entities in the group */
+        size_t nbElements = 0;
+    };
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "profiler.h"
+
+#include <fstream>
+
+#include "logger.h"
+
+namespace pg
+{
+    namespace
+    {
+        constexpr const char * const DOM = "Profiler";
+
+        /** Write a string as a json string literal */
+        void writeJsonString(std::ostream& stream, const std::string& str)
+        {
+            stream << '"';
+
+            for (auto c : str)
+            {
+                switch (c)
+                {
+                    case '"':  stream << "\\\""; break;
+                    case '\\': stream << "\\\\"; break;
+                    case '\n': stream << "\\n"; break;
+                    case '\t': stream << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) >= 0x20)
+                            stream << c;
+                        break;
+                }
+            }
+
+            stream << '"';
+        }
+    }
+
+    uint32_t Profiler::registerName(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(nameMutex);
+
+        if (auto it = nameIds.find(name); it != nameIds.end())
+            return it->second;
+
+        const auto id = static_cast<uint32_t>(names.size());
+
+        names.push_back(name);
+        nameIds.emplace(name, id);
+
+        return id;
+    }
+
+    std::string Profiler::getName(uint32_t nameId) const
+    {
+        std::lock_guard<std::mutex> lock(nameMutex);
+
+        if (nameId >= names.size())
+            return "Unknown";
+
+        return names[nameId];
+    }
+
+    uint32_t Profiler::currentThreadId()
+    {
+        static std::atomic<uint32_t> nextThreadId {0};
+
+        thread_local const uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+
+        return threadId;
+    }
+
+    void Profiler::endFrame(uint64_t totalEvents)
+    {
+        const auto end = now();
+
+        if (isEnabled())
+        {
+            frames.push(FrameStats{
+                frameIndex,
+                frameStart,
+                end - frameStart,
+                totalEvents - lastTotalEvents,
+                entitiesCreated.exchange(0, std::memory_order_relaxed),
+                componentsCreated.exchange(0, std::memory_order_relaxed)});
+        }
+
+        frameIndex++;
+        lastTotalEvents = totalEvents;
+        frameStart = end;
+    }
+
+    std::unordered_map<std::string, double> Profiler::getAverageDurations() const
+    {
+        std::unordered_map<uint32_t, std::pair<int64_t, size_t>> totals;
+
+        for (const auto& sample : samples.snapshot())
+        {
+            auto& total = totals[sample.nameId];
+
+            total.first += sample.duration;
+            total.second++;
+        }
+
+        std::unordered_map<std::string, double> averages;
+
+        for (const auto& total : totals)
+            averages[getName(total.first)] = static_cast<double>(total.second.first) / total.second.second;
+
+        return averages;
+    }
+
+    void Profiler::exportChromeTrace(std::ostream& stream) const
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        const auto sampleList = samples.snapshot();
+        const auto frameList = frames.snapshot();
+
+        // Chrome traces are in microseconds
+        const auto toUs = [](int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        bool first = true;
+
+        for (const auto& sample : sampleList)
+        {
+            if (not first)
+                stream << ",";
+
+            first = false;
+
+            stream << "{\"name\":";
+            writeJsonString(stream, getName(sample.nameId));
+            stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.threadId << ",\"ts\":" << toUs(sample.start) << ",\"dur\":" << toUs(sample.duration) << "}";
+        }
+
+        for (const auto& frame : frameList)
+        {
+            if (not first)
+                stream << ",";
+
+            first = false;
+
+            stream << "{\"name\":\"Frame\",\"ph\":\"C\",\"pid\":1,\"ts\":" << toUs(frame.start) << ",\"args\":{"
+                   << "\"events\":" << frame.nbEvents << ","
+                   << "\"entities\":" << frame.nbEntitiesCreated << ","
+                   << "\"components\":" << frame.nbComponentsCreated << "}}";
+        }
+
+        stream << "]}";
+    }
+
+    bool Profiler::saveChromeTrace(const std::string& path) const
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::ofstream file(path);
+
+        if (not file)
+        {
+            LOG_ERROR(DOM, "Can't open file: " << path << " to save the trace");
+            return false;
+        }
+
+        exportChromeTrace(file);
+
+        LOG_INFO(DOM, "Saved trace in: " << path);
+
+        return true;
+    }
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace pg
+{
+    /**
+     * @brief Lock free ring buffer keeping the last Capacity values pushed
+     *
+     * Any number of threads can push at the same time, the oldest values get overwritten.
+     * Each slot is guarded by a sequence number so a reader never returns a value that is being overwritten.
+     * The values are stored as words of relaxed atomics, so a read racing with a write only gets discarded and is not a data race.
+     *
+     * @tparam T Type of the stored values, must be trivially copyable
+     * @tparam Capacity Number of values kept, must be a power of 2
+     */
+    template <typename T, size_t Capacity>
+    class RingBuffer
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "The capacity of a ring buffer must be a power of 2");
+        static_assert(std::is_trivially_copyable_v<T>, "The values of a ring buffer must be trivially copyable");
+
+        /** Number of 64 bits words holding a value */
+        static constexpr size_t NBWORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        struct Slot
+        {
+            /** 2 * index + 1 while the value of index is being written, 2 * index + 2 once it is written */
+            std::atomic<uint64_t> sequence {0};
+
+            /** Bytes of the value */
+            std::atomic<uint64_t> words[NBWORDS];
+        };
+
+    public:
+        RingBuffer() : slots(new Slot[Capacity]) {}
+
+        void push(const T& value)
+        {
+            const auto index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+
+            auto& slot = slots[index & (Capacity - 1)];
+
+            uint64_t words[NBWORDS] = {};
+            std::memcpy(words, &value, sizeof(T));
+
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < NBWORDS; ++i)
+                slot.words[i].store(words[i], std::memory_order_relaxed);
+
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+        }
+
+        /** Copy the values still in the buffer, from the oldest to the newest, the values overwritten during the copy are skipped */
+        std::vector<T> snapshot() const
+        {
+            std::vector<T> values;
+
+            const auto end = writeIndex.load(std::memory_order_acquire);
+            const auto start = end > Capacity ? end - Capacity : 0;
+
+            values.reserve(end - start);
+
+            for (auto index = start; index < end; ++index)
+            {
+                const auto& slot = slots[index & (Capacity - 1)];
+
+                if (slot.sequence.load(std::memory_order_acquire) != 2 * index + 2)
+                    continue;
+
+                uint64_t words[NBWORDS];
+
+                for (size_t i = 0; i < NBWORDS; ++i)
+                    words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (slot.sequence.load(std::memory_order_relaxed) != 2 * index + 2)
+                    continue;
+
+                T value;
+                std::memcpy(&value, words, sizeof(T));
+
+                values.push_back(value);
+            }
+
+            return values;
+        }
+
+        /** Number of values pushed since the creation of the buffer */
+        inline uint64_t nbPushed() const { return writeIndex.load(std::memory_order_relaxed); }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+    private:
+        std::unique_ptr<Slot[]> slots;
+
+        std::atomic<uint64_t> writeIndex {0};
+    };
+
+    /**
+     * @brief A timed section of a frame
+     */
+    struct ProfileSample
+    {
+        /** Id of the name of the section, see Profiler::registerName */
+        uint32_t nameId;
+
+        /** Small id of the thread that ran the section */
+        uint32_t threadId;
+
+        /** Start of the section in ns since the creation of the profiler */
+        int64_t start;
+
+        /** Duration of the section in ns */
+        int64_t duration;
+    };
+
+    /**
+     * @brief Counters of a whole tick of the ecs
+     */
+    struct FrameStats
+    {
+        uint64_t frame;
+
+        /** Start of the frame in ns since the creation of the profiler */
+        int64_t start;
+
+        int64_t duration;
+
+        uint64_t nbEvents;
+        uint64_t nbEntitiesCreated;
+        uint64_t nbComponentsCreated;
+    };
+
+    /**
+     * @brief Always on profiler of the ecs
+     *
+     * Timed sections and per frame counters are pushed in lock free ring buffers holding the last frames,
+     * recording a section only costs two clock reads and a few atomic operations.
+     * The history can be queried at any time or exported as a Chrome trace (chrome://tracing or Perfetto).
+     */
+    class Profiler
+    {
+    public:
+        /** Number of sections kept in the history */
+        static constexpr size_t SAMPLECAPACITY = 1 << 14;
+
+        /** Number of frames kept in the history */
+        static constexpr size_t FRAMECAPACITY = 1 << 10;
+
+        Profiler() : epoch(std::chrono::steady_clock::now()) {}
+
+        /** Get the id of a section name, registering it if needed */
+        uint32_t registerName(const std::string& name);
+
+        std::string getName(uint32_t nameId) const;
+
+        inline void setEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+
+        inline bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+        /** Current time in ns since the creation of the profiler */
+        inline int64_t now() const
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+        }
+
+        /** Record a timed section, start and end being times given by now() */
+        inline void record(uint32_t nameId, int64_t start, int64_t end)
+        {
+            if (isEnabled())
+                samples.push(ProfileSample{nameId, currentThreadId(), start, end - start});
+        }
+
+        inline void addEntitiesCreated(size_t nb) { entitiesCreated.fetch_add(nb, std::memory_order_relaxed); }
+
+        inline void addComponentsCreated(size_t nb) { componentsCreated.fetch_add(nb, std::memory_order_relaxed); }
+
+        /**
+         * @brief Close the current frame and push its counters in the history
+         *
+         * @param totalEvents Number of events dispatched since the start of the ecs, the frame stores the difference with the last call
+         */
+        void endFrame(uint64_t totalEvents);
+
+        inline std::vector<ProfileSample> getSamples() const { return samples.snapshot(); }
+
+        inline std::vector<FrameStats> getFrames() const { return frames.snapshot(); }
+
+        /** Average duration in ns of each section name over the history */
+        std::unordered_map<std::string, double> getAverageDurations() const;
+
+        /** Write the history as a Chrome trace_event json */
+        void exportChromeTrace(std::ostream& stream) const;
+
+        /** Write the history as a Chrome trace_event json file, return false if the file can't be opened */
+        bool saveChromeTrace(const std::string& path) const;
+
+        /** Small sequential id of the calling thread */
+        static uint32_t currentThreadId();
+
+    private:
+        const std::chrono::steady_clock::time_point epoch;
+
+        std::atomic<bool> enabled {true};
+
+        RingBuffer<ProfileSample, SAMPLECAPACITY> samples;
+
+        RingBuffer<FrameStats, FRAMECAPACITY> frames;
+
+        std::atomic<uint64_t> entitiesCreated {0};
+        std::atomic<uint64_t> componentsCreated {0};
+
+        /** Only touched by the thread ending the frames */
+        uint64_t frameIndex = 0;
+        uint64_t lastTotalEvents = 0;
+        int64_t frameStart = 0;
+
+        /** Names of the sections, a deque so the names never move */
+        mutable std::mutex nameMutex;
+        std::deque<std::string> names;
+        std::unordered_map<std::string, uint32_t> nameIds;
+    };
+
+    /**
+     * @brief Record the lifetime of the scope as a section of the profiler
+     */
+    class ProfileScope
+    {
+    public:
+        ProfileScope(Profiler& profiler, uint32_t nameId) : profiler(profiler), nameId(nameId), start(profiler.now()) {}
+
+        ~ProfileScope() { profiler.record(nameId, start, profiler.now()); }
+
+    private:
+        Profiler& profiler;
+        uint32_t nameId;
+        int64_t start;
+    };
+}
@@ -31,6 +31,34 @@ namespace pg
     {
         /** Name of the current domain (for logging purposes)*/
         static constexpr char const * DOM = "SaveSystem";
+
+        /** Size of the length prefixed to each record of the journal */
+        constexpr size_t JOURNALRECORDHEADER = 4;
+
+        /** A journal record is the binary serialization of the changed elements prefixed by its little endian length */
+        std::string makeJournalRecord(const std::unordered_map<std::string, ElementType>& changes)
+        {
+            SaveData data;
+
+            data.elements = changes;
+
+            BinaryArchive archive;
+
+            serialize(archive, data);
+
+            const auto blob = archive.str();
+
+            std::string record;
+
+            record.reserve(JOURNALRECORDHEADER + blob.size());
+
+            for (size_t i = 0; i < JOURNALRECORDHEADER; ++i)
+                record.push_back(static_cast<char>((blob.size() >> (8 * i)) & 0xFF));
+
+            record.append(blob);
+
+            return record;
+        }
     }
 
     template <>
@@ -99,23 +127,48 @@ namespace pg
         loadSave(savePath); 
     }
 
+    SaveManager::~SaveManager()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+
+            stopRequested = true;
+        }
+
+        writerCondition.notify_all();
+
+        // The writer writes the pending changes before exiting
+        if (writer.joinable())
+            writer.join();
+    }
+
     void SaveManager::execute()
     {
-        bool needSave = false;
+        if (eventQueue.empty())
+            return;
 
-        while (not eventQueue.empty())
         {
-            needSave = true;
+            std::lock_guard<std::mutex> lock(writerMutex);
 
-            const auto& event = eventQueue.front();
+            // Only the changed elements are handed over, the writer keeps its own copy of the rest of the save
+            while (not eventQueue.empty())
+            {
+                const auto& event = eventQueue.front();
 
-            currentSave.data.elements[event.name] = event.element;
+                currentSave.data.elements[event.name] = event.element;
+                pendingChanges[event.name] = event.element;
 
-            eventQueue.pop();
+                eventQueue.pop();
+            }
         }
 
-        if (needSave)
-            save();
+        // The writer is only started with the first save, so an ecs that never saves doesn't hold an idle thread
+        if (not writer.joinable())
+            writer = std::thread(&SaveManager::runWriter, this);
+
+        writerCondition.notify_one();
     }
 
     void SaveManager::onEvent(const SaveElementEvent& event)
@@ -139,6 +192,56 @@ namespace pg
         return ElementType{};
     }
 
+    void SaveManager::setMinSaveInterval(std::chrono::milliseconds interval)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::lock_guard<std::mutex> lock(writerMutex);
+
+        minSaveInterval = interval;
+    }
+
+    void SaveManager::setSaveMode(SaveMode mode)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::lock_guard<std::mutex> lock(writerMutex);
+
+        saveMode = mode;
+    }
+
+    void SaveManager::setCompactionThreshold(size_t nbRecords)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::lock_guard<std::mutex> lock(writerMutex);
+
+        compactionThreshold = nbRecords;
+    }
+
+    void SaveManager::flush()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::unique_lock<std::mutex> lock(writerMutex);
+
+        if (pendingChanges.empty() and not writing)
+            return;
+
+        flushRequested = true;
+
+        writerCondition.notify_one();
+
+        flushedCondition.wait(lock, [this]() { return pendingChanges.empty() and not writing; });
+    }
+
+    size_t SaveManager::getNbWrites() const
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+
+        return nbWrites;
+    }
+
     void SaveManager::loadSave(const std::string& savePath)
     {
         LOG_THIS_MEMBER(DOM);
@@ -149,22 +252,149 @@ namespace pg
 
         newSave.file = saveFile;
 
-        serializer.setFile(saveFile);
+        // The serializer is only used to read the save, it must not write anything back as the writer thread owns the file
+        Serializer serializer(saveFile, false);
 
         newSave.data = serializer.deserializeObject<SaveData>("savedata");
 
         currentSave = newSave;
+
+        journal = UniversalFileAccessor::openBinaryFile(saveFile.filepath + ".journal");
+
+        replayJournal();
+
+        writtenData = currentSave.data;
+    }
+
+    void SaveManager::replayJournal()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (journal.data.empty())
+            return;
+
+        const auto& data = journal.data;
+
+        size_t pos = 0;
+
+        while (pos + JOURNALRECORDHEADER <= data.size())
+        {
+            size_t size = 0;
+
+            for (size_t i = 0; i < JOURNALRECORDHEADER; ++i)
+                size |= static_cast<size_t>(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+
+            // A record cut by a crash in the middle of an append ends the journal
+            if (pos + JOURNALRECORDHEADER + size > data.size())
+                break;
+
+            const auto changes = deserialize<SaveData>(UnserializedObject::fromBinary(data.substr(pos + JOURNALRECORDHEADER, size), "savedata"));
+
+            for (const auto& change : changes.elements)
+                currentSave.data.elements[change.first] = change.second;
+
+            pos += JOURNALRECORDHEADER + size;
+
+            ++nbJournalRecords;
+        }
+
+        journalOnDisk = true;
+
+        // Drop the torn record so the next appends are not hidden behind it
+        if (pos != data.size())
+        {
+            LOG_ERROR(DOM, "Journal '" << journal.filepath << "' ends with an incomplete record, dropping it");
+
+            UniversalFileAccessor::replaceFile(journal, data.substr(0, pos), true);
+        }
+
+        LOG_INFO(DOM, "Replayed " << nbJournalRecords << " journal records");
     }
 
-    void SaveManager::save()
+    void SaveManager::runWriter()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::unique_lock<std::mutex> lock(writerMutex);
+
+        while (true)
+        {
+            writerCondition.wait(lock, [this]() { return stopRequested or not pendingChanges.empty(); });
+
+            if (pendingChanges.empty())
+                break;
+
+            // Let the changes accumulate until the next write is allowed, unless someone is waiting for them
+            if (not stopRequested and not flushRequested)
+                writerCondition.wait_until(lock, lastWrite + minSaveInterval, [this]() { return stopRequested or flushRequested; });
+
+            const auto changes = std::move(pendingChanges);
+            pendingChanges.clear();
+
+            const auto mode = saveMode;
+            const auto threshold = compactionThreshold;
+
+            writing = true;
+
+            lock.unlock();
+
+            write(changes, mode, threshold);
+
+            lock.lock();
+
+            writing = false;
+
+            lastWrite = std::chrono::steady_clock::now();
+
+            ++nbWrites;
+
+            if (pendingChanges.empty())
+            {
+                flushRequested = false;
+
+                flushedCondition.notify_all();
+            }
+        }
+    }
+
+    void SaveManager::write(const std::unordered_map<std::string, ElementType>& changes, SaveMode mode, size_t compactionThreshold)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        for (const auto& change : changes)
+            writtenData.elements[change.first] = change.second;
+
+        // A journal still on disk gets the changes even when compacting: if the compaction doesn't go through,
+        // replaying it must not bring back older values over the ones of the save file
+        if (mode == SaveMode::Journal or journalOnDisk)
+            appendToJournal(changes);
+
+        if (mode == SaveMode::Journal and nbJournalRecords < compactionThreshold)
+            return;
+
+        writeSnapshot();
+    }
+
+    void SaveManager::writeSnapshot()
     {
         LOG_INFO(DOM, "Saving data to disk");
 
-        std::cout << "Saving data to disk..." << std::endl;
+        Archive archive;
+
+        serialize(archive, writtenData);
 
-        serializer.serializeObject("savedata", currentSave.data);
+        archive.container << std::endl;
 
-        std::cout << "Data saved syncing..." << std::endl;
+        const auto data = Serializer::writeData(ARCHIVEVERSION, {{"savedata", archive.container.str()}});
+
+        if (not UniversalFileAccessor::replaceFile(currentSave.file, data))
+            return;
+
+        if (journalOnDisk and UniversalFileAccessor::removeFile(journal))
+        {
+            journalOnDisk = false;
+            nbJournalRecords = 0;
+        }
 
 // Todo this don't work !
 // #ifdef __EMSCRIPTEN__
@@ -175,4 +405,15 @@ namespace pg
 //         );
 // #endif
     }
+
+    void SaveManager::appendToJournal(const std::unordered_map<std::string, ElementType>& changes)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (UniversalFileAccessor::appendToFile(journal, makeJournalRecord(changes), true))
+        {
+            journalOnDisk = true;
+            ++nbJournalRecords;
+        }
+    }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include "ECS/system.h"
 
@@ -69,10 +73,30 @@ namespace pg
         ElementType element;
     };
 
+    /** How the save manager writes the changes on disk */
+    enum class SaveMode : uint8_t
+    {
+        /** Rewrite the whole save file at each write */
+        Snapshot = 0,
+        /** Append only the changed elements to a journal next to the save file and compact it in the save file from time to time */
+        Journal
+    };
+
+    /**
+     * @brief System holding the save data of the game
+     * 
+     * The changes received during a tick are applied at the sync point and handed over to a background thread which writes them on disk,
+     * so a save never stalls the ecs. The writes are coalesced: all the changes made in less than the minimal save interval end up in one write.
+     * 
+     * The save file is always replaced atomically, a crash leaves the previous save intact.
+     * In journal mode only the changed elements are appended to a journal (the save path followed by ".journal"),
+     * which is replayed on load and compacted back in the save file once it holds enough records.
+     */
     class SaveManager : public System<Listener<SaveElementEvent>, NamedSystem, StoragePolicy>
     {
     public:
         SaveManager(const std::string& savePath);
+        ~SaveManager();
 
         virtual std::string getSystemName() const override { return "Save System"; }
 
@@ -82,17 +106,71 @@ namespace pg
 
         ElementType getValue(const std::string& id) const;
 
+        /** Set the minimal time between two writes, the changes made in between are written together */
+        void setMinSaveInterval(std::chrono::milliseconds interval);
+
+        void setSaveMode(SaveMode mode);
+
+        /** Set the number of records the journal can hold before being compacted in the save file */
+        void setCompactionThreshold(size_t nbRecords);
+
+        /** Block until all the changes applied by execute are written on disk */
+        void flush();
+
+        /** Number of writes done by the background thread since the creation of the manager */
+        size_t getNbWrites() const;
+
     private:
         void loadSave(const std::string& savePath);
 
+        /** Apply the records of the journal left by a previous run on top of the loaded save */
+        void replayJournal();
+
     private:
-        void save();
+        /** Loop of the background writer thread */
+        void runWriter();
+
+        /** Write the changes on disk, only called from the writer thread */
+        void write(const std::unordered_map<std::string, ElementType>& changes, SaveMode mode, size_t compactionThreshold);
+
+        void writeSnapshot();
+        void appendToJournal(const std::unordered_map<std::string, ElementType>& changes);
 
     private:
         SaveFile currentSave;
 
+        TextFile journal;
+
         std::queue<SaveElementEvent> eventQueue;
 
-        Serializer serializer;
+        std::thread writer;
+
+        /** Guard the state shared with the writer thread (everything down to nbWrites) */
+        mutable std::mutex writerMutex;
+        std::condition_variable writerCondition;
+        std::condition_variable flushedCondition;
+
+        /** Changes applied at a sync point but not written yet */
+        std::unordered_map<std::string, ElementType> pendingChanges;
+
+        SaveMode saveMode = SaveMode::Snapshot;
+        std::chrono::milliseconds minSaveInterval {1000};
+        size_t compactionThreshold = 64;
+
+        bool stopRequested = false;
+        bool flushRequested = false;
+        bool writing = false;
+
+        size_t nbWrites = 0;
+
+        // Only accessed by the writer thread once it started
+
+        /** Content of the save as written on disk */
+        SaveData writtenData;
+
+        std::chrono::steady_clock::time_point lastWrite;
+
+        size_t nbJournalRecords = 0;
+        bool journalOnDisk = false;
     };
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+
+#include "sparseset.h"
+#include "Memory/triplebuffer.h"
+
+#include "logger.h"
+
+namespace pg
+{
+    /**
+     * @brief Type erased base of a component snapshot
+     *
+     * Used by the ecs to publish all the snapshots at the end of a tick without knowing their type.
+     */
+    struct AbstractComponentSnapshot
+    {
+        virtual ~AbstractComponentSnapshot() {}
+
+        /** Copy the current state of the components in a new frame and make it available to the reader */
+        virtual void publish(size_t tick) = 0;
+    };
+
+    /**
+     * @brief Immutable copy of all the components of a type, taken at the end of a tick
+     *
+     * The components are stored in the dense order of their set, entityIds[i] being the entity of components[i].
+     */
+    template <typename View>
+    struct SnapshotFrame
+    {
+        /** Number of the tick at which the frame was published */
+        size_t tick = 0;
+
+        /** Version of the set when the frame was last written, see ComponentSet::getVersion */
+        uint64_t version = 0;
+
+        /** Layout version of the set when the frame was last written, see ComponentSet::getLayoutVersion */
+        uint64_t layoutVersion = 0;
+
+        std::vector<_unique_id> entityIds;
+
+        std::vector<View> components;
+
+        /** Position + 1 of the component of each entity in the frame indexed by entityIndex, 0 if the entity has none */
+        std::vector<size_t> positions;
+
+        inline size_t size() const { return components.size(); }
+
+        /** Get the component of an entity in this frame, nullptr if the entity had no component when the frame was published */
+        inline const View* find(_unique_id id) const
+        {
+            const auto index = entityIndex(id);
+
+            if (index >= positions.size() or positions[index] == 0 or entityIds[positions[index] - 1] != id)
+                return nullptr;
+
+            return &components[positions[index] - 1];
+        }
+    };
+
+    /**
+     * @brief Triple buffered view of a component type for another thread (typically the render thread)
+     *
+     * The ecs publishes a copy of the components at the end of each run of the taskflow, once every system task
+     * (including the independent ones) is finished, so the copy is always consistent.
+     * Each buffer only copies again the components whose version changed since it was last written, so a component
+     * modified in place must be flagged with markChanged to reach the snapshot (a full copy only happens when components moved in the set).
+     * The reader acquires the latest frame without locking nor waiting and keeps reading it until it acquires the next one.
+     * Frames are handed over through a triple buffer, so the ecs never waits for the reader either.
+     *
+     * @tparam Comp Type of the component
+     * @tparam View Type stored in the frames, constructed from a const Comp&. Defaults to a copy of the component,
+     * a lighter type can be used for components that can't or shouldn't be copied whole.
+     *
+     * @warning Only one thread may read a snapshot
+     */
+    template <typename Comp, typename View = Comp>
+    class ComponentSnapshot : public AbstractComponentSnapshot
+    {
+    public:
+        ComponentSnapshot(const ComponentSet<Comp> *set) : set(set) { LOG_THIS_MEMBER("Component Snapshot"); }
+
+        virtual void publish(size_t tick) override
+        {
+            auto& frame = frames.back();
+
+            frame.tick = tick;
+
+            const auto version = set->getVersion();
+            const auto layoutVersion = set->getLayoutVersion();
+
+            // Components moved in the set since this buffer was written, the frame can't be patched by index anymore
+            if (layoutVersion > frame.layoutVersion)
+                copyAll(frame);
+            else
+                copyChanged(frame);
+
+            frame.version = version;
+            frame.layoutVersion = layoutVersion;
+
+            frames.publish();
+        }
+
+        /**
+         * @brief Get the latest published frame
+         *
+         * The returned frame stays valid and untouched until the next call to acquire from the same thread.
+         */
+        inline const SnapshotFrame<View>& acquire()
+        {
+            frames.acquire();
+
+            return frames.front();
+        }
+
+        /** Number of frames published since the creation of the snapshot */
+        inline uint64_t getNbPublished() const { return frames.getNbPublished(); }
+
+    private:
+        /** Copy all the components of the set in the frame */
+        void copyAll(SnapshotFrame<View>& frame)
+        {
+            // Only reset the positions of the entities of the frame, so publishing stays linear in the number of components
+            for (const auto& id : frame.entityIds)
+                frame.positions[entityIndex(id)] = 0;
+
+            // Clear instead of reallocating so the vectors keep their capacity from one frame to the other
+            frame.entityIds.clear();
+            frame.components.clear();
+
+            const auto nbComponents = set->nbElements();
+
+            frame.entityIds.reserve(nbComponents);
+            frame.components.reserve(nbComponents);
+
+            for (size_t i = 1; i < nbComponents; i++)
+                append(frame, set->at(i), *(*set)[i]);
+        }
+
+        /**
+         * @brief Only copy the components changed since the frame was last written
+         *
+         * Without any move in the set, the components of the frame are still at the same index and the new ones
+         * are at the end of the set (a new component counts as a change), so the frame is patched in place.
+         */
+        void copyChanged(SnapshotFrame<View>& frame)
+        {
+            for (const auto& changed : set->viewComponents().changedSince(frame.version))
+            {
+                if (changed.index - 1 < frame.components.size())
+                    frame.components[changed.index - 1] = View(*changed.component);
+                else
+                    append(frame, changed.id, *changed.component);
+            }
+        }
+
+        inline void append(SnapshotFrame<View>& frame, _unique_id id, const Comp& component)
+        {
+            const auto index = entityIndex(id);
+
+            if (index >= frame.positions.size())
+                frame.positions.resize(index + 1, 0);
+
+            frame.entityIds.push_back(id);
+            frame.components.emplace_back(component);
+
+            frame.positions[index] = frame.entityIds.size();
+        }
+
+        const ComponentSet<Comp> *set;
+
+        TripleBuffer<SnapshotFrame<View>> frames;
+    };
+}
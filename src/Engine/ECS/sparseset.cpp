@@ -61,7 +61,7 @@ namespace pg
         LOG_THIS_MEMBER(DOM);
 
         // All the entity should always be greater than 0 as 0 is the value of empty in the system
-        if (id < 1)
+        if (entityIndex(id) < 1)
         {
             LOG_ERROR(DOM, "Invalid entity id, must be greater than 0");
             return 0;
@@ -79,15 +79,17 @@ namespace pg
         // Link the entity id with the component id through the dense <-> sparse mechanism
         dense[currentSize] = id;
 
+        const auto index = entityIndex(id);
+
         // Todo implement paging for the sparse array
-        if (sparseCapacity <= id)
+        if (sparseCapacity <= index)
         {
-            LOG_MILE(DOM, "Sparse array is too small (" << sparseCapacity << ") to fit the element: " << id << ", proceed to increase the capacity");
-            addSparseCapacity(id);
+            LOG_MILE(DOM, "Sparse array is too small (" << sparseCapacity << ") to fit the element: " << index << ", proceed to increase the capacity");
+            addSparseCapacity(index);
         }
 
         // Link the entity id with the component id through the dense <-> sparse mechanism
-        sparse[id] = currentSize;
+        sparse[index] = currentSize;
 
         return currentSize;
     }
@@ -102,14 +104,13 @@ namespace pg
     {
         LOG_THIS_MEMBER(DOM);
 
-        // Todo check this and that we need to see before hand that the id is in the list
-        const size_t currentSize = size--;
-
         // Check if the id has a component
-        if (currentSize < 1 && !has(id))
+        if (not has(id))
             return 0;
+
+        const size_t currentSize = size--;
         
-        const auto index = sparse[id];
+        const auto index = sparse[entityIndex(id)];
 
         LOG_MILE(DOM, "Removing component of entity: " << id << " at index " << index << " " << currentSize);
 
@@ -118,10 +119,51 @@ namespace pg
         const auto lastElement = dense[currentSize - 1];
 
         dense[index] = lastElement;
-        sparse[lastElement] = index;
+        sparse[entityIndex(lastElement)] = index;
         return index;
     }
 
+    /**
+     * @brief Grow the set once for a batch of ids to come
+     * 
+     * @param nbNewElements Number of ids that are about to be added
+     * @param maxIndex Biggest entity index of the batch (see entityIndex)
+     * 
+     * This avoids doubling the dense and sparse arrays multiple times while adding a big batch of ids
+     */
+    void SparseSet::reserveBatch(const size_t& nbNewElements, const _unique_id& maxIndex)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        addDenseCapacity(size + nbNewElements);
+
+        addSparseCapacity(maxIndex);
+    }
+
+    /**
+     * @brief Swap the position of two indexes of the set
+     * 
+     * @param lhs The first index to swap
+     * @param rhs The second index to swap
+     * 
+     * Both the dense and the sparse arrays are updated so the reciprocity of the set is kept
+     */
+    void SparseSet::swap(const size_t& lhs, const size_t& rhs)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (lhs == rhs or lhs == 0 or rhs == 0 or lhs >= size or rhs >= size)
+            return;
+
+        const auto lhsId = dense[lhs];
+        const auto rhsId = dense[rhs];
+
+        dense[lhs] = rhsId;
+        dense[rhs] = lhsId;
+
+        sparse[entityIndex(lhsId)] = rhs;
+        sparse[entityIndex(rhsId)] = lhs;
+    }
 
     // /**
     //  * @brief Remove a component by component index
@@ -15,10 +15,13 @@
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <type_traits>
+#include <algorithm>
 
 #include "entity.h"
 
 #include "Memory/memorypool.h"
+#include "Memory/parallelfor.h"
 
 #include "logger.h"
 
@@ -158,8 +161,16 @@ namespace pg
          * 
          * This function uses one of the main properties of the sparse set, the reciprocity of the id in the dense and sparse array
          * This operation is O(1) as it only need 2 indirections and 3 checks to know if an id is in the list and this is true whatever the size of the array
+         * 
+         * The sparse array is indexed by entityIndex(id) while the dense array holds the full id,
+         * so an id from a previous generation of the same index is never found.
          */
-        inline bool has(const _unique_id& id) const { return id < sparseCapacity and sparse[id] < size and dense[sparse[id]] == id; };
+        inline bool has(const _unique_id& id) const
+        {
+            const auto index = entityIndex(id);
+
+            return index < sparseCapacity and sparse[index] < size and dense[sparse[index]] == id;
+        };
 
         /**
          * @brief Get the id at a given index of the set
@@ -186,7 +197,7 @@ namespace pg
         inline size_t find(const _unique_id& id) const
         {
             if (has(id))
-                return sparse[id];
+                return sparse[entityIndex(id)];
 
             return 0;
         }
@@ -197,6 +208,14 @@ namespace pg
         /** Remove an id in the set */
         size_t remove(const _unique_id& id);
 
+        /**
+         * @brief Grow the set once for a batch of ids to come
+         * 
+         * @param nbNewElements Number of ids that are about to be added
+         * @param maxIndex Biggest entity index of the batch (see entityIndex)
+         */
+        void reserveBatch(const size_t& nbNewElements, const _unique_id& maxIndex);
+
         /** Clear the entire list */
         inline virtual void clear()
         {
@@ -222,6 +241,11 @@ namespace pg
             return SparseSetList(nbElements(), dense);
         }
 
+        // Protected interface
+    protected:
+        /** Swap the position of two indexes of the set */
+        void swap(const size_t& lhs, const size_t& rhs);
+
         // Private interface
     private:
         /** Internal helper function used to expend the dense and the component list */
@@ -249,7 +273,19 @@ namespace pg
         size_t sparseCapacity = 2;
     };
 
-    // 
+    /**
+     * @brief Structure tag used to store a component by value inside of its ComponentSet
+     * 
+     * When a component inherits from this tag, the components are stored packed in a single array
+     * parallel to the dense array of the set instead of being allocated one by one in an allocator pool.
+     * This makes the iteration over the component set a straight linear scan.
+     * 
+     * @warning Removal is done with a swap and pop, so the address of a packed component is not stable !
+     * Never keep a raw pointer to a packed component, use a CompRef (which re-lookup the component from its entity id) instead.
+     * A packed component must also be move constructible.
+     */
+    struct PackedStorage {};
+
     /**
      * @brief A container object used to store components
      * 
@@ -263,19 +299,98 @@ namespace pg
      * - O(n) time complexity for clear (as it delete all the components in memory)
      * - O(n) time complexity for iteration over components
      * 
-     * It also stores in memory the list of components of a given type
+     * It also stores in memory the list of components of a given type.
+     * By default each component is allocated in an allocator pool and the set only holds pointers to them,
+     * if the component inherits from PackedStorage the components are stored by value in the set instead.
      * 
      * @warning Never delete a ComponentSet through a SparseSet pointer
-     * 
-     * @todo Make a sparse set implementation that doesn't delete components on remove but instead reuse dead memory
      */
     template <typename Comp>
     class ComponentSet : public SparseSet
     {
+    public:
+        /** True if the components are stored by value in a packed array, false if they are allocated in a pool */
+        static constexpr bool packed = std::is_base_of_v<PackedStorage, Comp>;
+
     private:
         typedef typename std::aligned_storage<sizeof(Comp), alignof(Comp)>::type CompStorage;
 
+        /** Underlaying type of the component list: a packed array of components or an array of pointers to pool allocated components */
+        typedef typename std::conditional<packed, CompStorage*, Comp**>::type ComponentList;
+
+        /** Internal helper function used to get a component from the component list whatever the storage mode */
+        static inline Comp* fetch(ComponentList list, size_t index)
+        {
+            if constexpr (packed)
+                return reinterpret_cast<Comp*>(&list[index]);
+            else
+                return list[index];
+        }
+
     public:
+        /** A changed component and the id of its entity, as returned by changedSince */
+        struct ChangedComponent
+        {
+            _unique_id id;
+            Comp* component;
+
+            /** Position of the component in the set (starting at 1) */
+            size_t index;
+        };
+
+        /**
+         * @brief Range over the components changed since a given version
+         * 
+         * Iterating the range scans the versions of the set, which are stored contiguously, and only stops on the changed components.
+         * 
+         * @warning Any operation on this list is invalid if the component set is updated
+         */
+        class ChangedList
+        {
+        friend class ComponentSet;
+        public:
+            class Iterator
+            {
+            friend class ChangedList;
+            public:
+                inline Iterator& operator++() { index++; skipUnchanged(); return *this; }
+
+                inline bool operator==(const Iterator& rhs) const { return index == rhs.index; }
+
+                inline bool operator!=(const Iterator& rhs) const { return index != rhs.index; }
+
+                inline ChangedComponent operator*() const { return ChangedComponent{list->set->at(index), fetch(list->componentList, index), index}; }
+
+            private:
+                Iterator(const ChangedList* list, size_t index) : list(list), index(index) { skipUnchanged(); }
+
+                inline void skipUnchanged()
+                {
+                    while (index < list->size and list->set->versions[index] <= list->version)
+                        index++;
+                }
+
+                const ChangedList* list;
+
+                size_t index;
+            };
+
+            inline Iterator begin() const { return Iterator(this, 1); }
+
+            inline Iterator end() const { return Iterator(this, size); }
+
+        private:
+            ChangedList(const ComponentSet* set, ComponentList componentList, uint64_t version, size_t size) : set(set), componentList(componentList), version(version), size(size) { }
+
+            const ComponentSet* set;
+
+            ComponentList componentList;
+
+            uint64_t version;
+
+            size_t size;
+        };
+
         /**
          * @brief List representation of the component of the component set
          * 
@@ -337,28 +452,28 @@ namespace pg
                  * 
                  * @return Comp* A pointer to the component stored recasted into the actual component
                  */
-                inline Comp* operator*() { return componentList[index]; }
+                inline Comp* operator*() { return fetch(componentList, index); }
 
                 /**
                  * @brief Overload of the * operator
                  * 
                  * @return Comp* A pointer to the component stored recasted into the actual component
                  */
-                inline const Comp* operator*() const { return componentList[index]; }
+                inline const Comp* operator*() const { return fetch(componentList, index); }
 
                 /**
                  * @brief Overload of the * operator
                  * 
                  * @return Comp* A pointer to the component stored recasted into the actual component
                  */
-                inline Comp* operator[](size_t i) { return componentList[i];}
+                inline Comp* operator[](size_t i) { return fetch(componentList, i); }
 
                 /**
                  * @brief Overload of the * operator
                  * 
                  * @return Comp* A pointer to the component stored recasted into the actual component
                  */
-                inline const Comp* operator[](size_t i) const { return componentList[i];}
+                inline const Comp* operator[](size_t i) const { return fetch(componentList, i); }
 
                 // Protected constructor
             protected:
@@ -370,14 +485,14 @@ namespace pg
                  * 
                  * This object can only be created from a ComponentSet List inside of a ComponentSet Object
                  */
-                Iterator(const size_t& pos, Comp **componentList) : index(pos), componentList(componentList) { LOG_THIS_MEMBER("Component Set List Iterator"); }
+                Iterator(const size_t& pos, ComponentList componentList) : index(pos), componentList(componentList) { LOG_THIS_MEMBER("Component Set List Iterator"); }
 
                 // Private variables
             private:
                 /** Index of the current position in the componentList */
                 size_t index = 1;
-                /** An array of component pointers */
-                Comp **componentList;
+                /** The component list to iterate over */
+                ComponentList componentList;
             };
 
             // Public interface
@@ -391,8 +506,10 @@ namespace pg
              * This helper operator is used to provide access to a component inside of the component list.
              * Be careful as the operator doesn't not check the bound of the list, this can throw an out of bound exception
              * Use with nbElement of the sparse set to be in bound
+             * 
+             * @warning For packed components the index 0 doesn't hold a valid component
              */
-            Comp* operator[](const size_t& index) const { return componentList[index]; }
+            Comp* operator[](const size_t& index) const { return fetch(componentList, index); }
 
             /**
              * @brief Get the head iterator
@@ -415,7 +532,25 @@ namespace pg
              * 
              * @param other The Sparse Set List to copy
              */
-            ComponentSetList(const ComponentSetList& other) : head(other.head), tail(other.head), componentList(other.componentList) { LOG_THIS_MEMBER("Component Set List"); }
+            ComponentSetList(const ComponentSetList& other) : head(other.head), tail(other.tail), componentList(other.componentList), executor(other.executor), set(other.set) { LOG_THIS_MEMBER("Component Set List"); }
+
+            /**
+             * @brief Make this list view the same components as another one
+             * 
+             * @param other The Sparse Set List to copy
+             */
+            ComponentSetList& operator=(const ComponentSetList& other)
+            {
+                LOG_THIS_MEMBER("Component Set List");
+
+                head = other.head;
+                tail = other.tail;
+                componentList = other.componentList;
+                executor = other.executor;
+                set = other.set;
+
+                return *this;
+            }
 
             /**
              * @brief Get the number of components in the list
@@ -424,6 +559,72 @@ namespace pg
              */
             size_t nbComponents() const { LOG_THIS_MEMBER("Component Set List"); return tail.index; }
 
+            /** Get the version of the last change of the set, see ComponentSet::getVersion */
+            inline uint64_t getVersion() const { return set->getVersion(); }
+
+            /** Get the version of the last move of components in the set, see ComponentSet::getLayoutVersion */
+            inline uint64_t getLayoutVersion() const { return set->getLayoutVersion(); }
+
+            /**
+             * @brief Get the components changed after a given version of the set
+             * 
+             * @param version A version previously returned by getVersion
+             * @return ChangedList A range of the changed components and their entity ids
+             * 
+             * Typical use is to read the version before iterating, then keep it for the next iteration:
+             * @code
+             * auto list = view<UiComponent>();
+             * const auto version = list.getVersion();
+             * for (const auto& changed : list.changedSince(lastVersion)) { ... changed.id ... changed.component ... }
+             * lastVersion = version;
+             * @endcode
+             */
+            inline ChangedList changedSince(uint64_t version) const
+            {
+                LOG_THIS_MEMBER("Component Set List");
+
+                return ChangedList(set, componentList, version, tail.index);
+            }
+
+            /**
+             * @brief Call a function on every component of the list, in parallel on the workers of the ECS executor
+             * 
+             * @tparam Func Type of the function to call, it must be callable as func(Comp*)
+             * @param func The function to call on each component
+             * @param grain Minimum number of components processed by a chunk
+             * 
+             * The dense range is split in chunks of at least grain components, rounded so that each chunk boundary
+             * falls on a cache line of the component array. The chunks are scheduled on the existing executor
+             * so no thread is created. Falls back to a plain loop when the set is not bound to an ECS.
+             * 
+             * @warning func is called concurrently, it must only touch the component it receives
+             */
+            template <typename Func>
+            void parallelForEach(const Func& func, size_t grain = 256) const
+            {
+                LOG_THIS_MEMBER("Component Set List");
+
+                auto chunk = [this, &func](size_t start, size_t end)
+                {
+                    for (size_t i = start; i < end; i++)
+                        func(fetch(componentList, i));
+                };
+
+                if (not executor)
+                {
+                    chunk(1, tail.index);
+                    return;
+                }
+
+                constexpr size_t elementSize = sizeof(std::remove_pointer_t<ComponentList>);
+                constexpr size_t lineElements = elementsPerCacheLine(elementSize);
+
+                grain = (std::max(grain, lineElements) + lineElements - 1) / lineElements * lineElements;
+
+                // The chunks are cut from the actual address of the array, it is not aligned on a cache line
+                parallelFor(*executor, 1, tail.index, grain, chunk, firstCacheLineIndex(componentList, elementSize));
+            }
+
             // Protected constructor
         protected:
             /**
@@ -434,7 +635,7 @@ namespace pg
              * 
              * This object can only be created from a SparseSet Object
              */
-            ComponentSetList(const size_t& size, Comp **componentList) : head(1, componentList), tail(size, componentList), componentList(componentList) { LOG_THIS_MEMBER("Component Set List"); }
+            ComponentSetList(const size_t& size, ComponentList componentList, tf::Executor* executor, const ComponentSet* set) : head(1, componentList), tail(size, componentList), componentList(componentList), executor(executor), set(set) { LOG_THIS_MEMBER("Component Set List"); }
 
             // Private variables
         private:
@@ -444,7 +645,13 @@ namespace pg
             Iterator tail;
 
             /** The component list to iterate over */
-            Comp **componentList;      
+            ComponentList componentList;      
+
+            /** Executor used by parallelForEach */
+            tf::Executor* executor = nullptr;
+
+            /** Set viewed by this list, used to read the versions of the components */
+            const ComponentSet* set = nullptr;
         };
 
     public:
@@ -454,10 +661,21 @@ namespace pg
 
             LOG_INFO("Component Set", "Creating component set for: " << typeid(Comp).name());
 
-            componentList = new Comp*[componentCapacity];
+            // The sentinel slot never changes
+            versions.push_back(0);
+
+            if constexpr (packed)
+            {
+                // The first slot is never constructed as it shouldn't be a valid component ever
+                componentList = new CompStorage[componentCapacity];
+            }
+            else
+            {
+                componentList = new Comp*[componentCapacity];
 
-            // Set the first element as nullptr as it shouldn't be a valid component ever
-            componentList[0] = nullptr;
+                // Set the first element as nullptr as it shouldn't be a valid component ever
+                componentList[0] = nullptr;
+            }
         };
 
         virtual ~ComponentSet()
@@ -466,8 +684,8 @@ namespace pg
 
             LOG_INFO("Component Set", "Removing component set for: " << typeid(Comp).name());
 
-            for(size_t i = 1; i < nbComponents; i++)
-                pool.release(componentList[i]);
+            for (size_t i = 1; i < nbComponents; i++)
+                destroyComponent(fetch(componentList, i));
 
             delete[] componentList;
         }
@@ -482,7 +700,7 @@ namespace pg
          * Be careful as the operator doesn't not check the bound of the list, this can throw an out of bound exception
          * Use with nbElement of the sparse set to be in bound
          */
-        Comp* operator[](const size_t& index) const { return componentList[index]; }
+        Comp* operator[](const size_t& index) const { return fetch(componentList, index); }
 
         /**
          * @brief Get a component from the entity id
@@ -490,12 +708,14 @@ namespace pg
          * @param id Id of the entity
          * @return Comp* A pointer to the associated component
          */
-        inline Comp* atEntity(_unique_id id) const { auto pos = find(id); return pos != 0 ? componentList[pos] : nullptr; }
+        inline Comp* atEntity(_unique_id id) const { auto pos = find(id); return pos != 0 ? fetch(componentList, pos) : nullptr; }
 
         /**
          * @brief Reserve enough space in the set to hold the requested number of objects
          * 
          * @param size The needed size of the set
+         * 
+         * @warning For packed components this moves all the components, invalidating any pointer to them
          */
         void reserve(const size_t& size)
         {
@@ -512,14 +732,54 @@ namespace pg
                 targetCapacity *= 2;
             }
 
-            Comp** tempComponentList = new Comp*[targetCapacity];
+            if constexpr (packed)
+            {
+                CompStorage* tempComponentList = new CompStorage[targetCapacity];
 
-            memcpy(tempComponentList, componentList, componentCapacity * sizeof(Comp*));
-            delete[] componentList;
-            componentList = tempComponentList;
-            componentCapacity = targetCapacity;
-            
-            pool.reserve(size);
+                for (size_t i = 1; i < nbComponents; i++)
+                {
+                    auto component = fetch(componentList, i);
+
+                    ::new(&tempComponentList[i]) Comp(std::move(*component));
+
+                    component->~Comp();
+                }
+
+                delete[] componentList;
+                componentList = tempComponentList;
+                componentCapacity = targetCapacity;
+            }
+            else
+            {
+                Comp** tempComponentList = new Comp*[targetCapacity];
+
+                memcpy(tempComponentList, componentList, componentCapacity * sizeof(Comp*));
+                delete[] componentList;
+                componentList = tempComponentList;
+                componentCapacity = targetCapacity;
+                
+                pool.reserve(size);
+            }
+        }
+
+        /**
+         * @brief Grow the set, the component list and the pool once for a batch of components to come
+         * 
+         * @param nbNewComponents Number of components that are about to be added
+         * @param maxIndex Biggest entity index of the batch (see entityIndex)
+         * 
+         * @warning For packed components this moves all the components, invalidating any pointer to them
+         */
+        void reserveBatch(const size_t& nbNewComponents, const _unique_id& maxIndex)
+        {
+            LOG_THIS_MEMBER("Component Set");
+
+            SparseSet::reserveBatch(nbNewComponents, maxIndex);
+
+            reserve(nbComponents + nbNewComponents);
+
+            if constexpr (not packed)
+                pool.reserve(pool.getNbElements() + nbNewComponents);
         }
 
         template <typename... Args>
@@ -533,13 +793,29 @@ namespace pg
 
                 const auto index = find(id);
 
-                pool.release(componentList[index]);
+                versions[index] = nextVersion();
 
-                auto component = pool.allocate(std::forward<Args>(args)...);
+                if constexpr (packed)
+                {
+                    // Build the new component first as the arguments could reference the component being replaced
+                    Comp temp(std::forward<Args>(args)...);
 
-                componentList[index] = component;
+                    auto component = fetch(componentList, index);
 
-                return component;
+                    component->~Comp();
+
+                    return ::new(component) Comp(std::move(temp));
+                }
+                else
+                {
+                    pool.release(componentList[index]);
+
+                    auto component = pool.allocate(std::forward<Args>(args)...);
+
+                    componentList[index] = component;
+
+                    return component;
+                }
             }
 
             const auto index = add(id);
@@ -558,13 +834,22 @@ namespace pg
             }
 
             lastEntityIndex = index;
-            
-            // Todo: Test if allocating memory in a pool is faster than direct memory allocation with new
-            auto component = pool.allocate(std::forward<Args>(args)...);
 
-            componentList[nbComponents++] = component;
+            // A new component counts as a change
+            versions.push_back(nextVersion());
+
+            if constexpr (packed)
+            {
+                return ::new(&componentList[nbComponents++]) Comp(std::forward<Args>(args)...);
+            }
+            else
+            {
+                auto component = pool.allocate(std::forward<Args>(args)...);
+
+                componentList[nbComponents++] = component;
 
-            return component;
+                return component;
+            }
         }
         
         template <typename... Args>
@@ -587,16 +872,43 @@ namespace pg
                 return;
             }
 
-            pool.release(componentList[index]);
+            const auto last = --nbComponents;
+
+            // The version follows the last component moved in the place of the removed one
+            versions[index] = versions[last];
+            versions.pop_back();
 
-            // Swap the last component in the place of the component to be removed
-            componentList[index] = componentList[--nbComponents];
+            // The slot of the removed component now holds another one
+            layoutVersion = nextVersion();
+
+            if constexpr (packed)
+            {
+                auto component = fetch(componentList, index);
+
+                component->~Comp();
+
+                // Move the last component in the place of the component removed to keep the array packed
+                if (index != last)
+                {
+                    auto lastComponent = fetch(componentList, last);
+
+                    ::new(component) Comp(std::move(*lastComponent));
+
+                    lastComponent->~Comp();
+                }
+            }
+            else
+            {
+                pool.release(componentList[index]);
+
+                // Swap the last component in the place of the component to be removed
+                componentList[index] = componentList[last];
+            }
 
             if (nbComponents <= 1)
                 nbComponents = 1; 
         }
 
-        // TODO make a sparse set implementation that doesn't delete components on remove but instead reuse dead memory
         inline void removeComponent(const Entity* entity)
         {
             LOG_THIS_MEMBER("Component Set");
@@ -604,6 +916,49 @@ namespace pg
             removeComponent(entity->id);
         }
 
+        /**
+         * @brief Swap the position of two components in the set
+         * 
+         * @param lhs Index of the first component
+         * @param rhs Index of the second component
+         * 
+         * Both the dense array and the component list are swapped so the set stays coherent.
+         * This is used by owning groups to keep their members packed at the start of the set.
+         * 
+         * @warning For packed components this moves both components, invalidating any pointer to them
+         */
+        void swapComponents(const size_t& lhs, const size_t& rhs)
+        {
+            LOG_THIS_MEMBER("Component Set");
+
+            if (lhs == rhs or lhs == 0 or rhs == 0 or lhs >= nbComponents or rhs >= nbComponents)
+                return;
+
+            swap(lhs, rhs);
+
+            std::swap(versions[lhs], versions[rhs]);
+
+            layoutVersion = nextVersion();
+
+            if constexpr (packed)
+            {
+                auto lhsComponent = fetch(componentList, lhs);
+                auto rhsComponent = fetch(componentList, rhs);
+
+                Comp temp(std::move(*lhsComponent));
+
+                lhsComponent->~Comp();
+                ::new(lhsComponent) Comp(std::move(*rhsComponent));
+
+                rhsComponent->~Comp();
+                ::new(rhsComponent) Comp(std::move(temp));
+            }
+            else
+            {
+                std::swap(componentList[lhs], componentList[rhs]);
+            }
+        }
+
         /**
          * @brief Expose a view of the component list to a system
          * 
@@ -616,25 +971,93 @@ namespace pg
         {
             LOG_THIS_MEMBER("Component Set");
 
-            return ComponentSetList(nbComponents, componentList);
+            return ComponentSetList(nbComponents, componentList, executor, this);
         }
 
+        /**
+         * @brief Flag the component of an entity as changed
+         * 
+         * Components are modified in place through their pointers so the set can't see the changes by itself,
+         * whoever modifies a component that is tracked by a reactive system needs to call this function.
+         * Adding a component also marks it as changed, removals are not tracked (listen to the groups or events for those).
+         * 
+         * @param id Id of the entity whose component changed
+         */
+        inline void markChanged(_unique_id id)
+        {
+            if (const auto index = find(id); index != 0)
+                versions[index] = nextVersion();
+        }
+
+        /** Get the version of the last change of the set, every change gets a greater version than the previous ones */
+        inline uint64_t getVersion() const { return version.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Get the version of the last time components moved to another index (removal or swap)
+         *
+         * A moved component keeps its own version, so anything mirroring the set by index must
+         * compare this against its last sync and re-read the whole set when it is greater.
+         */
+        inline uint64_t getLayoutVersion() const { return layoutVersion; }
+
+        /** Get the version of the last change of the component of an entity, 0 if the entity doesn't have this component */
+        inline uint64_t getVersion(_unique_id id) const
+        {
+            const auto index = find(id);
+
+            return index != 0 ? versions[index] : 0;
+        }
+
+        /**
+         * @brief Set the executor used to run the parallel loops over this set
+         * 
+         * @param executor Executor of the ECS owning this set
+         */
+        inline void setExecutor(tf::Executor* executor) { this->executor = executor; }
+
+        /** Get the executor used to run the parallel loops over this set (can be null) */
+        inline tf::Executor* getExecutor() const { return executor; }
+
         // Todo reimplement clear to correctly free components
 
     private:
+        /** Get a new version for a change, changes can be marked from concurrent systems so the counter is atomic */
+        inline uint64_t nextVersion() { return version.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+        /** Internal helper function used to destroy a component whatever the storage mode */
+        inline void destroyComponent(Comp* component)
+        {
+            if constexpr (packed)
+                component->~Comp();
+            else
+                pool.release(component);
+        }
+
         /** The component list holding the data of all the component of this sparse set */
-        Comp** componentList;
+        ComponentList componentList;
 
-        /** The allocator pool that store all the component memory in a packed manner */
+        /** The allocator pool that store all the component memory in a packed manner (unused for packed components) */
         AllocatorPool<Comp> pool;
 
         /** Number of component actually allocated */
         size_t nbComponents = 1;
 
+        /** Version of the last change of each component, in the same order as the component list */
+        std::vector<uint64_t> versions;
+
+        /** Version of the last change of the whole set */
+        std::atomic<uint64_t> version {0};
+
+        /** Version of the last move of components in the set, components only move at the sync point */
+        uint64_t layoutVersion = 0;
+
         /** Current capacity of component in the set */
         size_t componentCapacity = 2;
 
         size_t lastEntityIndex = 0;
+
+        /** Executor used by the parallel loops over this set, null if the set is not bound to an ECS */
+        tf::Executor* executor = nullptr;
     };
 
     /**
@@ -2,4 +2,72 @@
 
 namespace pg
 {
-}
\ No newline at end of file
+    void AbstractSystem::setFixedRate(double rate)
+    {
+        if (rate <= 0)
+        {
+            LOG_ERROR("System", "Can't schedule system [" << _id << "] at a rate of " << rate << " Hz, it keeps its current schedule");
+            return;
+        }
+
+        schedulePolicy = SchedulePolicy::FixedRate;
+        schedulePeriod = static_cast<int64_t>(1000000000.0 / rate);
+        scheduledTime = 0;
+    }
+
+    bool AbstractSystem::consumeTurn(int64_t now)
+    {
+        switch (schedulePolicy)
+        {
+            case SchedulePolicy::FixedRate:
+            {
+                if (now < scheduledTime)
+                    return false;
+
+                scheduledTime += schedulePeriod;
+
+                // Drop the runs missed while the ecs was busy instead of running the system in a burst
+                if (scheduledTime <= now)
+                    scheduledTime = now + schedulePeriod;
+
+                return true;
+            }
+
+            case SchedulePolicy::OnEvent:
+            {
+                bool pending = false;
+
+                for (auto& listened : listenedChannels)
+                {
+                    const auto nbDispatched = listened.first->getNbDispatched();
+
+                    if (nbDispatched != listened.second)
+                    {
+                        listened.second = nbDispatched;
+                        pending = true;
+                    }
+                }
+
+                return pending;
+            }
+
+            default:
+                return true;
+        }
+    }
+
+    int64_t AbstractSystem::nextRunTime() const
+    {
+        switch (schedulePolicy)
+        {
+            case SchedulePolicy::FixedRate:
+                return scheduledTime;
+
+            case SchedulePolicy::OnEvent:
+                return INT64_MAX;
+
+            default:
+                return 0;
+        }
+    }
+}
@@ -2,6 +2,9 @@
 
 #include <string>
 #include <unordered_map>
+#include <set>
+#include <vector>
+#include <cstdint>
 
 #include <taskflow.hpp>
 
@@ -44,6 +47,30 @@ namespace pg
         virtual std::string getSystemName() const = 0;
     };
 
+    /**
+     * @brief How often the ecs loop runs the task of a system
+     */
+    enum class SchedulePolicy : uint8_t
+    {
+        EveryTick = 0,
+        FixedRate = 1,
+        OnEvent   = 2
+    };
+
+    /**
+     * @brief Run the system at a fixed rate (in Hz) instead of every tick
+     * 
+     * The system runs at most once per tick, runs missed while the ecs was busy are dropped instead of being caught up.
+     */
+    template <size_t Hz>
+    struct FixedRate
+    {
+        static_assert(Hz > 0, "A fixed rate system needs a rate greater than 0");
+    };
+
+    /** Only run the system when one of its listeners received an event since its last run */
+    struct OnEventPolicy { };
+
     /**
      * @brief Abstract representation of a system
      */
@@ -56,8 +83,59 @@ namespace pg
         // Todo
         inline void setPolicy(const ExecutionPolicy& policy) { executionPolicy = policy; }
 
+        /** Run the system every tick (the default) */
+        inline void setEveryTick() { schedulePolicy = SchedulePolicy::EveryTick; }
+
+        /** Run the system at most rate times per second, see FixedRate */
+        void setFixedRate(double rate);
+
+        /** Only run the system when one of its listeners received an event since its last run, see OnEventPolicy */
+        inline void setOnEvent() { schedulePolicy = SchedulePolicy::OnEvent; }
+
+        /**
+         * @brief Check if the task of the system should run during this tick and consume its turn if so
+         * 
+         * Called by the task of the system only, so it doesn't need any synchronization.
+         * Systems with a parallel policy are always run as their task is a composed taskflow.
+         * 
+         * @param now Current time in ns (on the ecs profiler clock)
+         * @return true If the system is due
+         */
+        bool consumeTurn(int64_t now);
+
+        /**
+         * @brief Time at which the system will be due next
+         * 
+         * @return int64_t The time of the next run of a fixed rate system, 0 for a system running every tick
+         * and INT64_MAX for a system waiting on events
+         */
+        int64_t nextRunTime() const;
+
         inline EntitySystem* world() const noexcept { return ecsRef; }
 
+        /**
+         * @brief Check if this system and another one cannot run at the same time
+         * 
+         * @param other The system to check against
+         * @return true If one of the systems writes a component that the other one reads or writes
+         */
+        bool conflictsWith(const AbstractSystem* other) const
+        {
+            for (const auto& id : writeComponents)
+            {
+                if (other->writeComponents.count(id) > 0 or other->readComponents.count(id) > 0)
+                    return true;
+            }
+
+            for (const auto& id : readComponents)
+            {
+                if (other->writeComponents.count(id) > 0)
+                    return true;
+            }
+
+            return false;
+        }
+
         ExecutionPolicy executionPolicy = ExecutionPolicy::Sequential;
 
         EntitySystem* ecsRef = nullptr;
@@ -68,6 +146,23 @@ namespace pg
 
         std::string name = "UnNamed";
 
+        /** Ids of the components that this system only reads (ReadRef) */
+        std::set<_unique_id> readComponents;
+
+        /** Ids of the components that this system can modify (Own and Ref) */
+        std::set<_unique_id> writeComponents;
+
+        SchedulePolicy schedulePolicy = SchedulePolicy::EveryTick;
+
+        /** Time between two runs of a fixed rate system, in ns */
+        int64_t schedulePeriod = 0;
+
+        /** Earliest time of the next run of a fixed rate system, in ns */
+        int64_t scheduledTime = 0;
+
+        /** Event channels the listeners of this system are registered to, with their number of dispatched events at the last run */
+        std::vector<std::pair<const AbstractEventChannel*, uint64_t>> listenedChannels;
+
         // Todo make function onAdd and onDelete of a component that default to nothing if not used
     };
 
@@ -85,6 +180,7 @@ namespace pg
         LOG_INFO("System", "Registering an own to '" << typeid(Comp).name() << "' to the system.");
 
         static_cast<Own<Comp>*>(system)->setRegistry(registry);
+        system->writeComponents.insert(registry->getTypeId<Comp>());
         registerComponents(system, registry, comps...);
     }
 
@@ -96,6 +192,19 @@ namespace pg
         LOG_INFO("System", "Registering a ref to '" << typeid(Comp).name() << "' to the system.");
         
         static_cast<Ref<Comp>*>(system)->setRegistry(registry);
+        system->writeComponents.insert(registry->getTypeId<Comp>());
+        registerComponents(system, registry, comps...);
+    }
+
+    template <typename Comp, typename... Comps, typename Sys>
+    void registerComponents(Sys *system, ComponentRegistry *registry, const tag<ReadRef<Comp>>&, const Comps&... comps)
+    {
+        LOG_THIS("System");
+        
+        LOG_INFO("System", "Registering a read only ref to '" << typeid(Comp).name() << "' to the system.");
+        
+        static_cast<ReadRef<Comp>*>(system)->setRegistry(registry);
+        system->readComponents.insert(registry->getTypeId<Comp>());
         registerComponents(system, registry, comps...);
     }
 
@@ -107,6 +216,30 @@ namespace pg
         LOG_INFO("System", "Registering a listener to event '" << typeid(Event).name() << "' to the system.");
         
         static_cast<Listener<Event>*>(system)->setRegistry(registry);
+
+        if constexpr (not std::is_same_v<Event, StandardEvent>)
+        {
+            const auto channel = registry->getEventChannelOf<Event>();
+
+            system->listenedChannels.emplace_back(channel, channel->getNbDispatched());
+        }
+
+        registerComponents(system, registry, comps...);
+    }
+
+    template <typename Event, typename... Comps, typename Sys>
+    void registerComponents(Sys *system, ComponentRegistry *registry, const tag<BatchListener<Event>>&, const Comps&... comps)
+    {
+        LOG_THIS("System");
+        
+        LOG_INFO("System", "Registering a batch listener to event '" << typeid(Event).name() << "' to the system.");
+        
+        static_cast<BatchListener<Event>*>(system)->setRegistry(registry);
+
+        const auto channel = registry->getEventChannelOf<Event>();
+
+        system->listenedChannels.emplace_back(channel, channel->getNbDispatched());
+
         registerComponents(system, registry, comps...);
     }
 
@@ -178,6 +311,30 @@ namespace pg
         registerComponents(system, registry, comps...);
     }
 
+    template <size_t Hz, typename... Comps, typename Sys>
+    void registerComponents(Sys *system, ComponentRegistry *registry, const tag<FixedRate<Hz>>&, const Comps&... comps)
+    {
+        LOG_THIS("System");
+        
+        LOG_INFO("System", "Scheduling the system at " << Hz << " Hz");
+
+        system->setFixedRate(Hz);
+        
+        registerComponents(system, registry, comps...);
+    }
+
+    template <typename... Comps, typename Sys>
+    void registerComponents(Sys *system, ComponentRegistry *registry, const tag<OnEventPolicy>&, const Comps&... comps)
+    {
+        LOG_THIS("System");
+        
+        LOG_INFO("System", "Scheduling the system on its events");
+
+        system->setOnEvent();
+        
+        registerComponents(system, registry, comps...);
+    }
+
     template <typename... Comps, typename Sys>
     void registerComponents(Sys *system, ComponentRegistry *registry, const tag<NamedSystem>&, const Comps&... comps)
     {
@@ -229,6 +386,17 @@ namespace pg
         unregisterComponents(system, registry, comps...);
     }
 
+    template <typename Event, typename... Comps, typename Sys>
+    void unregisterComponents(Sys *system, ComponentRegistry *registry, const tag<BatchListener<Event>>&, const Comps&... comps)
+    {
+        LOG_THIS("System");
+        
+        LOG_INFO("System", "Unregistering a batch listener to event '" << typeid(Event).name() << "' to the system.");
+        
+        static_cast<BatchListener<Event>*>(system)->unsetRegistry(registry);
+        unregisterComponents(system, registry, comps...);
+    }
+
     template <typename Comp, typename... Comps, typename Sys>
     void unregisterComponents(Sys *system, ComponentRegistry *registry, const tag<Comp>&, const Comps&... comps)
     {
@@ -374,7 +542,10 @@ namespace pg
         {
             LOG_THIS_MEMBER("System");
 
-            return this->Ref<Type>::view();
+            if constexpr (std::is_base_of_v<ReadRef<Type>, System>)
+                return this->ReadRef<Type>::view();
+            else
+                return this->Ref<Type>::view();
         }
 
         template <typename Type, typename... Types>
@@ -405,6 +576,46 @@ namespace pg
             }
         }
 
+        /**
+         * @brief Get or create a full owning group
+         * 
+         * @tparam Type First component of the group
+         * @tparam Types Other components of the group
+         * @return OwningGroup<Type, Types...>* The group, or nullptr if one of its component set is already owned by another group
+         * 
+         * An owning group keeps all its component sets sorted so its members are packed at the start of each set
+         */
+        template <typename Type, typename... Types>
+        OwningGroup<Type, Types...>* registerOwningGroup() const
+        {
+            LOG_THIS_MEMBER("System");
+
+            if (registry == nullptr)
+            {
+                LOG_ERROR("System", "No registry specified, can't create an owning group");
+                return nullptr;
+            }
+
+            const auto& groupId = registry->getTypeId<OwningGroup<Type, Types...>>();
+
+            if (registry->hasGroup(groupId))
+                return registry->retrieveOwningGroup<Type, Types...>();
+
+            LOG_INFO("System", "Creating new owning group");
+
+            auto group = new OwningGroup<Type, Types...>(groupId);
+
+            if (not group->setRegistry(registry))
+            {
+                delete group;
+                return nullptr;
+            }
+
+            group->process();
+
+            return group;
+        }
+
         template <typename Type, typename... Types>
         inline typename ComponentSet<GroupElement<Type, Types...>>::ComponentSetList viewGroup() const
         {
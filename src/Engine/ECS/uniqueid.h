@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <mutex>
+#include <vector>
 
 namespace pg
 {
@@ -18,10 +19,26 @@ namespace pg
     /** A fast 32bits unsigned value */
     typedef uint_fast32_t _uint32;
 
+    /** Number of low bits of an entity id holding the index of the entity, the high bits hold its generation */
+    constexpr _unique_id ENTITYINDEXBITS = 32;
+
+    /** Mask extracting the index part of an entity id */
+    constexpr _unique_id ENTITYINDEXMASK = (static_cast<_unique_id>(1) << ENTITYINDEXBITS) - 1;
+
+    /** Get the index part of an entity id, this is the slot used by the sparse arrays */
+    constexpr _unique_id entityIndex(_unique_id id) noexcept { return id & ENTITYINDEXMASK; }
+
+    /** Get the generation part of an entity id */
+    constexpr _unique_id entityGeneration(_unique_id id) noexcept { return id >> ENTITYINDEXBITS; }
+
+    /** Build an entity id from an index and a generation */
+    constexpr _unique_id makeEntityId(_unique_id index, _unique_id generation) noexcept { return (generation << ENTITYINDEXBITS) | index; }
+
     /**
      * @brief Generator of unique identifiers
      * 
      * This class generates unique identifier in a non-thread and thread safe manner.
+     * It is used for the type ids (components, systems, events, groups), entities have their own EntityIdGenerator.
      * 
      * The first valid id is 3 as 0 is reserved for NONE, 1 is reserved for Ecs ID and 2 is reserved for Ecs Name,
      * which are the basic id of the ecs. 
@@ -95,4 +112,130 @@ namespace pg
         /** Mutex for concurrent access */
         std::mutex m;
     };
+
+    /**
+     * @brief Generator of versioned entity ids
+     * 
+     * An entity id is made of an index (low bits) and a generation (high bits), see makeEntityId.
+     * When an entity is deleted its index is put in a free list and handed out again with the next generation,
+     * so the sparse arrays indexed by entityIndex() stay as big as the peak number of living entities
+     * and any id kept from a deleted entity doesn't match the new entity using the same index.
+     * 
+     * The first index is 1 as 0 is reserved for NONE. All the functions are thread safe.
+     */
+    class EntityIdGenerator
+    {
+    public:
+        /**
+         * @brief Generate a new entity id, reusing a free index if there is one
+         * 
+         * @return _unique_id A versioned entity id
+         */
+        _unique_id generateId() noexcept
+        {
+            std::lock_guard lock(m);
+
+            return nextId();
+        }
+
+        /**
+         * @brief Generate multiple entity ids at once
+         * 
+         * @param size Number of ids to generate
+         * @return std::vector<_unique_id> The generated ids, free indexes are used first
+         */
+        std::vector<_unique_id> generateIdList(_unique_id size)
+        {
+            std::vector<_unique_id> ids;
+
+            ids.reserve(size);
+
+            std::lock_guard lock(m);
+
+            for (_unique_id i = 0; i < size; i++)
+                ids.push_back(nextId());
+
+            return ids;
+        }
+
+        /**
+         * @brief Give back the index of a deleted entity
+         * 
+         * @param id Id of the deleted entity
+         * 
+         * The generation of the index is bumped so the released id is never generated again
+         */
+        void releaseId(_unique_id id) noexcept
+        {
+            std::lock_guard lock(m);
+
+            const auto index = entityIndex(id);
+
+            if (index == 0 or index >= generations.size() or generations[index] != entityGeneration(id))
+                return;
+
+            generations[index]++;
+
+            freeIndexes.push_back(index);
+        }
+
+        /**
+         * @brief Check if an id is the current one of its index
+         * 
+         * @param id The id to check
+         * @return true if the id was not released yet (an id is never reissued once released)
+         */
+        bool isCurrent(_unique_id id) noexcept
+        {
+            std::lock_guard lock(m);
+
+            const auto index = entityIndex(id);
+
+            return index != 0 and index < generations.size() and generations[index] == entityGeneration(id);
+        }
+
+        /** Get the number of index ever created, this is the size needed by the sparse arrays */
+        size_t nbIndexes() const noexcept
+        {
+            std::lock_guard lock(m);
+
+            return generations.size() - 1;
+        }
+
+        /** Get the number of index waiting to be reused */
+        size_t nbFreeIndexes() const noexcept
+        {
+            std::lock_guard lock(m);
+
+            return freeIndexes.size();
+        }
+
+    private:
+        /** Pop a free index or create a new one, the mutex must be held */
+        _unique_id nextId() noexcept
+        {
+            if (not freeIndexes.empty())
+            {
+                const auto index = freeIndexes.back();
+                freeIndexes.pop_back();
+
+                return makeEntityId(index, generations[index]);
+            }
+
+            const auto index = generations.size();
+
+            generations.push_back(0);
+
+            return makeEntityId(index, 0);
+        }
+
+        /** Current generation of each index, the index 0 is never used */
+        std::vector<_unique_id> generations = {0};
+
+        /** Indexes of the deleted entities waiting to be reused */
+        std::vector<_unique_id> freeIndexes;
+
+        /** Mutex for concurrent access, mutable so the const getters can take it */
+        mutable std::mutex m;
+    };
 }
\ No newline at end of file
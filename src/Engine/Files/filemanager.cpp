@@ -4,6 +4,7 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <cstdio>
 namespace fs = std::filesystem;
 
 #include "../logger.h"
@@ -12,6 +13,12 @@ namespace fs = std::filesystem;
 #include <emscripten.h>
 #endif
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace pg
 {
     namespace
@@ -73,6 +80,91 @@ namespace pg
                 return TextFile{filename, ""};
             }
         }
+
+        /**
+         * @brief Read a whole file as is, without any line ending conversion
+         * 
+         * @param filename Path to the file
+         * @return TextFile The file with its raw content, empty if it couldn't be read
+         */
+        TextFile openBinFile(const std::string& filename) noexcept
+        {
+            LOG_THIS(DOM);
+
+            try
+            {
+                fs::path p {filename};
+
+                if (not fs::exists(p))
+                {
+                    LOG_INFO(DOM, "Couldn't open file '" << filename << "' : File doesn't exist.");
+                    return TextFile{filename, ""};
+                }
+
+                LOG_INFO(DOM, "Reading binary file '" << filename << "'");
+
+                std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+                if (file.is_open())
+                {
+                    std::string data(fs::file_size(p), '\0');
+
+                    file.read(data.data(), data.size());
+
+                    data.resize(file.gcount());
+
+                    return TextFile{filename, data};
+                }
+
+                return TextFile{filename, ""};
+            }
+            catch (const std::exception& e)
+            {
+                LOG_INFO(DOM, "Couldn't open file '" << filename << "' : " << e.what());
+
+                return TextFile{filename, ""};
+            }
+        }
+
+        /**
+         * @brief Write the data in a file and wait for it to reach the disk
+         * 
+         * @param filename Path of the file to write
+         * @param data Content to write
+         * @param mode Mode of fopen, truncating or appending
+         * 
+         * @return true If the whole data was written and synced
+         */
+        bool writeSynced(const std::string& filename, const std::string& data, const char *mode) noexcept
+        {
+            LOG_THIS(DOM);
+
+            std::FILE *file = std::fopen(filename.c_str(), mode);
+
+            if (not file)
+            {
+                LOG_ERROR(DOM, "Couldn't open file '" << filename << "' : File is unaccessible");
+                return false;
+            }
+
+            bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+
+            written = std::fflush(file) == 0 and written;
+
+            // Flushing only hands the data to the os, it still needs to be synced for the write to survive a crash
+#ifdef _WIN32
+            written = _commit(_fileno(file)) == 0 and written;
+#else
+            written = fsync(fileno(file)) == 0 and written;
+#endif
+
+            written = std::fclose(file) == 0 and written;
+
+            if (not written)
+                LOG_ERROR(DOM, "Couldn't write file '" << filename << "'");
+
+            return written;
+        }
     }
 
     TextFile ResourceAccessor::openTextFile(const std::string& filepath) noexcept
@@ -82,6 +174,13 @@ namespace pg
         return openTxtFile(":/" + filepath);
     }
 
+    TextFile ResourceAccessor::openBinaryFile(const std::string& filepath) noexcept
+    {
+        LOG_THIS(DOM);
+
+        return openBinFile(":/" + filepath);
+    }
+
     std::vector<TextFile> ResourceAccessor::openTextFolder(const std::string& foldername) noexcept
     {
         LOG_THIS(DOM);
@@ -105,6 +204,13 @@ namespace pg
         return openTxtFile(filepath);
     }
 
+    TextFile FileAccessor::openBinaryFile(const std::string& filepath) noexcept
+    {
+        LOG_THIS(DOM);
+
+        return openBinFile(filepath);
+    }
+
     std::vector<TextFile> FileAccessor::openTextFolder(const std::string& foldername, bool recursive) noexcept
     {
         LOG_THIS(DOM);
@@ -145,12 +251,15 @@ namespace pg
         return folder;
     }
 
-    bool FileAccessor::writeToFile(const TextFile& file, const std::string& data, bool truncate) noexcept
+    bool FileAccessor::writeToFile(const TextFile& file, const std::string& data, bool truncate, bool binary) noexcept
     {
         LOG_THIS(DOM);
 
         auto flags = truncate ? std::ofstream::out | std::ofstream::trunc : std::ofstream::out;
 
+        if (binary)
+            flags |= std::ofstream::binary;
+
         try
         {
             std::ofstream p{file.filepath, flags};
@@ -174,6 +283,57 @@ namespace pg
         return true;
     }
 
+    bool FileAccessor::replaceFile(const TextFile& file, const std::string& data, bool binary) noexcept
+    {
+        LOG_THIS(DOM);
+
+        const auto tempPath = file.filepath + ".tmp";
+
+        if (not writeSynced(tempPath, data, binary ? "wb" : "w"))
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        std::error_code ec;
+
+        fs::rename(tempPath, file.filepath, ec);
+
+        if (ec)
+        {
+            LOG_ERROR(DOM, "Couldn't replace file '" << file.filepath << "' : " << ec.message());
+
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool FileAccessor::appendToFile(const TextFile& file, const std::string& data, bool binary) noexcept
+    {
+        LOG_THIS(DOM);
+
+        return writeSynced(file.filepath, data, binary ? "ab" : "a");
+    }
+
+    bool FileAccessor::removeFile(const TextFile& file) noexcept
+    {
+        LOG_THIS(DOM);
+
+        std::error_code ec;
+
+        fs::remove(file.filepath, ec);
+
+        if (ec)
+        {
+            LOG_ERROR(DOM, "Couldn't remove file '" << file.filepath << "' : " << ec.message());
+            return false;
+        }
+
+        return true;
+    }
+
     /**
      * @brief Universal file accessor for both res file and system files
      * 
@@ -208,6 +368,27 @@ namespace pg
         }
     }
 
+    TextFile UniversalFileAccessor::openBinaryFile(const std::string& filepath) noexcept
+    {
+        LOG_THIS(DOM);
+
+        TextFile resFile;
+
+        auto file = FileAccessor::openBinaryFile(filepath);
+
+        if (file.data == "")
+            resFile = ResourceAccessor::openBinaryFile(filepath);
+
+        if (resFile.data == "")
+        {
+            return file;
+        }
+        else
+        {
+            return resFile;
+        }
+    }
+
     std::vector<TextFile> UniversalFileAccessor::openTextFolder(const std::string& foldername) noexcept
     {
         LOG_THIS(DOM);
@@ -220,9 +401,24 @@ namespace pg
         return folder;
     }
 
-    bool UniversalFileAccessor::writeToFile(const TextFile& file, const std::string& data, bool truncate) noexcept
+    bool UniversalFileAccessor::writeToFile(const TextFile& file, const std::string& data, bool truncate, bool binary) noexcept
+    {
+        return FileAccessor::writeToFile(file, data, truncate, binary);
+    }
+
+    bool UniversalFileAccessor::replaceFile(const TextFile& file, const std::string& data, bool binary) noexcept
+    {
+        return FileAccessor::replaceFile(file, data, binary);
+    }
+
+    bool UniversalFileAccessor::appendToFile(const TextFile& file, const std::string& data, bool binary) noexcept
+    {
+        return FileAccessor::appendToFile(file, data, binary);
+    }
+
+    bool UniversalFileAccessor::removeFile(const TextFile& file) noexcept
     {
-        return FileAccessor::writeToFile(file, data, truncate);
+        return FileAccessor::removeFile(file);
     }
 
     std::string UniversalFileAccessor::getFileName(const TextFile& file) noexcept
@@ -22,6 +22,7 @@ namespace pg
     {
     public:
         static TextFile openTextFile(const std::string& filepath) noexcept;
+        static TextFile openBinaryFile(const std::string& filepath) noexcept;
         static std::vector<TextFile> openTextFolder(const std::string& foldername) noexcept;
     };
 
@@ -29,18 +30,36 @@ namespace pg
     {
     public:
         static TextFile openTextFile(const std::string& filepath) noexcept;
+        static TextFile openBinaryFile(const std::string& filepath) noexcept;
         static std::vector<TextFile> openTextFolder(const std::string& foldername, bool recursive = false) noexcept;
 
-        static bool writeToFile(const TextFile& file, const std::string& data, bool truncate = false) noexcept;
+        static bool writeToFile(const TextFile& file, const std::string& data, bool truncate = false, bool binary = false) noexcept;
+
+        /**
+         * @brief Replace the content of a file atomically
+         * 
+         * The data is written and synced to a temporary file next to the target which is then renamed over it,
+         * so a crash in the middle of the write leaves either the old or the new content on disk, never a truncated file.
+         */
+        static bool replaceFile(const TextFile& file, const std::string& data, bool binary = false) noexcept;
+
+        /** Append the data at the end of the file, creating it if needed, and sync it to disk before returning */
+        static bool appendToFile(const TextFile& file, const std::string& data, bool binary = false) noexcept;
+
+        static bool removeFile(const TextFile& file) noexcept;
     };
 
     class UniversalFileAccessor
     {
     public:
         static TextFile openTextFile(const std::string& filepath) noexcept;
+        static TextFile openBinaryFile(const std::string& filepath) noexcept;
         static std::vector<TextFile> openTextFolder(const std::string& foldername) noexcept;
 
-        static bool writeToFile(const TextFile& file, const std::string& data, bool truncate = false) noexcept;
+        static bool writeToFile(const TextFile& file, const std::string& data, bool truncate = false, bool binary = false) noexcept;
+        static bool replaceFile(const TextFile& file, const std::string& data, bool binary = false) noexcept;
+        static bool appendToFile(const TextFile& file, const std::string& data, bool binary = false) noexcept;
+        static bool removeFile(const TextFile& file) noexcept;
 
         static std::string getFileName(const TextFile& file) noexcept;
         static std::string getFoldername(const TextFile& file) noexcept;
@@ -121,6 +121,7 @@ namespace pg
         CompRef<UiComponent> ui;
     };
 
+    // The click callbacks can modify the ui components, so this system holds a writing ref on them
     struct MouseClickSystem : public System<Own<MouseLeftClickComponent>, Own<MouseRightClickComponent>, Ref<UiComponent>, NamedSystem, InitSys>
     {
         MouseClickSystem(Input* inputHandler) : inputHandler(inputHandler) { LOG_THIS_MEMBER("MouseClickSystem"); }
@@ -145,6 +146,7 @@ namespace pg
     };
 
     // Todo combine this in the MouseClickSystem
+    // Same as the MouseClickSystem, the callbacks can modify the ui components
     struct MouseLeaveClickSystem : public System<Listener<OnMouseClick>, Own<MouseLeaveClickComponent>, Ref<UiComponent>, NamedSystem, InitSys, StoragePolicy>
     {
         MouseLeaveClickSystem(Input* inputHandler) : inputHandler(inputHandler) { LOG_THIS_MEMBER("MouseLeaveClickSystem"); }
@@ -47,7 +47,7 @@ namespace pg
             case TokenType::MINUS:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue - rvalue);
+                    return makeVariable(lvalue - rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -59,7 +59,7 @@ namespace pg
             case TokenType::PLUS:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue + rvalue);
+                    return makeVariable(lvalue + rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -71,7 +71,7 @@ namespace pg
             case TokenType::STAR:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue * rvalue);
+                    return makeVariable(lvalue * rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -82,7 +82,7 @@ namespace pg
             case TokenType::SLASH:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue / rvalue);
+                    return makeVariable(lvalue / rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -93,7 +93,7 @@ namespace pg
             case TokenType::MOD:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue % rvalue);
+                    return makeVariable(lvalue % rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -104,7 +104,7 @@ namespace pg
             case TokenType::SUP:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue > rvalue);
+                    return makeVariable(lvalue > rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -116,7 +116,7 @@ namespace pg
             case TokenType::SUPEQUAL:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue >= rvalue);
+                    return makeVariable(lvalue >= rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -128,7 +128,7 @@ namespace pg
             case TokenType::INF:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue < rvalue);
+                    return makeVariable(lvalue < rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -140,7 +140,7 @@ namespace pg
             case TokenType::INFEQUAL:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue <= rvalue);
+                    return makeVariable(lvalue <= rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -152,7 +152,7 @@ namespace pg
             case TokenType::EQUALEQUAL:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue == rvalue);
+                    return makeVariable(lvalue == rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -164,7 +164,7 @@ namespace pg
             case TokenType::NOTEQUAL:
                 try
                 {
-                    return std::make_shared<Variable>(lvalue != rvalue);
+                    return makeVariable(lvalue != rvalue);
                 }
                 catch(const std::exception& e)
                 {
@@ -189,11 +189,11 @@ namespace pg
         switch(expr->op.type)
         {
             case TokenType::LOGICOR:
-                if (lvalue.isTrue()) return std::make_shared<Variable>(ElementType { lvalue.isTrue() });
+                if (lvalue.isTrue()) return makeVariable(ElementType { lvalue.isTrue() });
                 break;
             
             case TokenType::LOGICAND:
-                if (not lvalue.isTrue()) return std::make_shared<Variable>(ElementType { lvalue.isTrue() });
+                if (not lvalue.isTrue()) return makeVariable(ElementType { lvalue.isTrue() });
                 break;
 
             default:
@@ -201,7 +201,7 @@ namespace pg
                 break;
         }
 
-        return std::make_shared<Variable>(ElementType { expr->rightExpr->accept(this)->getElement().isTrue() });
+        return makeVariable(ElementType { expr->rightExpr->accept(this)->getElement().isTrue() });
     }
 
     std::shared_ptr<Valuable> VisitorInterpreter::visit(UnaryExpression *expr)
@@ -211,13 +211,13 @@ namespace pg
         switch(expr->op.type)
         {
             case TokenType::NOT:
-                return std::make_shared<Variable>(ElementType { not value.isTrue() });
+                return makeVariable(ElementType { not value.isTrue() });
                 break;
 
             case TokenType::MINUS:
                 try
                 {
-                    return std::make_shared<Variable>(-value);
+                    return makeVariable(-value);
                 }
                 catch(const std::exception& e)
                 {
@@ -254,7 +254,7 @@ namespace pg
                         return it->get(Token{TokenType::EXPRESSION, "current", 0, 0})->getValue(emptyQueue);
                     }
 
-                    auto res = std::make_shared<Variable>(value + ElementType{1});
+                    auto res = makeVariable(value + ElementType{1});
 
                     assignVariable(expr->name, expr, res);
 
@@ -269,7 +269,7 @@ namespace pg
             case TokenType::DECREMENT:
                 try
                 {
-                    auto res = std::make_shared<Variable>(value - ElementType{1});
+                    auto res = makeVariable(value - ElementType{1});
 
                     assignVariable(expr->name, expr, res);
 
@@ -311,7 +311,7 @@ namespace pg
                         return baseValue;
                     }
 
-                    auto res = std::make_shared<Variable>(value + ElementType{1});
+                    auto res = makeVariable(value + ElementType{1});
 
                     assignVariable(expr->name, expr, res);
 
@@ -326,7 +326,7 @@ namespace pg
             case TokenType::DECREMENT:
                 try
                 {
-                    auto res = std::make_shared<Variable>(value - ElementType{1});
+                    auto res = makeVariable(value - ElementType{1});
 
                     assignVariable(expr->name, expr, res);
 
@@ -353,7 +353,7 @@ namespace pg
 
     std::shared_ptr<Valuable> VisitorInterpreter::visit(Atom *expr)
     {
-        return std::make_shared<Variable>(expr->value);
+        return makeVariable(expr->value);
     }
 
     std::shared_ptr<Valuable> VisitorInterpreter::visit(List *expr)
@@ -486,7 +486,7 @@ namespace pg
         if (stmt->expr)
             value = stmt->expr->accept(this);
         else
-            value = std::make_shared<Variable>(ElementType{});
+            value = makeVariable(ElementType{});
 
         env->declareValue(name.text, value);
     }
@@ -753,7 +753,7 @@ namespace pg
             statements.pop();
         }
 
-        return std::make_shared<Variable>(ElementType{0});
+        return makeVariable(ElementType{0});
     }
 
     // std::shared_ptr<Valuable> VisitorReference::lookUpVariable(const std::string& name, const Token& token, Expression* expression) const
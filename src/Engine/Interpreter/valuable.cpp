@@ -95,7 +95,7 @@ namespace pg
      */
     std::shared_ptr<Valuable> Function::getValue() const
     {
-        return std::make_shared<Variable>(name);
+        return makeVariable(name);
     }
 
     /**
@@ -175,7 +175,7 @@ namespace pg
 
     std::shared_ptr<Valuable> Class::getValue() const
     {
-        return std::make_shared<Variable>(name);
+        return makeVariable(name);
     }
 
     std::shared_ptr<Valuable> Class::getValue(std::queue<std::shared_ptr<Valuable>>& args)
@@ -236,12 +236,12 @@ namespace pg
 
     std::shared_ptr<Valuable> ClassInstance::getValue() const
     {
-        return std::make_shared<Variable>(name);
+        return makeVariable(name);
     }
 
     std::shared_ptr<Valuable> ClassInstance::getValue(std::queue<std::shared_ptr<Valuable>>&)
     {
-        return std::make_shared<Variable>(name);
+        return makeVariable(name);
     }
 
     std::shared_ptr<Valuable> ClassInstance::get(const Token& token) const
@@ -460,7 +460,7 @@ namespace pg
     ValuablePtr SizeFunction::call(ValuableQueue&)
     {
         // Return the size of the current instance
-        return std::make_shared<Variable>(ElementType { instance->getSize() });
+        return makeVariable(ElementType { instance->getSize() });
     }
 
     EraseFunction::EraseFunction(ExprPtr self, std::shared_ptr<Environment> env, const std::string& name, const Token& token, VisitorInterpreter* visitor, std::queue<ExprPtr> argsList, StatementPtr body, std::shared_ptr<ClassInstance> instance) :
@@ -492,7 +492,7 @@ namespace pg
     ValuablePtr BeginFunction::call(ValuableQueue&)
     {
         // Return the iterator instance
-        return std::make_shared<Variable>(ElementType { 0 });
+        return makeVariable(ElementType { 0 });
     }
 
     EndFunction::EndFunction(ExprPtr self, std::shared_ptr<Environment> env, const std::string& name, const Token& token, VisitorInterpreter* visitor, std::queue<ExprPtr> argsList, StatementPtr body, std::shared_ptr<IteratorInstance> instance) :
@@ -506,7 +506,7 @@ namespace pg
     ValuablePtr EndFunction::call(ValuableQueue&)
     {
         // Return the iterator instance
-        return std::make_shared<Variable>(ElementType { instance->refFields.size() });
+        return makeVariable(ElementType { instance->refFields.size() });
     }
 
     CurrentFunction::CurrentFunction(ExprPtr self, std::shared_ptr<Environment> env, const std::string& name, const Token& token, VisitorInterpreter* visitor, std::queue<ExprPtr> argsList, StatementPtr body, std::shared_ptr<IteratorInstance> instance) :
@@ -520,7 +520,7 @@ namespace pg
     ValuablePtr CurrentFunction::call(ValuableQueue&)
     {
         if (instance->index >= instance->refFields.size())
-            return std::make_shared<Variable>(ElementType { instance->refFields.size() });
+            return makeVariable(ElementType { instance->refFields.size() });
         
         std::queue<ExprPtr> emptyQueue;
 
@@ -528,7 +528,7 @@ namespace pg
 
         auto mapValue = std::make_shared<ClassInstance>(nullptr);
 
-        mapValue->set(Token{TokenType::EXPRESSION, "first", token.line, token.column}, std::make_shared<Variable>(ElementType { itValue.key }));
+        mapValue->set(Token{TokenType::EXPRESSION, "first", token.line, token.column}, makeVariable(ElementType { itValue.key }));
         mapValue->set(Token{TokenType::EXPRESSION, "second", token.line, token.column}, itValue.value);
 
         return mapValue;
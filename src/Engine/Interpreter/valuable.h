@@ -20,6 +20,7 @@
 
 #include "token.h"
 #include "Memory/elementtype.h"
+#include "Memory/memorypool.h"
 
 namespace pg
 {
@@ -148,7 +149,7 @@ namespace pg
          * 
          * Override of the getValue() method of Valuable
          */
-        virtual std::shared_ptr<Valuable> getValue() const override { return std::make_shared<Variable>(value); }
+        virtual std::shared_ptr<Valuable> getValue() const override;
 
         /**
          * @brief Get the Value object
@@ -173,8 +174,14 @@ namespace pg
         ElementType value;
     };
 
+    /** Create a variable, variables are allocated from a pool as every expression evaluated by the interpreter systems creates one */
+    template <typename... Args>
+    inline std::shared_ptr<Variable> makeVariable(Args&&... args) { return std::allocate_shared<Variable>(ConcurrentPoolAllocator<Variable>(), std::forward<Args>(args)...); }
+
+    inline std::shared_ptr<Valuable> Variable::getValue() const { return makeVariable(value); }
+
     template<typename T>
-    inline std::shared_ptr<Variable> makeVar(const T& value) { return std::make_shared<Variable>(ElementType { value }); } 
+    inline std::shared_ptr<Variable> makeVar(const T& value) { return makeVariable(ElementType { value }); } 
 
     /**
      * @struct Arity
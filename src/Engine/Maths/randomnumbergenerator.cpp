@@ -50,7 +50,7 @@ namespace pg
         }
         else
         {
-            LOG_INFO(DOM, "Deserializing " + element.getObjectName());
+            LOG_INFO(DOM, "Deserializing " << element.getObjectName());
 
             auto seed = deserialize<unsigned int>(element);
 
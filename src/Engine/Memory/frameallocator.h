@@ -0,0 +1,206 @@
+#pragma once
+
+/**
+ * @file frameallocator.h
+ * @brief Definition of a double buffered frame allocator and of the containers using it
+ *
+ */
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "lineararena.h"
+
+namespace pg
+{
+    /**
+     * @brief Double buffered set of linear arenas holding the transient data of a frame
+     *
+     * Each slot owns its own arena per frame so different threads can allocate at the same time without locking,
+     * as long as a slot is only used by a single thread.
+     * Threads that don't own a slot share one more arena per frame, guarded by a mutex (see getSharedArena).
+     * Memory handed out during a frame stays valid until the end of the next frame: it can be read by
+     * whoever consumes the result of the frame (e.g. the renderer) while the following frame is being built.
+     */
+    class FrameAllocator
+    {
+    public:
+        FrameAllocator(size_t nbSlots = 1, size_t blockSize = LinearArena::DEFAULTBLOCKSIZE) : blockSize(blockSize)
+        {
+            setNbSlots(nbSlots);
+
+            for (auto& arena : sharedArenas)
+                arena = std::make_unique<LinearArena>(blockSize);
+        }
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        /**
+         * @brief Set the number of slots of the allocator
+         *
+         * @warning Every memory handed out so far is released, must only be called when no frame is running
+         */
+        void setNbSlots(size_t nbSlots)
+        {
+            for (auto& frame : frames)
+            {
+                frame.clear();
+
+                for (size_t i = 0; i < nbSlots; i++)
+                    frame.push_back(std::make_unique<LinearArena>(blockSize));
+            }
+        }
+
+        /** Get the arena of a slot for the current frame */
+        inline LinearArena& getArena(size_t slot)
+        {
+            return *frames[currentFrame.load(std::memory_order_acquire)][slot];
+        }
+
+        /**
+         * @brief Get the shared arena of the current frame
+         *
+         * @warning The arena is shared by all the threads without a slot, getSharedMutex() must be held while allocating from it
+         */
+        inline LinearArena& getSharedArena()
+        {
+            return *sharedArenas[currentFrame.load(std::memory_order_acquire)];
+        }
+
+        /** Mutex guarding the shared arenas */
+        inline std::mutex& getSharedMutex() { return sharedMutex; }
+
+        /**
+         * @brief Start a new frame, releasing the memory handed out two frames ago
+         *
+         * The arenas keep their blocks, so once the frames reach a steady size no more memory is requested to the system.
+         */
+        void nextFrame()
+        {
+            const size_t next = 1 - currentFrame.load(std::memory_order_relaxed);
+
+            for (auto& arena : frames[next])
+                arena->reset();
+
+            {
+                std::lock_guard<std::mutex> lock(sharedMutex);
+
+                sharedArenas[next]->reset();
+            }
+
+            currentFrame.store(next, std::memory_order_release);
+        }
+
+        inline size_t getNbSlots() const { return frames[0].size(); }
+
+        /** Number of bytes handed out during the current frame */
+        size_t nbAllocatedBytes() const
+        {
+            size_t total = 0;
+
+            const auto frame = currentFrame.load(std::memory_order_acquire);
+
+            for (const auto& arena : frames[frame])
+                total += arena->nbAllocatedBytes();
+
+            std::lock_guard<std::mutex> lock(sharedMutex);
+
+            return total + sharedArenas[frame]->nbAllocatedBytes();
+        }
+
+        /** Number of bytes reserved by the arenas of both frames */
+        size_t capacity() const
+        {
+            size_t total = 0;
+
+            for (const auto& frame : frames)
+                for (const auto& arena : frame)
+                    total += arena->capacity();
+
+            std::lock_guard<std::mutex> lock(sharedMutex);
+
+            for (const auto& arena : sharedArenas)
+                total += arena->capacity();
+
+            return total;
+        }
+
+    private:
+        size_t blockSize;
+
+        /** Arenas of the two frames, the unique_ptr keep the arenas in place */
+        std::vector<std::unique_ptr<LinearArena>> frames[2];
+
+        /** Arenas of the two frames used by the threads without a slot */
+        std::unique_ptr<LinearArena> sharedArenas[2];
+
+        mutable std::mutex sharedMutex;
+
+        std::atomic<size_t> currentFrame {0};
+    };
+
+    /**
+     * @brief Standard allocator taking its memory from a linear arena
+     *
+     * Deallocation is a no-op, all the memory is released at once when the arena is reset.
+     * Containers using this allocator should reserve their size up front as every reallocation leaves the old buffer in the arena.
+     * When a mutex is given, it is locked around each allocation so an arena can be shared between threads.
+     *
+     * @tparam T Type of the allocated objects
+     */
+    template <typename T>
+    struct FrameStdAllocator
+    {
+        typedef T value_type;
+
+        FrameStdAllocator(LinearArena* arena, std::mutex* mutex = nullptr) noexcept : arena(arena), mutex(mutex) {}
+
+        template <typename U>
+        FrameStdAllocator(const FrameStdAllocator<U>& other) noexcept : arena(other.arena), mutex(other.mutex) {}
+
+        inline T* allocate(size_t n)
+        {
+            if (not mutex)
+                return arena->allocate<T>(n);
+
+            std::lock_guard<std::mutex> lock(*mutex);
+
+            return arena->allocate<T>(n);
+        }
+
+        inline void deallocate(T*, size_t) noexcept {}
+
+        template <typename U>
+        inline bool operator==(const FrameStdAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+        template <typename U>
+        inline bool operator!=(const FrameStdAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+        LinearArena* arena;
+
+        std::mutex* mutex;
+    };
+
+    /** Vector living in a frame arena */
+    template <typename T>
+    using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+
+    /** Set living in a frame arena */
+    template <typename Key, typename Compare = std::less<Key>>
+    using FrameSet = std::set<Key, Compare, FrameStdAllocator<Key>>;
+
+    /** Map living in a frame arena */
+    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    using FrameMap = std::map<Key, Value, Compare, FrameStdAllocator<std::pair<const Key, Value>>>;
+
+    /** Queue living in a frame arena */
+    template <typename T>
+    using FrameQueue = std::queue<T, std::deque<T, FrameStdAllocator<T>>>;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file lineararena.h
+ * @brief Definition of a linear (bump) arena
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace pg
+{
+    /**
+     * @brief Append only arena handing out memory by bumping an offset in big blocks
+     *
+     * Allocations are never freed one by one: the whole arena is reset at once and keeps its blocks
+     * so the next round of allocations doesn't hit the heap. The addresses handed out stay valid until the next reset.
+     *
+     * This class is not thread safe.
+     */
+    class LinearArena
+    {
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+    public:
+        /** Default size of a block of the arena */
+        static constexpr size_t DEFAULTBLOCKSIZE = 64 * 1024;
+
+        LinearArena(size_t blockSize = DEFAULTBLOCKSIZE) : blockSize(blockSize) {}
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        /**
+         * @brief Get a chunk of memory from the arena
+         *
+         * @param size Size in bytes of the chunk
+         * @param alignment Alignment of the chunk, must be a power of 2
+         * @return void* A pointer to the chunk, valid until the next reset of the arena
+         */
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+        {
+            while (currentBlock < blocks.size())
+            {
+                auto& block = blocks[currentBlock];
+
+                const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+                const auto aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+                if (aligned + size <= base + block.size)
+                {
+                    offset = aligned + size - base;
+                    allocated += size;
+
+                    return reinterpret_cast<void*>(aligned);
+                }
+
+                // The current block is full, try the next one kept from a previous round
+                currentBlock++;
+                offset = 0;
+            }
+
+            // No block left, get a new one big enough for this allocation
+            const auto newBlockSize = std::max(blockSize, size + alignment);
+
+            blocks.push_back(Block{std::make_unique<std::byte[]>(newBlockSize), newBlockSize});
+
+            currentBlock = blocks.size() - 1;
+            offset = 0;
+
+            return allocate(size, alignment);
+        }
+
+        /** Allocate an uninitialized array of nbElements objects of type T */
+        template <typename T>
+        inline T* allocate(size_t nbElements = 1)
+        {
+            return static_cast<T*>(allocate(sizeof(T) * nbElements, alignof(T)));
+        }
+
+        /** Construct a new object of type T in the arena, its destructor is never called by the arena */
+        template <typename T, typename... Args>
+        inline T* create(Args&&... args)
+        {
+            return ::new(allocate<T>()) T(std::forward<Args>(args)...);
+        }
+
+        /** Release every allocation at once, the blocks are kept for the next allocations */
+        void reset()
+        {
+            currentBlock = 0;
+            offset = 0;
+            allocated = 0;
+        }
+
+        /** Number of bytes handed out since the last reset */
+        inline size_t nbAllocatedBytes() const { return allocated; }
+
+        /** Number of bytes reserved by the arena */
+        inline size_t capacity() const
+        {
+            size_t total = 0;
+
+            for (const auto& block : blocks)
+                total += block.size;
+
+            return total;
+        }
+
+    private:
+        std::vector<Block> blocks;
+
+        size_t blockSize;
+        size_t currentBlock = 0;
+        size_t offset = 0;
+        size_t allocated = 0;
+    };
+}
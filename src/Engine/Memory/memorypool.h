@@ -12,11 +12,14 @@
  */
 
 #include <type_traits>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <cmath>
 #include <atomic>
+#include <algorithm>
+#include <unordered_map>
 
 #include "logger.h"
 namespace pg
@@ -87,7 +90,7 @@ namespace pg
             LOG_THIS_MEMBER("Memory Pool");
 
             for (Chunk<T>* chunk : chunkList)
-                delete chunk;
+                delete[] chunk;
         }
 
         /**
@@ -153,17 +156,205 @@ namespace pg
                 return reinterpret_cast<T*>(chunk);
             }
 
-            const size_t index = nbElements++;
+            // Chunks below the high water mark are either in use or in the free list
+            const size_t index = highWater++;
 
             if (index >= size) reserve(index);
 
-            // Todo Check if the chunk was created before creating a new element 
             Chunk<T>* chunk = getChunk(index);
 
+            nbElements++;
+
             return ::new(&(chunk->element)) T(std::forward<Args>(args)...);
         } 
 
-        // Todo add a bulk allocation and deallocation function
+        /**
+         * @brief Allocate multiple T objects at once
+         * 
+         * @param nbObjects Number of objects to create
+         * @param out Array receiving the pointers to the new objects, must hold at least nbObjects pointers
+         * @param args Argument used to construct each of the objects (copied for each of them)
+         * 
+         * The pool grows at most once for the whole batch instead of checking its size for each object.
+         * 
+         * @see releaseBulk
+         */
+        template <typename... Args>
+        void allocateBulk(size_t nbObjects, T** out, const Args&... args)
+        {
+            LOG_THIS_MEMBER("Memory Pool");
+
+            size_t i = 0;
+
+            for (; i < nbObjects and freeList; ++i)
+            {
+                auto chunk = freeList;
+                freeList = chunk->next;
+
+                out[i] = ::new(&(chunk->element)) T(args...);
+            }
+
+            const size_t remaining = nbObjects - i;
+
+            if (remaining > 0)
+            {
+                if (highWater + remaining > size)
+                    reserve(highWater + remaining - 1);
+
+                for (; i < nbObjects; ++i)
+                {
+                    out[i] = ::new(&(getChunk(highWater++)->element)) T(args...);
+                }
+            }
+
+            nbElements += nbObjects;
+        }
+
+        /**
+         * @brief Release multiple objects created using the pool at once
+         * 
+         * @param pointers Array of pointers to T objects, null pointers are skipped
+         * @param nbObjects Number of pointers in the array
+         * 
+         * @see allocateBulk
+         */
+        void releaseBulk(T* const* pointers, size_t nbObjects)
+        {
+            LOG_THIS_MEMBER("Memory Pool");
+
+            for (size_t i = 0; i < nbObjects; ++i)
+            {
+                auto pointer = pointers[i];
+
+                if (pointer == nullptr)
+                    continue;
+
+                pointer->~T();
+
+                reinterpret_cast<Chunk<T>*>(pointer)->next = freeList;
+                freeList = reinterpret_cast<Chunk<T>*>(pointer);
+
+                nbElements--;
+            }
+        }
+
+        /**
+         * @brief Give back to the system the memory of the blocks that don't hold any object anymore
+         * 
+         * Empty blocks at the end of the pool are removed and will be created again if the pool grows back.
+         * Empty blocks in the middle of the pool are freed and never reused: the pool keeps growing from its end.
+         * 
+         * @return size_t The number of chunks freed
+         */
+        size_t shrink()
+        {
+            LOG_THIS_MEMBER("Memory Pool");
+
+            const size_t nbBlocks = chunkList.size();
+
+            if (nbBlocks == 0)
+                return 0;
+
+            // Blocks sorted by address to find the block owning a free chunk
+            std::vector<std::pair<uintptr_t, size_t>> blocks;
+            blocks.reserve(nbBlocks);
+
+            for (size_t i = 0; i < nbBlocks; ++i)
+            {
+                if (chunkList[i])
+                    blocks.emplace_back(reinterpret_cast<uintptr_t>(chunkList[i]), i);
+            }
+
+            std::sort(blocks.begin(), blocks.end());
+
+            const auto findBlock = [&blocks](Chunk<T>* chunk) {
+                auto it = std::upper_bound(blocks.begin(), blocks.end(), std::make_pair(reinterpret_cast<uintptr_t>(chunk), SIZE_MAX));
+                return (--it)->second;
+            };
+
+            std::vector<size_t> nbFreeChunks(nbBlocks, 0);
+
+            for (auto chunk = freeList; chunk; chunk = chunk->next)
+                nbFreeChunks[findBlock(chunk)]++;
+
+            std::vector<bool> freedBlocks(nbBlocks, false);
+            size_t nbFreedChunks = 0;
+            bool trailing = true;
+
+            for (size_t i = nbBlocks; i > 0; --i)
+            {
+                const size_t blockIndex = i - 1;
+                const size_t start = blockStart(blockIndex);
+                const size_t length = blockLength(blockIndex);
+
+                // A chunk above the high water mark was never handed out
+                const size_t nbUsedChunks = highWater > start ? std::min(highWater - start, length) : 0;
+
+                const bool empty = chunkList[blockIndex] == nullptr or nbFreeChunks[blockIndex] == nbUsedChunks;
+
+                if (not empty)
+                {
+                    trailing = false;
+                    continue;
+                }
+
+                if (chunkList[blockIndex])
+                {
+                    freedBlocks[blockIndex] = true;
+                    nbFreedChunks += length;
+                }
+
+                if (trailing)
+                {
+                    // A block freed in the middle of the pool by a previous shrink is now at the end
+                    if (chunkList[blockIndex] == nullptr)
+                        releasedSize -= length;
+
+                    size -= length;
+                    highWater = std::min(highWater, start);
+                }
+                else if (chunkList[blockIndex])
+                {
+                    releasedSize += length;
+                }
+            }
+
+            if (nbFreedChunks == 0)
+                return 0;
+
+            // Remove the chunks of the freed blocks from the free list
+            Chunk<T>* head = nullptr;
+            Chunk<T>** tail = &head;
+
+            for (auto chunk = freeList; chunk; chunk = chunk->next)
+            {
+                if (not freedBlocks[findBlock(chunk)])
+                {
+                    *tail = chunk;
+                    tail = &chunk->next;
+                }
+            }
+
+            *tail = nullptr;
+            freeList = head;
+
+            for (size_t i = 0; i < nbBlocks; ++i)
+            {
+                if (freedBlocks[i])
+                {
+                    delete[] chunkList[i];
+                    chunkList[i] = nullptr;
+                }
+            }
+
+            // Blocks removed from the end of the pool will be created again by reserve when needed
+            while (not chunkList.empty() and chunkList.back() == nullptr and blockStart(chunkList.size() - 1) >= size)
+                chunkList.pop_back();
+
+            LOG_MILE("Memory Pool", "Shrinked the pool by " << nbFreedChunks << " chunks, current size: " << getSize());
+
+            return nbFreedChunks;
+        }
 
         /**
          * @brief Function used to release the memory of a T object create using the pool
@@ -201,7 +392,7 @@ namespace pg
          * 
          * @return constexpr size_t The size of the pool
          */
-        inline constexpr size_t getSize() const { return size; }
+        inline constexpr size_t getSize() const { return size - releasedSize; }
 
         /**
          * @brief Get a specific element in the pool by his index
@@ -245,18 +436,459 @@ namespace pg
 
             return &chunkList[listPos][vectorPos];
         }
+
+        /** Index of the first chunk of a block */
+        static inline constexpr size_t blockStart(size_t blockIndex)
+        {
+            return N >= 2 ? blockIndex * N : (static_cast<size_t>(1) << blockIndex) - 1;
+        }
+
+        /** Number of chunks in a block */
+        static inline constexpr size_t blockLength(size_t blockIndex)
+        {
+            return N >= 2 ? N : static_cast<size_t>(1) << blockIndex;
+        }
     
     private:
-        /** Current size of the memory pool */
+        /** Current size of the memory pool (including the blocks freed by a shrink) */
         size_t size = 0;
 
+        /** Number of chunks of the blocks freed in the middle of the pool by a shrink */
+        size_t releasedSize = 0;
+
         /** Current number of elements allocated in the memory pool */
         size_t nbElements = 0;
 
+        /** Number of chunks handed out at least once, the next new chunk is taken at this index */
+        size_t highWater = 0;
+
         /** Pointer to the next free object in the pool */
         Chunk<T>* freeList = nullptr;
 
         /** Chunk Lists used in the pool (used to free the memory) */
         std::vector<Chunk<T>*> chunkList;
     };
+
+    /**
+     * @brief A thread safe allocator pool
+     * 
+     * @tparam T Type of the object to be created
+     * @tparam CacheSize Number of free chunks moved at once between the thread caches and the shared depot
+     * 
+     * Each thread allocates from and releases to its own cache of free chunks without any lock.
+     * The shared depot, guarded by a mutex, is only hit when a cache runs empty (to get a batch of CacheSize chunks)
+     * or when it holds too many chunks (to give back a batch of CacheSize chunks).
+     * An object can be released by another thread than the one that allocated it.
+     * 
+     * @warning The chunks kept in the cache of a thread are lost to the other threads until the pool is destroyed,
+     * use flush to give them back to the depot (for example before a shrink).
+     */
+    template <typename T, size_t CacheSize = 64>
+    class ConcurrentAllocatorPool
+    {
+        static_assert(CacheSize > 0, "The cache of a concurrent allocator pool cannot be empty");
+
+        /** Number of chunks created at once when the depot runs out of free chunks */
+        static constexpr size_t BLOCKSIZE = CacheSize * 16;
+
+        /** Free chunks owned by a single thread */
+        struct LocalCache
+        {
+            std::vector<Chunk<T>*> chunks;
+
+            /** Number of objects allocated minus the number released by this thread, only written by the owning thread */
+            std::atomic<int64_t> nbElements {0};
+        };
+
+        /** Caches of all the pools used by a thread, shared with the pools so that they can remove their entry when destroyed */
+        struct ThreadCaches
+        {
+            /** Guard the map against the destruction of a pool from another thread */
+            std::mutex mutex;
+
+            std::unordered_map<uint64_t, LocalCache*> caches;
+        };
+
+    public:
+        ConcurrentAllocatorPool() : id(nextId.fetch_add(1, std::memory_order_relaxed)) {}
+
+        ConcurrentAllocatorPool(const ConcurrentAllocatorPool&) = delete;
+        ConcurrentAllocatorPool& operator=(const ConcurrentAllocatorPool&) = delete;
+
+        /**
+         * @brief Destroy the Concurrent Allocator Pool object
+         * 
+         * @warning If the user forget to release memory, memory leaks can occur !
+         * The pool must not be used by any thread anymore when destroyed.
+         */
+        ~ConcurrentAllocatorPool()
+        {
+            LOG_THIS_MEMBER("Concurrent Memory Pool");
+
+            // Remove the entry of this pool from the threads still alive, so that their maps don't keep dangling caches
+            for (const auto& threadCaches : users)
+            {
+                if (auto owner = threadCaches.lock())
+                {
+                    std::lock_guard<std::mutex> lock(owner->mutex);
+
+                    owner->caches.erase(id);
+                }
+            }
+
+            for (Chunk<T>* block : blocks)
+                delete[] block;
+        }
+
+        /**
+         * @brief Function used to allocate a new T object, can be called from any thread
+         * 
+         * @see release
+         */
+        template <typename... Args>
+        T* allocate(Args&&... args)
+        {
+            auto& cache = localCache();
+
+            if (cache.chunks.empty())
+                refill(cache, CacheSize);
+
+            auto chunk = cache.chunks.back();
+            cache.chunks.pop_back();
+
+            cache.nbElements.store(cache.nbElements.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            return ::new(&(chunk->element)) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Allocate multiple T objects at once, the depot is hit at most once for the whole batch
+         * 
+         * @param nbObjects Number of objects to create
+         * @param out Array receiving the pointers to the new objects, must hold at least nbObjects pointers
+         * @param args Argument used to construct each of the objects (copied for each of them)
+         */
+        template <typename... Args>
+        void allocateBulk(size_t nbObjects, T** out, const Args&... args)
+        {
+            auto& cache = localCache();
+
+            if (cache.chunks.size() < nbObjects)
+                refill(cache, nbObjects - cache.chunks.size() + CacheSize);
+
+            for (size_t i = 0; i < nbObjects; ++i)
+            {
+                auto chunk = cache.chunks.back();
+                cache.chunks.pop_back();
+
+                out[i] = ::new(&(chunk->element)) T(args...);
+            }
+
+            cache.nbElements.store(cache.nbElements.load(std::memory_order_relaxed) + nbObjects, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Release an object created using the pool, can be called from any thread
+         * 
+         * @see allocate
+         */
+        void release(T* pointer)
+        {
+            if (pointer == nullptr)
+                return;
+
+            pointer->~T();
+
+            auto& cache = localCache();
+
+            cache.chunks.push_back(reinterpret_cast<Chunk<T>*>(pointer));
+
+            cache.nbElements.store(cache.nbElements.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+            if (cache.chunks.size() >= 2 * CacheSize)
+                giveBack(cache, CacheSize);
+        }
+
+        /**
+         * @brief Release multiple objects created using the pool at once, null pointers are skipped
+         * 
+         * @see allocateBulk
+         */
+        void releaseBulk(T* const* pointers, size_t nbObjects)
+        {
+            auto& cache = localCache();
+
+            int64_t nbReleased = 0;
+
+            for (size_t i = 0; i < nbObjects; ++i)
+            {
+                auto pointer = pointers[i];
+
+                if (pointer == nullptr)
+                    continue;
+
+                pointer->~T();
+
+                cache.chunks.push_back(reinterpret_cast<Chunk<T>*>(pointer));
+
+                nbReleased++;
+            }
+
+            cache.nbElements.store(cache.nbElements.load(std::memory_order_relaxed) - nbReleased, std::memory_order_relaxed);
+
+            if (cache.chunks.size() >= 2 * CacheSize)
+                giveBack(cache, cache.chunks.size() - CacheSize);
+        }
+
+        /** Give back all the free chunks cached by the calling thread to the shared depot */
+        void flush()
+        {
+            auto& cache = localCache();
+
+            giveBack(cache, cache.chunks.size());
+        }
+
+        /**
+         * @brief Give back to the system the memory of the blocks whose chunks are all free in the depot
+         * 
+         * Chunks sitting in the cache of a thread are considered in use, flush the caches beforehand to reclaim them.
+         * 
+         * @return size_t The number of chunks freed
+         */
+        size_t shrink()
+        {
+            LOG_THIS_MEMBER("Concurrent Memory Pool");
+
+            std::lock_guard<std::mutex> lock(depotMutex);
+
+            if (blocks.empty())
+                return 0;
+
+            // All the blocks have the same size, so sorting them by address is enough to find the owner of a chunk
+            std::sort(blocks.begin(), blocks.end(), [](Chunk<T>* lhs, Chunk<T>* rhs) { return reinterpret_cast<uintptr_t>(lhs) < reinterpret_cast<uintptr_t>(rhs); });
+
+            const auto findBlock = [this](Chunk<T>* chunk) {
+                auto it = std::upper_bound(blocks.begin(), blocks.end(), reinterpret_cast<uintptr_t>(chunk), [](uintptr_t address, Chunk<T>* block) { return address < reinterpret_cast<uintptr_t>(block); });
+                return static_cast<size_t>(it - blocks.begin()) - 1;
+            };
+
+            std::vector<size_t> nbFreeChunks(blocks.size(), 0);
+
+            for (auto chunk : depot)
+                nbFreeChunks[findBlock(chunk)]++;
+
+            std::vector<bool> freedBlocks(blocks.size(), false);
+            size_t nbFreedBlocks = 0;
+
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                if (nbFreeChunks[i] == BLOCKSIZE)
+                {
+                    freedBlocks[i] = true;
+                    nbFreedBlocks++;
+                }
+            }
+
+            if (nbFreedBlocks == 0)
+                return 0;
+
+            depot.erase(std::remove_if(depot.begin(), depot.end(), [&](Chunk<T>* chunk) { return freedBlocks[findBlock(chunk)]; }), depot.end());
+
+            size_t keptIndex = 0;
+
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                if (freedBlocks[i])
+                    delete[] blocks[i];
+                else
+                    blocks[keptIndex++] = blocks[i];
+            }
+
+            blocks.resize(keptIndex);
+
+            LOG_MILE("Concurrent Memory Pool", "Shrinked the pool by " << nbFreedBlocks * BLOCKSIZE << " chunks, current size: " << blocks.size() * BLOCKSIZE);
+
+            return nbFreedBlocks * BLOCKSIZE;
+        }
+
+        /** Get the number of objects currently allocated in the pool */
+        size_t getNbElements() const
+        {
+            std::lock_guard<std::mutex> lock(depotMutex);
+
+            int64_t total = 0;
+
+            for (const auto& cache : caches)
+                total += cache->nbElements.load(std::memory_order_relaxed);
+
+            return static_cast<size_t>(total);
+        }
+
+        /** Get the number of chunks owned by the pool */
+        size_t getSize() const
+        {
+            std::lock_guard<std::mutex> lock(depotMutex);
+
+            return blocks.size() * BLOCKSIZE;
+        }
+
+        /** Get the number of live pools of this type holding a cache for the calling thread */
+        static size_t getNbThreadCaches()
+        {
+            const auto& threadCaches = currentThreadCaches();
+
+            std::lock_guard<std::mutex> lock(threadCaches->mutex);
+
+            return threadCaches->caches.size();
+        }
+
+    private:
+        /** Get the caches of the calling thread, the map lives as long as the thread or the last pool it used */
+        static const std::shared_ptr<ThreadCaches>& currentThreadCaches()
+        {
+            thread_local auto threadCaches = std::make_shared<ThreadCaches>();
+
+            return threadCaches;
+        }
+
+        /** Get the cache of the calling thread, created on the first use of the pool by the thread */
+        LocalCache& localCache()
+        {
+            // Ids are never reused so the last cache of a destroyed pool is never looked up again
+            thread_local uint64_t lastId = 0;
+            thread_local LocalCache* lastCache = nullptr;
+
+            if (lastId == id)
+                return *lastCache;
+
+            const auto& threadCaches = currentThreadCaches();
+
+            std::lock_guard<std::mutex> threadLock(threadCaches->mutex);
+
+            auto it = threadCaches->caches.find(id);
+
+            if (it == threadCaches->caches.end())
+            {
+                std::lock_guard<std::mutex> lock(depotMutex);
+
+                caches.push_back(std::make_unique<LocalCache>());
+                users.push_back(threadCaches);
+
+                it = threadCaches->caches.emplace(id, caches.back().get()).first;
+            }
+
+            lastId = id;
+            lastCache = it->second;
+
+            return *lastCache;
+        }
+
+        /** Move nbChunks free chunks from the depot to the cache, creating new blocks if needed */
+        void refill(LocalCache& cache, size_t nbChunks)
+        {
+            std::lock_guard<std::mutex> lock(depotMutex);
+
+            while (depot.size() < nbChunks)
+            {
+                auto block = new Chunk<T>[BLOCKSIZE];
+
+                blocks.push_back(block);
+
+                for (size_t i = BLOCKSIZE; i > 0; --i)
+                    depot.push_back(&block[i - 1]);
+            }
+
+            cache.chunks.insert(cache.chunks.end(), depot.end() - nbChunks, depot.end());
+            depot.resize(depot.size() - nbChunks);
+        }
+
+        /** Move the last nbChunks free chunks of the cache to the depot */
+        void giveBack(LocalCache& cache, size_t nbChunks)
+        {
+            std::lock_guard<std::mutex> lock(depotMutex);
+
+            depot.insert(depot.end(), cache.chunks.end() - nbChunks, cache.chunks.end());
+            cache.chunks.resize(cache.chunks.size() - nbChunks);
+        }
+
+        /** Generator of the pool ids, starts at 1 as 0 marks an empty thread cache lookup */
+        static inline std::atomic<uint64_t> nextId {1};
+
+        /** Unique id of this pool, used to find the cache of a thread */
+        const uint64_t id;
+
+        /** Guard the depot, the blocks and the list of caches */
+        mutable std::mutex depotMutex;
+
+        /** Free chunks shared by all the threads */
+        std::vector<Chunk<T>*> depot;
+
+        /** Blocks of chunks owned by the pool (used to free the memory) */
+        std::vector<Chunk<T>*> blocks;
+
+        /** Caches of all the threads that used this pool */
+        std::vector<std::unique_ptr<LocalCache>> caches;
+
+        /** Maps of the threads that used this pool, expired once the thread exited */
+        std::vector<std::weak_ptr<ThreadCaches>> users;
+    };
+
+    /**
+     * @brief Standard allocator handing out single objects from a process wide ConcurrentAllocatorPool
+     * 
+     * Meant to be used with std::allocate_shared for small objects created and destroyed by many threads at once
+     * (each thread allocates from its own cache instead of contending on the global heap).
+     * Requests for more than one object at a time fall back to the global operator new.
+     * 
+     * @tparam T Type of the object to allocate
+     */
+    template <typename T>
+    struct ConcurrentPoolAllocator
+    {
+        typedef T value_type;
+
+        ConcurrentPoolAllocator() noexcept {}
+
+        template <typename U>
+        ConcurrentPoolAllocator(const ConcurrentPoolAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n)
+        {
+            if (n != 1)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+
+            return reinterpret_cast<T*>(pool().allocate());
+        }
+
+        void deallocate(T* pointer, size_t n)
+        {
+            if (n != 1)
+                ::operator delete(pointer);
+            else
+                pool().release(reinterpret_cast<Storage*>(pointer));
+        }
+
+        template <typename U>
+        bool operator==(const ConcurrentPoolAllocator<U>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const ConcurrentPoolAllocator<U>&) const noexcept { return false; }
+
+    private:
+        /** Raw storage of a T, its empty constructor leaves the memory untouched */
+        struct Storage
+        {
+            Storage() {}
+
+            alignas(T) unsigned char data[sizeof(T)];
+        };
+
+        /** The pool is never destroyed, so objects released during the static destruction still have a valid pool */
+        static ConcurrentAllocatorPool<Storage>& pool()
+        {
+            static auto pool = new ConcurrentAllocatorPool<Storage>();
+
+            return *pool;
+        }
+    };
 }
@@ -1,43 +1,44 @@
 #include "parallelfor.h"
 
+#include <algorithm>
+
+#include <algorithm/for_each.hpp>
+
 namespace pg
 {
-    void parallelFor(const size_t& nb_elements, std::function<void (size_t start, size_t end)> functor, bool use_threads)
+    void parallelFor(tf::Executor& executor, size_t start, size_t end, size_t grain, const std::function<void(size_t start, size_t end)>& functor, size_t offset)
     {
-        // -------
-        unsigned nb_threads_hint = std::thread::hardware_concurrency();
-        unsigned nb_threads = nb_threads_hint == 0 ? 8 : (nb_threads_hint);
+        if (start >= end)
+            return;
 
-        size_t batch_size = nb_elements / nb_threads;
-        size_t batch_remainder = nb_elements % nb_threads;
+        if (grain == 0)
+            grain = 1;
 
-        std::vector< std::thread > my_threads(nb_threads);
+        // Shift the indexes so the chunk boundaries (offset + k * grain) land on multiples of grain
+        const size_t shift = (grain - offset % grain) % grain;
 
-        if( use_threads )
-        {
-            // Multithread execution
-            for(size_t i = 0; i < nb_threads; ++i)
-            {
-                size_t start = i * batch_size;
-                my_threads[i] = std::thread(functor, start, start+batch_size);
-            }
-        }
-        else
+        const size_t firstChunk = (start + shift) / grain;
+        const size_t nbChunks = (end - 1 + shift) / grain - firstChunk + 1;
+
+        if (nbChunks == 1 or executor.num_workers() <= 1)
         {
-            // Single thread execution (for easy debugging)
-            for(size_t i = 0; i < nb_threads; ++i){
-                size_t start = i * batch_size;
-                functor( start, start+batch_size );
-            }
+            functor(start, end);
+            return;
         }
 
-        // Deform the elements left
-        size_t start = nb_threads * batch_size;
-        functor( start, start+batch_remainder);
+        tf::Taskflow taskflow;
 
-        // Wait for the other thread to finish their task
-        if( use_threads )
-            std::for_each(my_threads.begin(), my_threads.end(), std::mem_fn(&std::thread::join));
-    }
+        taskflow.for_each_index(size_t(0), nbChunks, size_t(1), [&](size_t chunk) {
+            const size_t chunkStart = std::max(start + shift, (firstChunk + chunk) * grain) - shift;
+            const size_t chunkEnd = std::min(end + shift, (firstChunk + chunk + 1) * grain) - shift;
+
+            functor(chunkStart, chunkEnd);
+        });
 
-}
\ No newline at end of file
+        // A worker can't block on the executor it belongs to, so it helps running the chunks instead
+        if (executor.this_worker_id() >= 0)
+            executor.corun(taskflow);
+        else
+            executor.run(taskflow).wait();
+    }
+}
@@ -1,17 +1,72 @@
 #pragma once
 
-#include <algorithm>
-#include <thread>
 #include <functional>
-#include <vector>
+#include <cstdint>
+
+#include <taskflow.hpp>
 
 namespace pg
 {
+    /** Size of a cache line, chunks of parallel loops are aligned on it to avoid false sharing between workers */
+    constexpr size_t CACHELINESIZE = 64;
+
+    /**
+     * @brief Get the smallest number of consecutive elements of a given size that fill whole cache lines
+     * 
+     * @param elementSize Size of one element of the array to iterate over
+     * @return size_t The number of elements covering an integer number of cache lines
+     */
+    constexpr size_t elementsPerCacheLine(size_t elementSize)
+    {
+        size_t a = CACHELINESIZE, b = elementSize;
+
+        // Gcd of the cache line size and the element size
+        while (b != 0)
+        {
+            const auto r = a % b;
+            a = b;
+            b = r;
+        }
+
+        return CACHELINESIZE / a;
+    }
+
+    /**
+     * @brief Get the first index of an array whose element starts on a cache line
+     * 
+     * Nothing guarantees that an array is aligned on a cache line, so chunks of elementsPerCacheLine(elementSize) elements
+     * only cover whole cache lines if they start from this index.
+     * 
+     * @param base Address of the element at index 0 of the array
+     * @param elementSize Size of one element of the array
+     * @return size_t The index, 0 if no element of the array starts on a cache line
+     */
+    inline size_t firstCacheLineIndex(const void* base, size_t elementSize)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(base);
+
+        for (size_t i = 0; i < elementsPerCacheLine(elementSize); i++)
+        {
+            if ((address + i * elementSize) % CACHELINESIZE == 0)
+                return i;
+        }
+
+        return 0;
+    }
+
     /**
-     * @param[in] nb_elements : size of your for loop
-     * @param[in] functor(start, end): Your function processing a sub chunk of the for loop.
-     * @param use_threads : enable / disable threads.
-     * "start" is the first index to process (included) until the index "end" (excluded)
+     * @brief Run a for loop in chunks on the workers of an executor
+     * 
+     * @param executor The executor running the chunks, no thread is created by this function
+     * @param start First index to process (included)
+     * @param end Last index to process (excluded)
+     * @param grain Number of elements per chunk
+     * @param functor(start, end) Your function processing a sub chunk of the for loop from "start" (included) to "end" (excluded)
+     * @param offset Chunks are cut at the indexes offset + k * grain, see firstCacheLineIndex
+     * 
+     * This function returns once all the chunks are processed. When called from one of the workers of the executor
+     * (inside of a system for example) the calling worker takes part in the loop instead of blocking.
+     * If the range fits in a single chunk, the functor is run directly on the calling thread.
      */
-    void parallelFor(const size_t& nb_elements, std::function<void (size_t start, size_t end)> functor, bool use_threads = true);
-}
\ No newline at end of file
+    void parallelFor(tf::Executor& executor, size_t start, size_t end, size_t grain, const std::function<void(size_t start, size_t end)>& functor, size_t offset = 0);
+}
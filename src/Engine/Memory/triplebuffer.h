@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * @file triplebuffer.h
+ * @brief Definition of a lock free triple buffer to hand over frames from one thread to another
+ *
+ */
+
+#include <atomic>
+#include <cstdint>
+
+namespace pg
+{
+    /**
+     * @brief Wait free hand over of the latest value produced by one thread to one consumer thread
+     *
+     * The producer fills the back buffer and publishes it, the consumer acquires the latest published buffer.
+     * Neither side ever waits for the other: the producer never drops a frame because the consumer is busy
+     * (an unread frame is simply replaced by the newer one) and the consumer keeps reading its front buffer until a new frame is available.
+     *
+     * The buffers are reused from one frame to the other, so a value holding containers keeps their capacity.
+     *
+     * @tparam T Type of the value exchanged, must be default constructible
+     *
+     * @warning Only one thread may produce and only one thread may consume
+     */
+    template <typename T>
+    class TripleBuffer
+    {
+        /** Flag set in the middle index when it holds a frame that the consumer didn't acquire yet */
+        static constexpr uint8_t FRESHBIT = 0b100;
+
+        static constexpr uint8_t INDEXMASK = 0b011;
+
+    public:
+        TripleBuffer() {}
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /** Get the buffer the producer is writing to, its content is the one of an older frame */
+        inline T& back() { return buffers[backIndex]; }
+
+        /** Make the back buffer available to the consumer, the producer gets a new back buffer */
+        void publish()
+        {
+            const auto previous = middle.exchange(backIndex | FRESHBIT, std::memory_order_acq_rel);
+
+            backIndex = previous & INDEXMASK;
+
+            nbPublished.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Swap the front buffer with the latest published frame, if any
+         *
+         * @return true If a new frame was published since the last call
+         */
+        bool acquire()
+        {
+            if ((middle.load(std::memory_order_relaxed) & FRESHBIT) == 0)
+                return false;
+
+            const auto previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+
+            frontIndex = previous & INDEXMASK;
+
+            return true;
+        }
+
+        /** Get the buffer the consumer is reading, it stays untouched until the next acquire */
+        inline const T& front() const { return buffers[frontIndex]; }
+
+        /** Check if a frame was published and not acquired yet */
+        inline bool hasNewFrame() const { return (middle.load(std::memory_order_relaxed) & FRESHBIT) != 0; }
+
+        /** Number of frames published since the creation of the buffer */
+        inline uint64_t getNbPublished() const { return nbPublished.load(std::memory_order_relaxed); }
+
+    private:
+        T buffers[3];
+
+        /** Index of the buffer owned by the producer */
+        uint8_t backIndex = 0;
+
+        /** Index of the buffer waiting to be acquired, with FRESHBIT set when it holds a new frame */
+        std::atomic<uint8_t> middle {1};
+
+        /** Index of the buffer owned by the consumer */
+        uint8_t frontIndex = 2;
+
+        std::atomic<uint64_t> nbPublished {0};
+    };
+}
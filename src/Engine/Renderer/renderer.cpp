@@ -94,25 +94,6 @@ namespace pg
         // Todo Fix in group and ecs ! ( whereaver we are holding pointer of a comp actually ! )
         // Todo hold a ref to the component list and the component index inside of this list instead of the raw pointer to not get invalidated on resize !
 
-        // inSwap = true;
-
-        // {
-        //     std::unique_lock lk(renderMutex);
-        //     execCv.notify_all();
-            
-        //     renderCv.wait(lk, [this]{ return inBetweenRender.load();});
-        // }
-
-        // for (auto renderer : renderers)
-        // {
-        //     renderer->updateMeshes();
-        // }
-
-        if (inSwap)
-        {
-            return;
-        }
-
         if (newMaterialRegistered)
         {
             return;
@@ -151,79 +132,200 @@ namespace pg
             return;
         }
 
-        auto tempRenderList = currentRenderList == 0 ? 1 : 0;
+        // A new renderer has no place in the render queue yet
+        bool rebuild = seenRenderVersions.size() != renderers.size();
+        bool updated = rebuild;
+
+        for (size_t i = 0; i < seenRenderVersions.size(); ++i)
+        {
+            const auto renderer = renderers[i];
+
+            if (renderer->renderVersion == seenRenderVersions[i])
+                continue;
+
+            updated = true;
+
+            if (renderer->rebuilt)
+                rebuild = true;
+        }
+
+        // Nothing changed since the last frame: the render thread keeps drawing the one it already has
+        if (not updated)
+            return;
+
+        queueVersion++;
+
+        // Only the data of some calls changed, copy it in place in the render queue without sorting nor batching again
+        if (not rebuild)
+        {
+            for (size_t i = 0; i < renderers.size() and not rebuild; ++i)
+            {
+                if (renderers[i]->renderVersion == seenRenderVersions[i])
+                    continue;
+
+                for (auto index : renderers[i]->updatedCalls)
+                {
+                    if (not patchRenderQueue(i, index))
+                    {
+                        rebuild = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (rebuild)
+            rebuildRenderQueue();
+
+        seenRenderVersions.resize(renderers.size());
+
+        for (size_t i = 0; i < renderers.size(); ++i)
+        {
+            auto renderer = renderers[i];
+
+            renderer->rebuilt = false;
+            renderer->updatedCalls.clear();
 
-        // auto start = std::chrono::steady_clock::now();
+            seenRenderVersions[i] = renderer->renderVersion;
+        }
+
+        // The back frame is never read by the render thread, so it can be written without waiting for it
+        auto& frame = renderFrames.back();
 
-        renderCallList[tempRenderList].clear();
+        auto& renderList = frame.renderCalls;
 
-        for (auto renderer : renderers)
+        if (frame.version < queueRebuildVersion or frame.version + MAXPATCHVERSIONS < queueVersion)
         {
-            const auto& calls = renderer->getRenderCalls();
+            // The layout of the queue changed or the patches missed by this frame are gone, copy all the calls
+            // over the ones of a previous frame, so the data buffers keep their capacity from one frame to the other
+            for (size_t i = 0; i < nbQueuedCalls; ++i)
+            {
+                if (i < renderList.size())
+                    renderList[i] = renderQueue[i];
+                else
+                    renderList.push_back(renderQueue[i]);
 
-            renderCallList[tempRenderList].insert(renderCallList[tempRenderList].end(), calls.begin(), calls.end());
+                nbCopiedValues += renderQueue[i].data.size();
+            }
         }
+        else
+        {
+            // Same layout as the queue, only replay the patches made since this frame was last filled
+            for (const auto& patch : queuePatches)
+            {
+                if (patch.version <= frame.version)
+                    continue;
+
+                const auto source = renderQueue[patch.queueIndex].data.begin() + patch.offset;
 
-        std::sort(renderCallList[tempRenderList].begin(), renderCallList[tempRenderList].end());
+                std::copy(source, source + patch.size, renderList[patch.queueIndex].data.begin() + patch.offset);
+
+                nbCopiedValues += patch.size;
+            }
+        }
+
+        frame.nbRenderCalls = nbQueuedCalls;
+        frame.version = queueVersion;
+
+        // Every frame older than the kept versions gets a full copy anyway
+        queuePatches.erase(std::remove_if(queuePatches.begin(), queuePatches.end(), [this](const QueuePatch& patch) {
+            return patch.version + MAXPATCHVERSIONS <= queueVersion;
+        }), queuePatches.end());
+
+        nbGeneratedFrames++;
+
+        // Hand the frame over to the render thread, replacing the previous one if it wasn't drawn yet
+        renderFrames.publish();
+    }
+
+    void MasterRenderer::rebuildRenderQueue()
+    {
+        // Sort references to the calls instead of the calls themselves, to not copy their data twice
+        sortedCalls.clear();
+
+        queueLocations.resize(renderers.size());
+
+        for (size_t i = 0; i < renderers.size(); ++i)
+        {
+            const auto nbCalls = renderers[i]->renderCallList.size();
+
+            queueLocations[i].resize(nbCalls);
+
+            for (size_t j = 0; j < nbCalls; ++j)
+                sortedCalls.emplace_back(i, j);
+        }
+
+        std::sort(sortedCalls.begin(), sortedCalls.end(), [this](const std::pair<size_t, size_t>& lhs, const std::pair<size_t, size_t>& rhs) {
+            return renderers[lhs.first]->renderCallList[lhs.second] < renderers[rhs.first]->renderCallList[rhs.second];
+        });
+
+        size_t nbCalls = 0;
 
         // This loop batch all the same render call together
-        if (renderCallList[tempRenderList].size() > 2)
+        for (const auto& ref : sortedCalls)
         {
-            std::vector<RenderCall> tempRenderCallList;
-        
-            RenderCall currentRenderCall = renderCallList[tempRenderList][0];
+            const auto& call = renderers[ref.first]->renderCallList[ref.second];
+            auto& location = queueLocations[ref.first][ref.second];
+
+            location.key = call.key;
+            location.batchable = call.batchable;
+            location.size = call.data.size();
 
-            for (size_t i = 1; i < renderCallList[tempRenderList].size(); ++i)
+            if (nbCalls > 0)
             {
-                const auto& call = renderCallList[tempRenderList][i];
+                auto& currentRenderCall = renderQueue[nbCalls - 1];
 
                 if (currentRenderCall.batchable and call.key == currentRenderCall.key and call.state == currentRenderCall.state)
                 {
+                    location.queueIndex = nbCalls - 1;
+                    location.offset = currentRenderCall.data.size();
+
                     currentRenderCall.data.insert(currentRenderCall.data.end(), call.data.begin(), call.data.end());
-                }
-                else
-                {
-                    tempRenderCallList.push_back(currentRenderCall);
 
-                    currentRenderCall = call;
+                    continue;
                 }
             }
 
-            tempRenderCallList.push_back(currentRenderCall);
+            // Copy over the calls of the previous rebuild, so the data buffers keep their capacity
+            if (nbCalls < renderQueue.size())
+                renderQueue[nbCalls] = call;
+            else
+                renderQueue.push_back(call);
+
+            location.queueIndex = nbCalls;
+            location.offset = 0;
 
-            // Todo fix this auto batching make things worse, this takes a lot of cycles !
-            renderCallList[tempRenderList].swap(tempRenderCallList);
+            nbCalls++;
         }
 
-        nbGeneratedFrames++;
+        nbQueuedCalls = nbCalls;
 
-        // for ()
+        // The calls moved, the frames can't be patched anymore
+        queueRebuildVersion = queueVersion;
+        queuePatches.clear();
+    }
 
-        // LOG_INFO(DOM, "Render call list size: " << renderCallList[tempRenderList].size());
+    bool MasterRenderer::patchRenderQueue(size_t rendererIndex, size_t callIndex)
+    {
+        const auto& calls = renderers[rendererIndex]->renderCallList;
 
-        inSwap = true;
+        if (rendererIndex >= queueLocations.size() or callIndex >= queueLocations[rendererIndex].size() or callIndex >= calls.size())
+            return false;
 
-        // auto end = std::chrono::steady_clock::now();
+        const auto& call = calls[callIndex];
+        const auto& location = queueLocations[rendererIndex][callIndex];
 
-        // {
-        //     std::unique_lock lk(renderMutex);
+        auto& queuedCall = renderQueue[location.queueIndex];
 
-        //     currentRenderList = tempRenderList;
-        // }
+        // A new key or state moves the call in the queue and a new size shifts the other calls of its batch
+        if (call.key != location.key or call.batchable != location.batchable or call.data.size() != location.size or call.state != queuedCall.state)
+            return false;
 
-        // std::cout << "System Renderer execute took: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns" << std::endl;
+        std::copy(call.data.begin(), call.data.end(), queuedCall.data.begin() + location.offset);
 
-        // inSwap = true;
+        queuePatches.push_back(QueuePatch{queueVersion, location.queueIndex, location.offset, call.data.size()});
 
-        // {
-        //     std::unique_lock lk(renderMutex);
-            
-        //     renderCv.wait(lk, [this]{ return not inSwap.load();});
-        // }
-        
-        // inSwap = false;
-
-        // execCv.notify_all();
+        return true;
     }
 
     void MasterRenderer::processTextureRegister()
@@ -250,24 +352,31 @@ namespace pg
 
     void MasterRenderer::renderAll()
     {
+        auto profiler = ecsRef->getProfiler();
+
+        // The name is registered on the first frame as the ecs is only known once the system is created
+        if (renderAllProfileId == UINT32_MAX)
+            renderAllProfileId = profiler->registerName("Render All");
+
+        ProfileScope scope(*profiler, renderAllProfileId);
+
         // Todo Clear screen here
 
         processTextureRegister();
 
-        for (const auto& call : renderCallList[currentRenderList])
-        {
-            processRenderCall(call);
-        }
+        // Draw the latest frame generated by the ecs, or the last one again if none was generated since
+        const auto& frame = acquireFrame();
 
-        nbRenderedFrames++;
+        // Materials can map a uniform to this parameter to interpolate between the last two ticks of a rate limited ecs
+        systemParameters["InterpolationAlpha"] = ecsRef->getInterpolationAlpha();
 
-        if (inSwap)
+        for (size_t i = 0; i < frame.nbRenderCalls; ++i)
         {
-            currentRenderList = currentRenderList == 0 ? 1 : 0;
-
-            inSwap = false;
+            processRenderCall(frame.renderCalls[i]);
         }
 
+        nbRenderedFrames++;
+
         if (newMaterialRegistered)
         {
             std::swap(materialListTemp, materialList);
@@ -545,5 +654,6 @@ namespace pg
         systemParameters["ScreenWidth"] = 1.0f;
         systemParameters["ScreenHeight"] = 1.0f;
         systemParameters["CurrentTime"] = 1;
+        systemParameters["InterpolationAlpha"] = 1.0f;
     }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <cstdarg>
 
 #include "ECS/entitysystem.h"
+#include "Memory/triplebuffer.h"
 
 #include "Input/inputcomponent.h"
 
@@ -258,6 +259,7 @@ namespace pg
 
     class BaseAbstractRenderer
     {
+    friend class MasterRenderer;
     public:
         BaseAbstractRenderer(MasterRenderer* masterRenderer, const RenderStage& stage);
         virtual ~BaseAbstractRenderer() {}
@@ -266,7 +268,134 @@ namespace pg
 
         const std::vector<RenderCall>& getRenderCalls() const { return renderCallList; }
 
+        /** Version of renderCallList, increased on each rebuild or update of a call */
+        inline uint64_t getRenderVersion() const { return renderVersion; }
+
     protected:
+        /** Signal to the master renderer that the whole renderCallList changed */
+        inline void notifyRebuilt()
+        {
+            renderVersion++;
+            rebuilt = true;
+            updatedCalls.clear();
+        }
+
+        /** Signal to the master renderer that the call at index of renderCallList was updated in place */
+        inline void notifyUpdated(size_t index)
+        {
+            renderVersion++;
+
+            // Already covered by the rebuild
+            if (not rebuilt)
+                updatedCalls.push_back(index);
+        }
+
+        /**
+         * @brief Keep renderCallList in sync with a set of components each holding a render call (in a member named call)
+         * 
+         * renderCallList follows the dense order of the set, so only the calls changed since the last sync are copied
+         * (see ComponentSet::markChanged) and notified to the master renderer. The whole list is rebuilt when
+         * the flag changed is set, when the size of the set changed or when components moved in the set since the last sync
+         * (a removal moves the last component in the slot of the removed one without changing its version).
+         * 
+         * @tparam RenderCallComp Type of the components holding the render calls
+         * @param renderCallView View of the components holding the render calls
+         */
+        template <typename RenderCallComp>
+        void syncRenderCalls(const typename ComponentSet<RenderCallComp>::ComponentSetList& renderCallView)
+        {
+            const auto version = renderCallView.getVersion();
+
+            if (changed or renderCallList.size() + 1 != renderCallView.nbComponents() or renderCallView.getLayoutVersion() > lastCallVersion)
+            {
+                renderCallList.clear();
+
+                renderCallList.reserve(renderCallView.nbComponents());
+
+                for (const auto& renderCall : renderCallView)
+                {
+                    renderCallList.push_back(renderCall->call);
+                }
+
+                changed = false;
+
+                notifyRebuilt();
+            }
+            else if (version != lastCallVersion)
+            {
+                for (const auto& updated : renderCallView.changedSince(lastCallVersion))
+                {
+                    renderCallList[updated.index - 1] = updated.component->call;
+
+                    notifyUpdated(updated.index - 1);
+                }
+            }
+
+            lastCallVersion = version;
+        }
+
+        /**
+         * @brief Same as syncRenderCalls for components holding a variable number of render calls (in a member named calls)
+         * 
+         * The calls of each component take a contiguous range of renderCallList, in the dense order of the set.
+         * A changed component keeping the same number of calls is copied in its range, if its number of calls changed
+         * the whole list is rebuilt.
+         * 
+         * @tparam RenderCallComp Type of the components holding the render calls
+         * @param renderCallView View of the components holding the render calls
+         */
+        template <typename RenderCallComp>
+        void syncRenderCallRanges(const typename ComponentSet<RenderCallComp>::ComponentSetList& renderCallView)
+        {
+            const auto version = renderCallView.getVersion();
+
+            bool rebuild = changed or callRanges.size() != renderCallView.nbComponents() or renderCallView.getLayoutVersion() > lastCallVersion;
+
+            if (not rebuild and version != lastCallVersion)
+            {
+                for (const auto& updated : renderCallView.changedSince(lastCallVersion))
+                {
+                    const auto start = callRanges[updated.index - 1];
+                    const auto& calls = updated.component->calls;
+
+                    // The calls of the next components would have to move
+                    if (callRanges[updated.index] - start != calls.size())
+                    {
+                        rebuild = true;
+                        break;
+                    }
+
+                    for (size_t i = 0; i < calls.size(); i++)
+                    {
+                        renderCallList[start + i] = calls[i];
+
+                        notifyUpdated(start + i);
+                    }
+                }
+            }
+
+            if (rebuild)
+            {
+                renderCallList.clear();
+
+                callRanges.clear();
+                callRanges.push_back(0);
+
+                for (const auto& renderCall : renderCallView)
+                {
+                    renderCallList.insert(renderCallList.end(), renderCall->calls.begin(), renderCall->calls.end());
+
+                    callRanges.push_back(renderCallList.size());
+                }
+
+                changed = false;
+
+                notifyRebuilt();
+            }
+
+            lastCallVersion = version;
+        }
+
         MasterRenderer *masterRenderer;
 
         std::vector<RenderCall> renderCallList;
@@ -274,6 +403,21 @@ namespace pg
         RenderStage renderStage;
 
         bool changed = true;
+
+    private:
+        uint64_t renderVersion = 0;
+
+        /** Version of the set of render call components at the last syncRenderCalls */
+        uint64_t lastCallVersion = 0;
+
+        /** The calls of the component at dense index i are in [callRanges[i - 1], callRanges[i]) of renderCallList, see syncRenderCallRanges */
+        std::vector<size_t> callRanges;
+
+        /** True if the whole renderCallList changed since the master renderer last read it */
+        bool rebuilt = true;
+
+        /** Indices of the calls updated in place since the master renderer last read them */
+        std::vector<size_t> updatedCalls;
     };
 
     class AbstractRenderer : public BaseAbstractRenderer
@@ -545,15 +689,43 @@ namespace pg
 
         inline size_t getNbGeneratedFrames() const { return nbGeneratedFrames; }
 
+        /** Sorted and batched render calls of all the renderers, only the first getNbQueuedCalls() are valid */
+        inline const std::vector<RenderCall>& getRenderQueue() const { return renderQueue; }
+
+        inline size_t getNbQueuedCalls() const { return nbQueuedCalls; }
+
         inline size_t getNbRenderedFrames() const { return nbRenderedFrames; }
 
+        /** Number of floats of render call data copied in the frames handed to the render thread since the creation of the renderer */
+        inline size_t getNbCopiedValues() const { return nbCopiedValues; }
+
+        /** Render calls of a frame, the elements past nbRenderCalls are kept so their data buffers can be reused */
+        struct RenderFrame
+        {
+            std::vector<RenderCall> renderCalls;
+
+            /** Number of valid render calls in renderCalls */
+            size_t nbRenderCalls = 0;
+
+            /** Version of the render queue copied in this frame, 0 if the frame was never filled */
+            uint64_t version = 0;
+        };
+
+        /**
+         * @brief Get the latest frame generated for the render thread, or the last one again if none was generated since
+         * 
+         * @warning Only the render thread may call this
+         */
+        inline const RenderFrame& acquireFrame()
+        {
+            renderFrames.acquire();
+
+            return renderFrames.front();
+        }
+
     private:
-        std::atomic<bool> inSwap {false};
-        std::atomic<bool> newMaterialRegistered {false};
-        // std::atomic<bool> inBetweenRender {true};
 
-        // std::condition_variable execCv;
-        // std::condition_variable renderCv;
+        std::atomic<bool> newMaterialRegistered {false};
 
         mutable std::mutex materialRegisterMutex;
         std::vector<MaterialHolder> materialRegisterQueue;
@@ -565,6 +737,16 @@ namespace pg
     private:
         void initializeParameters();
 
+        /** Sort and batch all the calls of the renderers in the render queue, recording where each call lands */
+        void rebuildRenderQueue();
+
+        /**
+         * @brief Copy the data of an updated call of a renderer in its batch of the render queue
+         * 
+         * @return false If the call can't be patched in place (its key, state or size changed) and the queue must be rebuilt
+         */
+        bool patchRenderQueue(size_t rendererIndex, size_t callIndex);
+
         void setState(const OpenGLState& state);
 
         void processRenderCall(const RenderCall& call);
@@ -588,14 +770,73 @@ namespace pg
 
         Camera camera;
 
-        std::vector<RenderCall> renderCallList[2];
+        /** Render calls generated by the ecs thread and drawn by the render thread */
+        TripleBuffer<RenderFrame> renderFrames;
+
+        /** Position of a call of a renderer in the render queue */
+        struct QueueLocation
+        {
+            /** Index of the batch holding the call */
+            size_t queueIndex = 0;
+
+            /** Offset of the data of the call in the data of the batch */
+            size_t offset = 0;
+
+            /** Key, batchable flag and data size of the call when it was queued, the call can only be patched if they are unchanged */
+            uint64_t key = 0;
+            bool batchable = true;
+            size_t size = 0;
+        };
+
+        /** A range of the data of a batch of the render queue that got patched */
+        struct QueuePatch
+        {
+            /** Version of the render queue that holds this patch */
+            uint64_t version;
+
+            size_t queueIndex;
+            size_t offset;
+            size_t size;
+        };
+
+        /** Number of versions of the render queue whose patches are kept, a frame older than that is copied whole */
+        static constexpr uint64_t MAXPATCHVERSIONS = 8;
 
-        std::atomic<uint8_t> currentRenderList {0};
+        /** Sorted and batched render calls, kept from one frame to the other. The elements past nbQueuedCalls keep their buffers */
+        std::vector<RenderCall> renderQueue;
+
+        /** Increased on each update of the render queue */
+        uint64_t queueVersion = 0;
+
+        /** Version of the last rebuild of the render queue, a frame filled before it is copied whole */
+        uint64_t queueRebuildVersion = 0;
+
+        /**
+         * Patches of the last MAXPATCHVERSIONS versions of the render queue.
+         * The three frames of the triple buffer are at different versions, each one gets the patches it missed replayed on it.
+         */
+        std::vector<QueuePatch> queuePatches;
+
+        size_t nbCopiedValues = 0;
+
+        size_t nbQueuedCalls = 0;
+
+        /** Location in the render queue of each call of each renderer, indexed like renderers */
+        std::vector<std::vector<QueueLocation>> queueLocations;
+
+        /** Version of each renderer at the last update of the render queue */
+        std::vector<uint64_t> seenRenderVersions;
+
+        /** Calls of all the renderers as (renderer index, call index), sorted by key during a rebuild */
+        std::vector<std::pair<size_t, size_t>> sortedCalls;
 
         std::unordered_map<std::string, LoadedAtlas> atlasMap;
 
         size_t nbGeneratedFrames = 0;
 
+        /** Profiler name id of renderAll */
+        uint32_t renderAllProfileId = UINT32_MAX;
+
         size_t nbRenderedFrames = 0;
 
         std::vector<BaseAbstractRenderer*> renderers;
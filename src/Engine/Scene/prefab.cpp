@@ -0,0 +1,210 @@
+#include "prefab.h"
+
+#include <map>
+
+#include "Files/filemanager.h"
+
+namespace pg
+{
+    namespace
+    {
+        static constexpr char const * DOM = "Prefab";
+
+        /** Name of the object holding the prefab in a baked file */
+        static constexpr char const * PREFABOBJECT = "prefab";
+
+        /** Entities of a scene with their components grouped by type, as written in a baked file */
+        struct PrefabData
+        {
+            inline static std::string getType() { return "Prefab"; }
+
+            size_t nbEntities = 0;
+
+            /** Components of each type, with the index of their entity */
+            std::map<std::string, std::vector<std::pair<size_t, UnserializedObject>>> components;
+        };
+    }
+
+    template <>
+    void serialize(Archive& archive, const PrefabData& value)
+    {
+        LOG_THIS(DOM);
+
+        archive.startSerialization(PrefabData::getType());
+
+        serialize(archive, "nbEntities", value.nbEntities);
+        serialize(archive, "nbTypes", value.components.size());
+
+        size_t i = 0;
+
+        for (const auto& type : value.components)
+        {
+            archive.setValueName("type" + std::to_string(i));
+
+            archive.startSerialization(type.first);
+
+            serialize(archive, "nbComponents", type.second.size());
+
+            size_t j = 0;
+
+            for (const auto& component : type.second)
+            {
+                auto str = std::to_string(j);
+
+                serialize(archive, "entity" + str, component.first);
+                serialize(archive, "component" + str, component.second);
+
+                ++j;
+            }
+
+            archive.endSerialization();
+
+            ++i;
+        }
+
+        archive.endSerialization();
+    }
+
+    std::string Prefab::bake(const ParsedScene& scene)
+    {
+        LOG_THIS(DOM);
+
+        PrefabData data;
+
+        data.nbEntities = scene.entities.size();
+
+        for (size_t i = 0; i < scene.entities.size(); ++i)
+        {
+            const auto& entity = scene.entities[i];
+
+            UnserializedObject serializedEntity(entity.data, entity.id);
+
+            if (serializedEntity.isNull())
+            {
+                LOG_ERROR(DOM, "Entity " << entity.id << " is null");
+                continue;
+            }
+
+            for (const auto& component : serializedEntity.getChildren())
+            {
+                // Filter any attributes, as done when loading a scene
+                if (component.isNull() or not component.isClassObject())
+                    continue;
+
+                data.components[std::string(component.getObjectType())].emplace_back(i, component);
+            }
+        }
+
+        BinaryArchive archive;
+
+        serialize(archive, data);
+
+        return archive.str();
+    }
+
+    bool Prefab::bakeFile(const std::string& scenePath, const std::string& prefabPath)
+    {
+        LOG_THIS(DOM);
+
+        const auto scene = parseScene(scenePath);
+
+        if (scene.entities.empty())
+        {
+            LOG_ERROR(DOM, "Scene '" << scenePath << "' has no entity to bake");
+            return false;
+        }
+
+        // Same layout as a binary Serializer file holding a single object
+        const auto data = Serializer::writeBinaryData({{PREFABOBJECT, bake(scene)}});
+
+        return UniversalFileAccessor::replaceFile(TextFile{prefabPath, ""}, data, true);
+    }
+
+    std::shared_ptr<Prefab> Prefab::load(EntitySystem* ecs, const std::string& data)
+    {
+        LOG_THIS(DOM);
+
+        const auto object = UnserializedObject::fromBinary(data, PREFABOBJECT);
+
+        if (object.isNull())
+        {
+            LOG_ERROR(DOM, "Invalid prefab data");
+            return nullptr;
+        }
+
+        auto prefab = std::make_shared<Prefab>();
+
+        prefab->nbEntities = deserialize<size_t>(object["nbEntities"]);
+
+        const auto nbTypes = deserialize<size_t>(object["nbTypes"]);
+
+        for (size_t i = 0; i < nbTypes; ++i)
+        {
+            const auto& type = object["type" + std::to_string(i)];
+
+            // The type is resolved once for all its components
+            auto components = ecs->getComponentRegistry()->makePrefabComponents(std::string(type.getObjectType()));
+
+            if (not components)
+                continue;
+
+            size_t entityIndex = 0;
+
+            // The children are walked in order, an entity index is always followed by its component
+            for (const auto& child : type.getChildren())
+            {
+                const auto name = child.getObjectName();
+
+                if (name.rfind("entity", 0) == 0)
+                {
+                    entityIndex = deserialize<size_t>(child);
+
+                    if (entityIndex >= prefab->nbEntities)
+                    {
+                        LOG_ERROR(DOM, "Component of an unknown entity: " << entityIndex);
+                        return nullptr;
+                    }
+                }
+                else if (name.rfind("component", 0) == 0)
+                {
+                    components->add(child, entityIndex);
+                }
+            }
+
+            prefab->componentTypes.push_back(std::move(components));
+        }
+
+        return prefab;
+    }
+
+    std::shared_ptr<Prefab> Prefab::loadFile(EntitySystem* ecs, const std::string& path)
+    {
+        LOG_THIS(DOM);
+
+        const auto file = UniversalFileAccessor::openBinaryFile(path);
+
+        const auto objects = Serializer::readBinaryData(file.data);
+
+        const auto it = objects.find(PREFABOBJECT);
+
+        if (it == objects.end())
+        {
+            LOG_ERROR(DOM, "File '" << path << "' is not a baked prefab");
+            return nullptr;
+        }
+
+        return load(ecs, it->second);
+    }
+
+    std::vector<EntityRef> Prefab::instantiate(EntitySystem* ecs) const
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        auto entities = ecs->createEntities(nbEntities);
+
+        for (const auto& components : componentTypes)
+            components->instantiate(ecs, entities);
+
+        return entities;
+    }
+}
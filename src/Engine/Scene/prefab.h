@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "scenemanager.h"
+
+namespace pg
+{
+    /**
+     * @brief Compiled form of a scene, to instantiate its entities many times without parsing it again
+     * 
+     * A scene is baked offline (see the PgBake tool) into a binary file where the components are grouped by type,
+     * so the type of a component is resolved once per group instead of once per component.
+     * 
+     * Loading a prefab deserializes each component once; an instance is then only a batch of new entities
+     * and, for each component type, one bulk attach copying the components in the grown component set.
+     */
+    class Prefab
+    {
+    public:
+        /** Compile the entities of a parsed scene and of its subscenes in the binary prefab format */
+        static std::string bake(const ParsedScene& scene);
+
+        /** Bake a scene file in a prefab file */
+        static bool bakeFile(const std::string& scenePath, const std::string& prefabPath);
+
+        /**
+         * @brief Load a baked prefab
+         * 
+         * @param ecs Ecs whose systems own the component types of the prefab
+         * @param data Data returned by bake
+         * 
+         * @return The loaded prefab, null if the data is ill formed
+         */
+        static std::shared_ptr<Prefab> load(EntitySystem* ecs, const std::string& data);
+
+        static std::shared_ptr<Prefab> loadFile(EntitySystem* ecs, const std::string& path);
+
+        /** Create a new instance of the prefab, the returned entities are in the order of the baked scene */
+        std::vector<EntityRef> instantiate(EntitySystem* ecs) const;
+
+        inline size_t getNbEntities() const { return nbEntities; }
+
+        inline size_t getNbComponentTypes() const { return componentTypes.size(); }
+
+    private:
+        size_t nbEntities = 0;
+
+        std::vector<std::unique_ptr<AbstractPrefabComponents>> componentTypes;
+    };
+}
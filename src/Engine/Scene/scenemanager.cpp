@@ -1,5 +1,7 @@
 #include "scenemanager.h"
 
+#include "prefab.h"
+
 #include "Files/fileparser.h"
 
 #include "Interpreter/pginterpreter.h"
@@ -254,6 +256,52 @@ namespace pg
         return scene;
     }
 
+    /** Split the serialized entities of a scene and of its subscenes, numbering the scenes in depth first order */
+    void splitSceneEntities(const SceneFile& scene, std::vector<SceneEntityData>& entities, size_t& sceneIndex)
+    {
+        LOG_THIS(DOM);
+
+        const auto index = sceneIndex++;
+
+        for (const auto& data : scene.entityList)
+        {
+            // Todo remove the 1, it means that the indent is of 1 because of how we deserialize the scene, it will become obsolete when serializer don't need indent
+            for (auto& elem : Serializer::readData(scene.version, data, 1))
+            {
+                entities.push_back(SceneEntityData{index, elem.first, std::move(elem.second)});
+            }
+        }
+
+        for (const auto& subScene : scene.subScenes)
+        {
+            splitSceneEntities(subScene, entities, sceneIndex);
+        }
+    }
+
+    ParsedScene parseScene(const std::string& filepath)
+    {
+        ParsedScene parsed;
+
+        parsed.filename = filepath;
+        parsed.scene = parseSceneFile(filepath);
+
+        size_t sceneIndex = 0;
+
+        splitSceneEntities(parsed.scene, parsed.entities, sceneIndex);
+
+        return parsed;
+    }
+
+    void collectScenes(SceneFile& scene, std::vector<SceneFile*>& scenes)
+    {
+        scenes.push_back(&scene);
+
+        for (auto& subScene : scene.subScenes)
+        {
+            collectScenes(subScene, scenes);
+        }
+    }
+
     void SceneElementSystem::init()
     {
         // auto group = registerGroup<UiComponent, SceneElement>();
@@ -306,9 +354,38 @@ namespace pg
         if (not ecsRef)
             return;
 
-        sceneToLoad = event.filename;
+        // The latest request replaces the one still waiting
+        if (requestedSystemScene)
+        {
+            delete requestedSystemScene;
+            requestedSystemScene = nullptr;
+        }
+
+        requestedSceneName = event.filename;
+        requestedLoad = SceneToLoadFlag::FileScene;
+    }
+
+    void SceneElementSystem::startRequestedLoad()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        sceneToLoadFlag = requestedLoad;
+
+        if (requestedLoad == SceneToLoadFlag::FileScene)
+        {
+            sceneToLoad = requestedSceneName;
+        }
+        else
+        {
+            if (nextSystemScene)
+                delete nextSystemScene;
+
+            nextSystemScene = requestedSystemScene;
+            requestedSystemScene = nullptr;
+        }
+
+        requestedLoad = SceneToLoadFlag::None;
         loadingNewScene = true;
-        sceneToLoadFlag = SceneToLoadFlag::FileScene;
     }
 
     void SceneElementSystem::onEvent(const NameScene& event)
@@ -322,6 +399,88 @@ namespace pg
         namingSceneFlag = true;
     }
 
+    void SceneElementSystem::onEvent(const PrefetchScene& event)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        prefetchScene(event.filename);
+    }
+
+    void SceneElementSystem::prefetchScene(const std::string& filename)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (not ecsRef)
+            return;
+
+        if (findPrefetchedScene(filename) != prefetchedScenes.end())
+            return;
+
+        if (prefetchedScenes.size() >= MAXPREFETCHEDSCENES)
+        {
+            // Destroying the future of a parse still running would wait for it, so only a parsed scene can be dropped
+            auto it = std::find_if(prefetchedScenes.begin(), prefetchedScenes.end(), [](const std::pair<std::string, std::future<ParsedScene>>& prefetched) {
+                return prefetched.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            });
+
+            if (it == prefetchedScenes.end())
+            {
+                LOG_ERROR(DOM, "Too many scenes being prefetched, skipping the prefetch of: " << filename);
+                return;
+            }
+
+            LOG_INFO(DOM, "Dropping the prefetched scene: " << it->first);
+
+            prefetchedScenes.erase(it);
+        }
+
+        LOG_INFO(DOM, "Prefetching scene: " << filename);
+
+        prefetchedScenes.emplace_back(filename, std::async(std::launch::async, parseScene, filename));
+    }
+
+    std::vector<std::pair<std::string, std::future<ParsedScene>>>::iterator SceneElementSystem::findPrefetchedScene(const std::string& filename)
+    {
+        return std::find_if(prefetchedScenes.begin(), prefetchedScenes.end(), [&filename](const std::pair<std::string, std::future<ParsedScene>>& prefetched) {
+            return prefetched.first == filename;
+        });
+    }
+
+    void SceneElementSystem::setLoadingBudget(size_t maxEntities, std::chrono::microseconds maxTime)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        maxEntitiesPerFrame = maxEntities;
+        maxLoadingTimePerFrame = maxTime;
+    }
+
+    std::vector<EntityRef> SceneElementSystem::spawnPrefab(const std::string& filename)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (not ecsRef)
+            return {};
+
+        auto it = prefabs.find(filename);
+
+        if (it == prefabs.end())
+        {
+            auto prefab = Prefab::loadFile(ecsRef, filename);
+
+            if (not prefab)
+                return {};
+
+            it = prefabs.emplace(filename, prefab).first;
+        }
+
+        auto entities = it->second->instantiate(ecsRef);
+
+        // The instance belongs to the current scene and is unloaded with it
+        ecsRef->attachBulk<SceneElement>(entities, [](size_t) { return SceneElement{}; });
+
+        return entities;
+    }
+
     void SceneElementSystem::execute()
     {
         if (currentState != LoadingState::Idle)
@@ -335,6 +494,12 @@ namespace pg
             systemScene->execute();
         }
 
+        // A request made during a load only starts once that load is over, so the states never mix two loads
+        if (currentState == LoadingState::Idle and requestedLoad != SceneToLoadFlag::None)
+        {
+            startRequestedLoad();
+        }
+
         if (sceneToLoadFlag == SceneToLoadFlag::FileScene and currentState == LoadingState::OnEnter)
         {
             runEnterScript(nextScene);
@@ -397,15 +562,17 @@ namespace pg
                 systemScene = nullptr;
             }
 
-            sceneDeserialization(nextScene);
-
-            // If some subscene are present we skip another render pass to avoid jittering when the subscenes are being relocated in the frame
-            if (not nextScene.subScenes.empty())
+            // The entities are loaded in batches over multiple frames, so a big scene doesn't stall the frame
+            if (loadEntityBatch())
             {
-                ecsRef->sendEvent(SkipRenderPass{});
-            }
+                // If some subscene are present we skip another render pass to avoid jittering when the subscenes are being relocated in the frame
+                if (not nextScene.subScenes.empty())
+                {
+                    ecsRef->sendEvent(SkipRenderPass{});
+                }
 
-            currentState = LoadingState::SubSceneLoading;
+                currentState = LoadingState::SubSceneLoading;
+            }
         }
         else if (sceneToLoadFlag == SceneToLoadFlag::SystemScene and currentState == LoadingState::EntityLoading)
         {
@@ -456,11 +623,42 @@ namespace pg
 
             currentState = LoadingState::Parsing;
 
-            nextScene = parseSceneFile(sceneToLoad);
+            const auto it = findPrefetchedScene(sceneToLoad);
 
-            currentState = LoadingState::OnLeave;
+            // The file is parsed on a loader thread, the current scene keeps running until it is ready
+            if (it != prefetchedScenes.end())
+            {
+                parsingScene = std::move(it->second);
 
-            loadingNewScene = false;
+                prefetchedScenes.erase(it);
+            }
+            else
+            {
+                parsingScene = std::async(std::launch::async, parseScene, sceneToLoad);
+            }
+        }
+        else if (sceneToLoadFlag == SceneToLoadFlag::FileScene and currentState == LoadingState::Parsing)
+        {
+            if (parsingScene.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                auto parsed = parsingScene.get();
+
+                loadingSceneName = parsed.filename;
+
+                nextScene = parsed.scene;
+
+                pendingEntities = std::move(parsed.entities);
+                nbLoadedEntities = 0;
+
+                loadingScenes.clear();
+                collectScenes(nextScene, loadingScenes);
+
+                ecsRef->sendEvent(SceneLoadingProgress{loadingSceneName, 0, pendingEntities.size()});
+
+                currentState = LoadingState::OnLeave;
+
+                loadingNewScene = false;
+            }
         }
         else if (sceneToLoadFlag == SceneToLoadFlag::SystemScene and currentState == LoadingState::Idle and loadingNewScene)
         {
@@ -491,74 +689,86 @@ namespace pg
         }
     }
 
-    void SceneElementSystem::sceneDeserialization(SceneFile& sceneFile)
+    bool SceneElementSystem::loadEntityBatch()
     {
         LOG_THIS_MEMBER(DOM);
 
-        for (const auto& data : sceneFile.entityList)
+        const auto start = std::chrono::steady_clock::now();
+
+        size_t nbLoadedThisFrame = 0;
+
+        while (nbLoadedEntities < pendingEntities.size())
         {
-            LOG_INFO(DOM, "Entity data: " << data);
+            const auto& entity = pendingEntities[nbLoadedEntities];
 
-            // Todo remove the 1, it means that the indent is of 1 because of how we deserialize the scene, it will become obsolete when serializer don't need indent
-            auto serializedData = Serializer::readData(sceneFile.version, data, 1);
+            deserializeEntity(*loadingScenes[entity.sceneIndex], entity.id, entity.data);
 
-            deserializeData(sceneFile, serializedData);
-        }
+            ++nbLoadedEntities;
+            ++nbLoadedThisFrame;
 
-        for (auto& subScene : sceneFile.subScenes)
-        {
-            sceneDeserialization(subScene);
+            if (maxEntitiesPerFrame != 0 and nbLoadedThisFrame >= maxEntitiesPerFrame)
+                break;
+
+            if (maxLoadingTimePerFrame.count() != 0 and std::chrono::steady_clock::now() - start >= maxLoadingTimePerFrame)
+                break;
         }
+
+        LOG_INFO(DOM, "Loaded " << nbLoadedEntities << " / " << pendingEntities.size() << " entities");
+
+        ecsRef->sendEvent(SceneLoadingProgress{loadingSceneName, nbLoadedEntities, pendingEntities.size()});
+
+        if (nbLoadedEntities < pendingEntities.size())
+            return false;
+
+        pendingEntities.clear();
+        loadingScenes.clear();
+        idCorrelationMap.clear();
+
+        return true;
     }
 
-    void SceneElementSystem::deserializeData(SceneFile& sceneFile, const std::unordered_map<std::string, std::string>& serializedData)
+    void SceneElementSystem::deserializeEntity(SceneFile& sceneFile, const std::string& id, const std::string& data)
     {
         LOG_THIS_MEMBER(DOM);
 
-        std::unordered_map<_unique_id, _unique_id> idCorrelationMap;
+        LOG_INFO(DOM, data << " --- " << id);
 
-        LOG_INFO(DOM, "Serialized size: " << serializedData.size());
+        UnserializedObject serializedString(data, id);
 
-        for (const auto& elem : serializedData)
-        {
-            LOG_INFO(DOM, elem.second << " --- " << elem.first);
-            UnserializedObject serializedString(elem.second, elem.first);
+        auto newEntity = ecsRef->createEntity();
 
-            auto newEntity = ecsRef->createEntity();
+        sceneFile.instancedEntities.push_back(newEntity);
 
-            sceneFile.instancedEntities.push_back(newEntity);
+        ecsRef->attach<SceneElement>(newEntity);
 
-            ecsRef->attach<SceneElement>(newEntity);
+        _unique_id oldId;
+        std::istringstream iss(id);
+        iss >> oldId;
 
-            _unique_id oldId;
-            std::istringstream iss(elem.first);
-            iss >> oldId;
+        idCorrelationMap[oldId] = newEntity.id;
 
-            idCorrelationMap[oldId] = newEntity.id;
+        if (serializedString.isNull())
+        {
+            LOG_ERROR(DOM, "Element is null");
+        }
+        else
+        {
+            // Todo Loop over those ref id and correlate them to the correlation map and push them in the entity
+            // auto nbRefId = deserialize<size_t>(serializedString["nbRefId"]);
 
-            if (serializedString.isNull())
-            {
-                LOG_ERROR(DOM, "Element is null");
-            }
-            else
+            for (const auto& childStr : serializedString.getChildren())
             {
-                // Todo Loop over those ref id and correlate them to the correlation map and push them in the entity
-                // auto nbRefId = deserialize<size_t>(serializedString["nbRefId"]);
+                const auto& objType = childStr.getObjectType();
 
-                for (const auto& childStr : serializedString.children)
+                if (objType.find("idRef") != std::string::npos)
                 {
-                    const auto& objType = childStr.getObjectType();
-
-                    if (objType.find("idRef") != std::string::npos)
-                    {
-                        // Todo
-                    }
-                    else
-                    {
-                        // Filter any attributes
-                        if (childStr.isClassObject())
-                            ecsRef->deserializeComponent(newEntity, childStr);
-                    }
+                    // Todo
+                }
+                else
+                {
+                    // Filter any attributes
+                    if (childStr.isClassObject())
+                        ecsRef->deserializeComponent(newEntity, childStr);
                 }
             }
         }
@@ -2,6 +2,8 @@
 
 #include <sstream>
 #include <cstdint>
+#include <future>
+#include <chrono>
 
 #include "Input/inputcomponent.h"
 
@@ -21,6 +23,17 @@ namespace pg
 
     struct NewSceneLoaded {};
 
+    /** Start parsing a scene file in the background, so a later LoadScene of this file doesn't wait for it */
+    struct PrefetchScene { std::string filename; };
+
+    /** Progress of the file scene being loaded, sent after each batch of entities so a loading bar can follow it */
+    struct SceneLoadingProgress
+    {
+        std::string filename;
+        size_t nbLoaded;
+        size_t nbEntities;
+    };
+
     struct SceneElement : public Ctor
     {
         SceneElement() {}
@@ -148,8 +161,33 @@ namespace pg
     template <>
     SceneFile deserialize(const UnserializedObject& serializedString);
 
+    /** Serialized entity of a scene waiting to be instantiated */
+    struct SceneEntityData
+    {
+        /** Index of the scene holding the entity, the scene and its subscenes being numbered in depth first order */
+        size_t sceneIndex;
+
+        std::string id;
+        std::string data;
+    };
+
+    /** Scene file parsed off the ecs thread, with its entities already split and ready to be instantiated */
+    struct ParsedScene
+    {
+        std::string filename;
+
+        SceneFile scene;
+
+        std::vector<SceneEntityData> entities;
+    };
+
+    /** Parse a scene file and split its entities, it doesn't touch the ecs so it can run on another thread */
+    ParsedScene parseScene(const std::string& filepath);
+
+    class Prefab;
+
     struct SceneElementSystem : public System<
-        Listener<SceneElementClicked>, Listener<SaveScene>, Listener<LoadScene>, Listener<NameScene>,
+        Listener<SceneElementClicked>, Listener<SaveScene>, Listener<LoadScene>, Listener<NameScene>, Listener<PrefetchScene>,
         Own<SceneElement>, InitSys>
     {
         enum class LoadingState : uint8_t
@@ -188,29 +226,62 @@ namespace pg
 
         virtual void onEvent(const NameScene& event) override;
 
+        virtual void onEvent(const PrefetchScene& event) override;
+
+        /**
+         * @brief Start parsing a scene file on a loader thread, a later load of this file picks up the parsed scene
+         * 
+         * At most MAXPREFETCHEDSCENES scenes are kept, a new prefetch drops the oldest one already parsed.
+         * If all of them are still being parsed the prefetch is skipped, the load then parses the file itself.
+         */
+        void prefetchScene(const std::string& filename);
+
+        /** Maximum number of prefetched scenes waiting to be loaded */
+        static constexpr size_t MAXPREFETCHEDSCENES = 4;
+
+        /**
+         * @brief Set how much of a file scene can be instantiated in one frame
+         * 
+         * The loading of a frame stops as soon as one of the limits is reached, a limit of 0 disables it.
+         * At least one entity is loaded per frame whatever the budget.
+         */
+        void setLoadingBudget(size_t maxEntities, std::chrono::microseconds maxTime);
+
+        /**
+         * @brief Create an instance of a baked prefab in the current scene
+         * 
+         * The prefab file is only read the first time, the next instances reuse the loaded prefab.
+         * 
+         * @return The entities of the new instance, empty if the prefab couldn't be loaded
+         */
+        std::vector<EntityRef> spawnPrefab(const std::string& filename);
+
+        /** Ask for a system scene to be loaded, it starts once the load in progress (if any) is over */
         template <typename Type, typename... Args>
         void loadSystemScene(const Args&... args)
         {
             if (not ecsRef)
                 return;
 
-            if (loadingNewScene)
-                return;
+            // The latest request replaces the one still waiting
+            if (requestedSystemScene)
+                delete requestedSystemScene;
 
-            if (nextSystemScene)
-                delete nextSystemScene;
+            requestedSystemScene = new Type(args...);
 
-            nextSystemScene = new Type(args...);
-
-            sceneToLoadFlag = SceneToLoadFlag::SystemScene;
-            loadingNewScene = true;
+            requestedLoad = SceneToLoadFlag::SystemScene;
         }
 
         virtual void execute() override;
 
-        void sceneDeserialization(SceneFile& sceneFile);
+        /**
+         * @brief Instantiate the next entities of the scene being loaded within the budget of the frame
+         * 
+         * @return true Once all the entities of the scene and of its subscenes are loaded
+         */
+        bool loadEntityBatch();
 
-        void deserializeData(SceneFile& sceneFile, const std::unordered_map<std::string, std::string>& serializedData);
+        void deserializeEntity(SceneFile& sceneFile, const std::string& id, const std::string& data);
 
         void translateEntitiesInScene(const SceneFile& subScene, const UiFrame& originFrame);
 
@@ -218,6 +289,18 @@ namespace pg
 
         void runLeaveScript(const SceneFile& scene);
 
+        /** Start the load requested last, only called when no load is in progress */
+        void startRequestedLoad();
+
+        /** Get the prefetched scene of a file, or the end of prefetchedScenes if it was not prefetched */
+        std::vector<std::pair<std::string, std::future<ParsedScene>>>::iterator findPrefetchedScene(const std::string& filename);
+
+        /** Load asked for and not started yet, a scene loads over many frames so requests wait for the current load to be over */
+        SceneToLoadFlag requestedLoad = SceneToLoadFlag::None;
+        std::string requestedSceneName;
+        Scene* requestedSystemScene = nullptr;
+
+        /** Load in progress */
         bool loadingNewScene = false;
         SceneToLoadFlag sceneToLoadFlag = SceneToLoadFlag::None;
         SceneToLoadFlag currentLoadedScene = SceneToLoadFlag::None;        
@@ -228,6 +311,33 @@ namespace pg
         SceneFile currentScene;
         SceneFile nextScene;
 
+        /**
+         * Scene being parsed on a loader thread
+         * 
+         * The parsing doesn't run on the ecs executor, so a long parse never holds a worker needed by the systems.
+         */
+        std::future<ParsedScene> parsingScene;
+
+        /** Prefetched scenes, oldest first */
+        std::vector<std::pair<std::string, std::future<ParsedScene>>> prefetchedScenes;
+
+        std::string loadingSceneName;
+
+        /** Entities of the next scene, the first nbLoadedEntities ones are already instantiated */
+        std::vector<SceneEntityData> pendingEntities;
+        size_t nbLoadedEntities = 0;
+
+        /** The next scene and its subscenes in depth first order, as indexed by SceneEntityData::sceneIndex */
+        std::vector<SceneFile*> loadingScenes;
+
+        std::unordered_map<_unique_id, _unique_id> idCorrelationMap;
+
+        size_t maxEntitiesPerFrame = 0;
+        std::chrono::microseconds maxLoadingTimePerFrame {4000};
+
+        /** Prefabs already loaded, by file name */
+        std::unordered_map<std::string, std::shared_ptr<Prefab>> prefabs;
+
         Scene* systemScene = nullptr;
         Scene* nextSystemScene = nullptr;
 
@@ -74,6 +74,10 @@ namespace pg
             // firstTickTime = std::chrono::high_resolution_clock::now();
             firstTickTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
             secondTickTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+            // No need to check the clock more often than a tick, the reminder still catches the late ticks up
+            if (duration > 0)
+                setFixedRate(1000.0 / duration);
         }
 
         ~TickingSystem() { LOG_THIS_MEMBER("Ticking System"); stop(); }
@@ -166,6 +170,7 @@ namespace pg
         void start()
         {
             currentTime = 0;
+            nbTriggers = 0;
             running = true;
         }
 
@@ -180,10 +185,13 @@ namespace pg
 
         bool running = false;
 
+        /** Number of times the interval elapsed during the last update, the callback is called as many times */
+        size_t nbTriggers = 0;
+
         CallablePtr callback = nullptr;
     };
 
-    struct TimerSystem : public System<Own<Timer>, Listener<TickEvent>, NamedSystem>
+    struct TimerSystem : public System<Own<Timer>, Listener<TickEvent>, NamedSystem, OnEventPolicy>
     {
         virtual std::string getSystemName() const override { return "Timer System"; }
 
@@ -203,22 +211,31 @@ namespace pg
 
             const auto ecsRef = this->world();
 
-            for (const auto& timer : view<Timer>())
+            auto timers = view<Timer>();
+
+            // Advancing a timer only touches this timer, so the timers are advanced on all the workers
+            timers.parallelForEach([currentIncrementLoaded](Timer* timer) {
+                if (not timer->running or timer->interval == 0)
+                    return;
+
+                timer->currentTime += currentIncrementLoaded;
+
+                timer->nbTriggers = timer->currentTime / timer->interval;
+                timer->currentTime %= timer->interval;
+            });
+
+            // The callbacks run scripts and the interpreter is not thread safe, they are called afterwards in order
+            for (const auto& timer : timers)
             {
-                if (timer->running)
+                // A callback restarting its timer resets nbTriggers
+                while (timer->nbTriggers > 0)
                 {
-                    timer->currentTime += currentIncrementLoaded;
+                    timer->nbTriggers--;
 
-                    while (timer->currentTime >= timer->interval)
-                    {
-                        timer->currentTime -= timer->interval;
-
-                        if (timer->callback)
-                            timer->callback->call(ecsRef);
-                    }
+                    if (timer->callback)
+                        timer->callback->call(ecsRef);
                 }
             }
-
         }
 
         std::atomic<size_t> currentIncrement{0};
@@ -6,16 +6,12 @@ namespace pg
 {
     void OnEventComponent::onCreation(EntityRef entity)
     {
-        const auto& id = eventIdCallback(entity.ecsRef->registry);
-
-        entity.ecsRef->registry.addEventListener(entity, id, callback);
+        addCallback(entity.ecsRef->registry, entity);
     }
 
     void OnEventComponent::onDeletion(EntityRef entity)
     {
-        const auto& id = eventIdCallback(entity.ecsRef->registry);
-
-        entity.ecsRef->registry.removeEventListener(entity, id);
+        removeCallback(entity.ecsRef->registry, entity);
     }
 
     void OnStandardEventComponent::onCreation(EntityRef entity)
@@ -9,28 +9,32 @@ namespace pg
         template <typename Event>
         OnEventComponent(const std::function<void(const Event&)>& eventCallback)
         {
-            eventIdCallback = [](const ComponentRegistry& registry) -> _unique_id {
-                return registry.getTypeId<Event>();
+            std::function<void(const Event&)> callback = eventCallback;
+
+            addCallback = [callback](ComponentRegistry& registry, EntityRef entity) {
+                registry.addEntityEventListener<Event>(entity, callback);
             };
 
-            callback = [eventCallback](const std::any& event) {
-                eventCallback(std::any_cast<const Event&>(event));
+            removeCallback = [](ComponentRegistry& registry, EntityRef entity) {
+                registry.removeEntityEventListener<Event>(entity);
             };
         }
 
         template <typename Event>
         OnEventComponent(void(*eventCallback)(const Event&))
         {
-            eventIdCallback = [](const ComponentRegistry& registry) -> _unique_id {
-                return registry.getTypeId<Event>();
+            std::function<void(const Event&)> callback = eventCallback;
+
+            addCallback = [callback](ComponentRegistry& registry, EntityRef entity) {
+                registry.addEntityEventListener<Event>(entity, callback);
             };
 
-            callback = [eventCallback](const std::any& event) {
-                eventCallback(std::any_cast<const Event&>(event));
+            removeCallback = [](ComponentRegistry& registry, EntityRef entity) {
+                registry.removeEntityEventListener<Event>(entity);
             };
         }
 
-        OnEventComponent(const OnEventComponent& other) : eventIdCallback(other.eventIdCallback), callback(other.callback)
+        OnEventComponent(const OnEventComponent& other) : addCallback(other.addCallback), removeCallback(other.removeCallback)
         {
 
         }
@@ -39,9 +43,10 @@ namespace pg
 
         virtual void onDeletion(EntityRef entity) override;
 
-        std::function<_unique_id(const ComponentRegistry& registry)> eventIdCallback;
+        /** Register the typed callback in the event channel of its event */
+        std::function<void(ComponentRegistry&, EntityRef)> addCallback;
 
-        std::function<void(const std::any&)> callback;
+        std::function<void(ComponentRegistry&, EntityRef)> removeCallback;
     };
 
     struct OnStandardEventComponent : public Ctor, public Dtor
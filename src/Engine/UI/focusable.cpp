@@ -31,7 +31,7 @@ namespace pg
 
         FocusableComponent value;
 
-        for(auto& element : serializedString.children)
+        for(auto& element : serializedString.getChildren())
         {
             if(element.isNull())
                 LOG_ERROR(DOM, "Element is null");
@@ -39,7 +39,7 @@ namespace pg
                 LOG_ERROR(DOM, "Element has no name");
             else
             {
-                LOG_INFO(DOM, "Deserializing " + element.getObjectName());
+                LOG_INFO(DOM, "Deserializing " << element.getObjectName());
 
                 // Todo fix this
                 // value.entityId = deserialize<_unique_id>(serializedString["entityId"]);
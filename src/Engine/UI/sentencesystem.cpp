@@ -122,11 +122,12 @@ namespace pg
         });
     }
 
-    void SentenceSystem::onEvent(const EntityChangedEvent& event)
+    void SentenceSystem::onEvents(const std::vector<EntityChangedEvent>& events)
     {
         LOG_THIS_MEMBER(DOM);
 
-        onEventUpdate(event.id);
+        for (const auto& event : events)
+            onEventUpdate(event.id);
     }
 
     void SentenceSystem::onEventUpdate(_unique_id entityId)
@@ -143,26 +144,13 @@ namespace pg
 
         entity->get<SentenceRenderCall>()->call = createRenderCall(ui, shape);
 
-        changed = true;
+        // Only this call needs to be copied again in the render call list
+        ecsRef->markChanged<SentenceRenderCall>(entityId);
     }
 
     void SentenceSystem::execute()
     {
-        if (not changed)
-            return;
-
-        renderCallList.clear();
-
-        const auto& renderCallView = view<SentenceRenderCall>();
-
-        renderCallList.reserve(renderCallView.nbComponents());
-
-        for (const auto& renderCall : renderCallView)
-        {
-            renderCallList.push_back(renderCall->call);
-        }
-
-        changed = false;
+        syncRenderCalls<SentenceRenderCall>(view<SentenceRenderCall>());
     }
 
     RenderCall SentenceSystem::createRenderCall(CompRef<UiComponent> ui, CompRef<SentenceText> obj)
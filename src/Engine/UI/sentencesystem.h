@@ -142,7 +142,7 @@ namespace pg
         RenderCall call;
     };
 
-    struct SentenceSystem : public AbstractRenderer, System<Own<SentenceText>, Own<SentenceRenderCall>, Ref<UiComponent>, Listener<EntityChangedEvent>, NamedSystem, InitSys>
+    struct SentenceSystem : public AbstractRenderer, System<Own<SentenceText>, Own<SentenceRenderCall>, ReadRef<UiComponent>, BatchListener<EntityChangedEvent>, NamedSystem, InitSys>
     {
         SentenceSystem(MasterRenderer *renderer, const std::string& fontPath);
 
@@ -150,7 +150,7 @@ namespace pg
 
         virtual void init() override;
 
-        virtual void onEvent(const EntityChangedEvent& event) override;
+        virtual void onEvents(const std::vector<EntityChangedEvent>& events) override;
 
         void onEventUpdate(_unique_id entityId);
 
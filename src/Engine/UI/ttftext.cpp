@@ -117,11 +117,12 @@ namespace pg
         });
     }
 
-    void TTFTextSystem::onEvent(const EntityChangedEvent& event)
+    void TTFTextSystem::onEvents(const std::vector<EntityChangedEvent>& events)
     {
         LOG_THIS_MEMBER(DOM);
 
-        onEventUpdate(event.id);
+        for (const auto& event : events)
+            onEventUpdate(event.id);
     }
 
     void TTFTextSystem::registerFont(const std::string& fontPath, int size)
@@ -211,26 +212,13 @@ namespace pg
 
         entity->get<TTFTextCall>()->calls = createRenderCall(ui, shape);
 
-        changed = true;
+        // Only the calls of this text need to be copied again, unless its number of glyphs changed
+        ecsRef->markChanged<TTFTextCall>(entityId);
     }
 
     void TTFTextSystem::execute()
     {
-        if (not changed)
-            return;
-
-        renderCallList.clear();
-
-        const auto& renderCallView = viewGroup<UiComponent, TTFText, TTFTextCall>();
-
-        changed = false;
-
-        for (const auto& renderCall : renderCallView)
-        {
-            auto rCall = renderCall->get<TTFTextCall>();
-
-            renderCallList.insert(renderCallList.end(), rCall->calls.begin(), rCall->calls.end());
-        }        
+        syncRenderCallRanges<TTFTextCall>(view<TTFTextCall>());
     }
 
     std::vector<RenderCall> TTFTextSystem::createRenderCall(CompRef<UiComponent> ui, CompRef<TTFText> obj)
@@ -71,7 +71,7 @@ namespace pg
     template <>
     TTFText deserialize(const UnserializedObject& serializedString);
 
-    struct TTFTextSystem : public AbstractRenderer, System<Own<TTFText>, Own<TTFTextCall>, Ref<UiComponent>, Listener<EntityChangedEvent>, NamedSystem, InitSys>
+    struct TTFTextSystem : public AbstractRenderer, System<Own<TTFText>, Own<TTFTextCall>, ReadRef<UiComponent>, BatchListener<EntityChangedEvent>, NamedSystem, InitSys>
     {
         struct Character 
         {
@@ -87,7 +87,7 @@ namespace pg
 
         virtual void init() override;
 
-        virtual void onEvent(const EntityChangedEvent& event) override;
+        virtual void onEvents(const std::vector<EntityChangedEvent>& events) override;
 
         void registerFont(const std::string& fontPath, int size = 48);
 
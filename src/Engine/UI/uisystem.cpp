@@ -530,6 +530,10 @@ namespace pg
         }
 
         if (ecsRef)
+        {
+            ecsRef->markChanged<UiComponent>(entityId);
+
             ecsRef->sendEvent(EntityChangedEvent{entityId});
+        }
     }
 }
\ No newline at end of file
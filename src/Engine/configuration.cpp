@@ -31,7 +31,7 @@ namespace pg
 
         Configuration value;
 
-        for(auto& element : serializedString.children)
+        for(auto& element : serializedString.getChildren())
         {
             if (element.isNull())
             {
@@ -43,10 +43,10 @@ namespace pg
             }
             else
             {
-                LOG_INFO(DOM, "Deserializing " + element.getObjectName());
+                LOG_INFO(DOM, "Deserializing " << element.getObjectName());
 
                 auto child = deserialize<ElementType>(element);
-                value.elementMap[element.getObjectName()] = child;
+                value.elementMap[std::string(element.getObjectName())] = child;
             }
         }
         
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <memory>
 #include <cstring>
+#include <type_traits>
 
 #include "logger.h"
 #include "constant.h"
@@ -23,7 +24,7 @@ namespace pg
          * 
          * @return size_t The number of whitespace characters at the beginning of the string
          */
-        size_t nbLeadingSpaces(const std::string& str, const std::string& whitespace = " \t")
+        size_t nbLeadingSpaces(std::string_view str, std::string_view whitespace = " \t")
         {
             LOG_THIS(DOM);
             
@@ -40,9 +41,9 @@ namespace pg
          * @param str The string to trim
          * @param whitespace Characters used as whitespace characters
          * 
-         * @return std::string The resulting string trimmed of the whitespace characters
+         * @return std::string_view The resulting string trimmed of the whitespace characters
          */
-        std::string trim(const std::string& str, const std::string& whitespace = " \t")
+        std::string_view trim(std::string_view str, std::string_view whitespace = " \t")
         {
             LOG_THIS(DOM);
 
@@ -71,6 +72,145 @@ namespace pg
             ret.append(buffer, in.gcount());
             return ret;
         }
+
+        /** Tags of the nodes of a binary archive */
+        constexpr uint8_t CLASSTAG = 1;
+        constexpr uint8_t ATTRIBUTETAG = 2;
+
+        /** Number of bytes of the body size of a class, written once the class is ended */
+        constexpr size_t CLASSSIZEBYTES = 4;
+
+        /** Write an unsigned value in as few bytes as possible, 7 bits per byte with the high bit set if more bytes follow */
+        void writeVarint(std::string& out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+
+            out.push_back(static_cast<char>(value));
+        }
+
+        bool readVarint(std::string_view data, size_t& pos, uint64_t& value)
+        {
+            value = 0;
+
+            for (size_t shift = 0; shift < 64; shift += 7)
+            {
+                if (pos >= data.size())
+                    return false;
+
+                const auto byte = static_cast<uint8_t>(data[pos++]);
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        void writeLittleEndian(std::string& out, uint64_t value, size_t nbBytes)
+        {
+            for (size_t i = 0; i < nbBytes; ++i)
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+
+        uint64_t readLittleEndian(const char* data, size_t nbBytes)
+        {
+            uint64_t value = 0;
+
+            for (size_t i = 0; i < nbBytes; ++i)
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+
+            return value;
+        }
+
+        /** Check if the data starts with the header of a binary serialized file */
+        bool isBinaryData(const std::string& data)
+        {
+            const auto magicSize = std::strlen(BINARYARCHIVEMAGIC);
+
+            return data.size() > magicSize and data.compare(0, magicSize, BINARYARCHIVEMAGIC) == 0;
+        }
+
+        /** Number of bytes of a base type in a binary archive, independent of the platform */
+        template <typename Type>
+        constexpr size_t binaryValueSize()
+        {
+            if constexpr (std::is_same_v<Type, bool>)
+                return 1;
+            else if constexpr (std::is_same_v<Type, double> or std::is_same_v<Type, size_t>)
+                return 8;
+            else
+                return 4;
+        }
+
+        /**
+         * @brief Decode a base type attribute of a binary archive
+         * 
+         * @param object The attribute to decode
+         * @param type Expected type of the attribute
+         * 
+         * @return Type The decoded value, a default value if the attribute doesn't hold this type
+         */
+        template <typename Type>
+        Type readBinaryValue(const UnserializedObject& object, const char* type)
+        {
+            const auto& raw = object.getRawValue();
+
+            if (object.isClassObject() or object.getObjectType() != type or raw.size() != binaryValueSize<Type>())
+            {
+                LOG_ERROR(DOM, "Binary attribute '" << object.getObjectName() << "' is not a " << type << " (" << object.getObjectType() << ")");
+
+                return Type{};
+            }
+
+            const auto value = readLittleEndian(raw.data(), raw.size());
+
+            if constexpr (std::is_same_v<Type, bool>)
+                return value != 0;
+            else if constexpr (std::is_same_v<Type, float>)
+            {
+                const auto bits = static_cast<uint32_t>(value);
+                float result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result;
+            }
+            else if constexpr (std::is_same_v<Type, double>)
+            {
+                double result;
+                std::memcpy(&result, &value, sizeof(result));
+                return result;
+            }
+            else if constexpr (std::is_same_v<Type, int>)
+                return static_cast<int>(static_cast<int32_t>(value));
+            else
+                return static_cast<Type>(value);
+        }
+
+        /** Text of a binary attribute, as the text format would hold it */
+        std::string binaryValueToText(const UnserializedObject& object)
+        {
+            const auto& type = object.getObjectType();
+
+            if (type == "bool")
+                return readBinaryValue<bool>(object, "bool") ? "true" : "false";
+            else if (type == "int")
+                return std::to_string(readBinaryValue<int>(object, "int"));
+            else if (type == "unsigned int")
+                return std::to_string(readBinaryValue<unsigned int>(object, "unsigned int"));
+            else if (type == "float")
+                return std::to_string(readBinaryValue<float>(object, "float"));
+            else if (type == "double")
+                return std::to_string(readBinaryValue<double>(object, "double"));
+            else if (type == "size_t")
+                return std::to_string(readBinaryValue<size_t>(object, "size_t"));
+
+            return std::string(object.getRawValue());
+        }
     }
 
     // Serialisation of base type
@@ -80,6 +220,12 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (archive.isBinary())
+        {
+            static_cast<BinaryArchive&>(archive).setValue(value, "bool");
+            return;
+        }
+
         std::string res = value ? "true" : "false";
 
         archive.setAttribute(res, "bool");
@@ -90,7 +236,10 @@ namespace pg
     {
         LOG_THIS(DOM);
 
-        archive.setAttribute(std::to_string(value), "int");
+        if (archive.isBinary())
+            static_cast<BinaryArchive&>(archive).setValue(value, "int");
+        else
+            archive.setAttribute(std::to_string(value), "int");
     }
 
     template <>
@@ -98,7 +247,10 @@ namespace pg
     {
         LOG_THIS(DOM);
 
-        archive.setAttribute(std::to_string(value), "unsigned int");
+        if (archive.isBinary())
+            static_cast<BinaryArchive&>(archive).setValue(value, "unsigned int");
+        else
+            archive.setAttribute(std::to_string(value), "unsigned int");
     }
 
     template <>
@@ -106,7 +258,10 @@ namespace pg
     {
         LOG_THIS(DOM);
 
-        archive.setAttribute(std::to_string(value), "float");
+        if (archive.isBinary())
+            static_cast<BinaryArchive&>(archive).setValue(value, "float");
+        else
+            archive.setAttribute(std::to_string(value), "float");
     }
 
     template <>
@@ -114,7 +269,10 @@ namespace pg
     {
         LOG_THIS(DOM);
 
-        archive.setAttribute(std::to_string(value), "double");
+        if (archive.isBinary())
+            static_cast<BinaryArchive&>(archive).setValue(value, "double");
+        else
+            archive.setAttribute(std::to_string(value), "double");
     }
 
     template <>
@@ -122,7 +280,10 @@ namespace pg
     {
         LOG_THIS(DOM);
 
-        archive.setAttribute(std::to_string(value), "size_t");
+        if (archive.isBinary())
+            static_cast<BinaryArchive&>(archive).setValue(value, "size_t");
+        else
+            archive.setAttribute(std::to_string(value), "size_t");
     }
 
     template <>
@@ -207,6 +368,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<bool>(serializedString, "bool");
+
         auto attribute = serializedString.getAsAttribute();
         if (attribute.name != "bool")
         {
@@ -228,6 +392,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<int>(serializedString, "int");
+
         int value = 0;
 
         auto attribute = serializedString.getAsAttribute();
@@ -248,6 +415,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<unsigned int>(serializedString, "unsigned int");
+
         unsigned int value = 0;
 
         auto attribute = serializedString.getAsAttribute();
@@ -268,6 +438,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<float>(serializedString, "float");
+
         float value = 0;
 
         auto attribute = serializedString.getAsAttribute();
@@ -288,6 +461,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<double>(serializedString, "double");
+
         double value = 0;
 
         auto attribute = serializedString.getAsAttribute();
@@ -308,6 +484,9 @@ namespace pg
     {
         LOG_THIS(DOM);
 
+        if (serializedString.isBinary())
+            return readBinaryValue<size_t>(serializedString, "size_t");
+
         size_t value = 0;
 
         auto attribute = serializedString.getAsAttribute();
@@ -351,6 +530,48 @@ namespace pg
         return std::string();
     }
     
+    template <>
+    void serialize(Archive& archive, const UnserializedObject& value)
+    {
+        LOG_THIS(DOM);
+
+        if (value.isNull())
+            return;
+
+        if (value.isClassObject())
+        {
+            archive.startSerialization(std::string(value.getObjectType()));
+
+            for (const auto& child : value.getChildren())
+            {
+                if (not child.isNull())
+                    serialize(archive, std::string(child.getObjectName()), child);
+            }
+
+            archive.endSerialization();
+
+            return;
+        }
+
+        const auto attribute = value.getAsAttribute();
+
+        // Base types go through their own serialize function so a binary archive gets them as raw values
+        if (attribute.name == "bool")
+            serialize(archive, deserialize<bool>(value));
+        else if (attribute.name == "int")
+            serialize(archive, deserialize<int>(value));
+        else if (attribute.name == "unsigned int")
+            serialize(archive, deserialize<unsigned int>(value));
+        else if (attribute.name == "float")
+            serialize(archive, deserialize<float>(value));
+        else if (attribute.name == "double")
+            serialize(archive, deserialize<double>(value));
+        else if (attribute.name == "size_t")
+            serialize(archive, deserialize<size_t>(value));
+        else
+            archive.setAttribute(attribute.value, attribute.name);
+    }
+
     template <>
     constant::Vector2D deserialize(const UnserializedObject& serializedString)
     {
@@ -476,6 +697,167 @@ namespace pg
         *this << "}" << endl();
     }
 
+    void BinaryArchive::startSerialization(const std::string& className)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        startNode(CLASSTAG, className);
+
+        // The size of the body is only known once the class is ended
+        openedClasses.push_back(nodes.size());
+
+        nodes.append(CLASSSIZEBYTES, '\0');
+    }
+
+    void BinaryArchive::endSerialization()
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        if (openedClasses.empty())
+        {
+            LOG_ERROR(DOM, "Ending a class that was never started !");
+
+            return;
+        }
+
+        const auto sizePos = openedClasses.back();
+
+        openedClasses.pop_back();
+
+        const auto bodySize = nodes.size() - sizePos - CLASSSIZEBYTES;
+
+        for (size_t i = 0; i < CLASSSIZEBYTES; ++i)
+            nodes[sizePos + i] = static_cast<char>((bodySize >> (8 * i)) & 0xFF);
+    }
+
+    void BinaryArchive::setAttribute(const std::string& value, const std::string& type)
+    {
+        startNode(ATTRIBUTETAG, type);
+
+        writeVarint(nodes, value.size());
+
+        nodes.append(value);
+    }
+
+    void BinaryArchive::setValue(bool value, const std::string& type)
+    {
+        writeRawValue(value ? 1 : 0, binaryValueSize<bool>(), type);
+    }
+
+    void BinaryArchive::setValue(int value, const std::string& type)
+    {
+        writeRawValue(static_cast<uint32_t>(value), binaryValueSize<int>(), type);
+    }
+
+    void BinaryArchive::setValue(unsigned int value, const std::string& type)
+    {
+        writeRawValue(value, binaryValueSize<unsigned int>(), type);
+    }
+
+    void BinaryArchive::setValue(float value, const std::string& type)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        writeRawValue(bits, binaryValueSize<float>(), type);
+    }
+
+    void BinaryArchive::setValue(double value, const std::string& type)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        writeRawValue(bits, binaryValueSize<double>(), type);
+    }
+
+    void BinaryArchive::setValue(size_t value, const std::string& type)
+    {
+        writeRawValue(value, binaryValueSize<size_t>(), type);
+    }
+
+    std::string BinaryArchive::str() const
+    {
+        std::string data;
+
+        writeVarint(data, names.size());
+
+        for (const auto& name : names)
+        {
+            writeVarint(data, name.size());
+            data.append(name);
+        }
+
+        data.append(nodes);
+
+        return data;
+    }
+
+    void BinaryArchive::startNode(uint8_t tag, const std::string& type)
+    {
+        nodes.push_back(static_cast<char>(tag));
+
+        writeVarint(nodes, intern(pendingName));
+        writeVarint(nodes, intern(type));
+
+        pendingName.clear();
+    }
+
+    void BinaryArchive::writeRawValue(uint64_t value, size_t nbBytes, const std::string& type)
+    {
+        startNode(ATTRIBUTETAG, type);
+
+        writeVarint(nodes, nbBytes);
+
+        writeLittleEndian(nodes, value, nbBytes);
+    }
+
+    size_t BinaryArchive::intern(const std::string& name)
+    {
+        const auto it = nameIds.find(name);
+
+        if (it != nameIds.end())
+            return it->second;
+
+        names.push_back(name);
+        nameIds.emplace(name, names.size() - 1);
+
+        return names.size() - 1;
+    }
+
+    UnserializedObject::UnserializedObject(const std::string& serializedString, const std::string& objectName, bool isClass) : isNullObject(false), isClass(isClass)
+    {
+        auto storage = std::make_shared<Buffer>();
+
+        storage->data = serializedString;
+        storage->name = objectName;
+
+        buffer = storage;
+
+        this->objectName = buffer->name;
+        this->serializedString = buffer->data;
+
+        if (isClass)
+            parseString();
+    }
+
+    UnserializedObject::UnserializedObject(const std::string& objectName, const std::string& objectType, const std::string& serializedString) : isNullObject(false), isClass(true)
+    {
+        auto storage = std::make_shared<Buffer>();
+
+        storage->data = serializedString;
+        storage->name = objectName;
+        storage->type = objectType;
+
+        buffer = storage;
+
+        this->objectName = buffer->name;
+        this->objectType = buffer->type;
+        this->serializedString = buffer->data;
+
+        // The children of this object are only the ones added by hand
+        indexed = true;
+    }
+
     UnserializedObject::Attribute UnserializedObject::getAsAttribute() const
     {
         UnserializedObject::Attribute attribute;
@@ -488,10 +870,19 @@ namespace pg
             return UnserializedObject::Attribute();
         }
 
+        // A binary attribute holds its type and value apart, no parsing needed
+        if (binary)
+        {
+            attribute.name = std::string(objectType);
+            attribute.value = binaryValueToText(*this);
+
+            return attribute;
+        }
+
         // Lockup for the ATTRIBUTECONST
         auto ATTRIBUTECONSTPos = serializedString.find(ATTRIBUTECONST);
 
-        if (ATTRIBUTECONSTPos == std::string::npos)
+        if (ATTRIBUTECONSTPos == std::string_view::npos)
         {
             LOG_ERROR(DOM, "The serializedString is missing the 'ATTRIBUTECONST' !");
 
@@ -502,7 +893,7 @@ namespace pg
 
         auto startAttributeValue = serializedString.find("{", ATTRIBUTECONSTPos);
 
-        if (startAttributeValue == std::string::npos)
+        if (startAttributeValue == std::string_view::npos)
         {
             LOG_ERROR(DOM, "The serializedString is missing the '{' that start the attribute !");
 
@@ -521,320 +912,443 @@ namespace pg
         }
         else
         {
-            attribute.name = serializedString.substr(ATTRIBUTECONSTPos + 1, startAttributeValue - ATTRIBUTECONSTPos - 2);
+            attribute.name = std::string(serializedString.substr(ATTRIBUTECONSTPos + 1, startAttributeValue - ATTRIBUTECONSTPos - 2));
         }
 
         auto endAttributeValue = serializedString.rfind("}");
 
-        if (endAttributeValue == std::string::npos)
+        if (endAttributeValue == std::string_view::npos)
         {
             LOG_ERROR(DOM, "The serializedString is missing the '}' that end the attribute !");
 
             return UnserializedObject::Attribute();
         }
 
-        attribute.value = serializedString.substr(startAttributeValue + 1, endAttributeValue - (startAttributeValue + 1));
+        const auto value = serializedString.substr(startAttributeValue + 1, endAttributeValue - (startAttributeValue + 1));
+
+        // The lines following the first one of a multiline value are indented in the serialized string, so remove this indent
+        size_t lineStart = 0;
+
+        while (true)
+        {
+            const auto lineEnd = value.find('\n', lineStart);
+
+            auto line = value.substr(lineStart, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - lineStart);
+
+            if (lineStart > 0)
+            {
+                const auto indent = line.find_first_not_of(" \t");
+
+                line = indent == std::string_view::npos ? std::string_view() : line.substr(indent);
+            }
+
+            attribute.value.append(line);
+
+            if (lineEnd == std::string_view::npos)
+                break;
+
+            attribute.value.push_back('\n');
+
+            lineStart = lineEnd + 1;
+        }
 
         return attribute;
     }
 
-    const UnserializedObject& UnserializedObject::operator[](const std::string& key)
+    const UnserializedObject& UnserializedObject::operator[](const std::string& key) const
     {
-        auto isObjectName = [=](UnserializedObject obj) { return obj.objectName == key; }; 
-        auto it = std::find_if(children.begin(), children.end(), isObjectName);
+        static const UnserializedObject nullObject;
+
+        const auto& nodes = getChildren();
 
-        if (it != children.end())
+        auto isObjectName = [&key](const UnserializedObject& obj) { return obj.objectName == key; }; 
+        const auto& it = std::find_if(nodes.begin(), nodes.end(), isObjectName);
+
+        if (it != nodes.end())
             return *it;
         else
         {
             LOG_ERROR(DOM, "Requested the child: '" + key + "' not present inside the object");
-            return children[0];
+            return nullObject;
         }
     }
 
-    const UnserializedObject& UnserializedObject::operator[](const std::string& key) const
+    const UnserializedObject& UnserializedObject::operator[](size_t id) const
     {
-        auto isObjectName = [=](const UnserializedObject& obj) { return obj.objectName == key; }; 
-        const auto& it = std::find_if(children.begin(), children.end(), isObjectName);
+        static const UnserializedObject nullObject;
 
-        if (it != children.end())
-            return *it;
+        const auto& nodes = getChildren();
+
+        if (id < nodes.size())
+            return nodes[id];
         else
         {
-            LOG_ERROR(DOM, "Requested the child: '" + key + "' not present inside the object");
-            return children[0];
+            LOG_ERROR(DOM, "Requested the child: '" + std::to_string(id)  + "' not present inside the object");
+            return nullObject;
         }
     }
 
-    const UnserializedObject& UnserializedObject::operator[](size_t id)
+    void UnserializedObject::addChild(const UnserializedObject& child)
     {
-        if (id < children.size())
-            return children.at(id);
-        else
-        {
-            LOG_ERROR(DOM, "Requested the child: '" + std::to_string(id) + "' not present inside the object");
-            return children[0];
-        }
+        indexChildren();
+
+        children.push_back(child);
     }
 
-    const UnserializedObject& UnserializedObject::operator[](size_t id) const
+    UnserializedObject UnserializedObject::fromBinary(const std::string& data, const std::string& objectName)
     {
-        if (id < children.size())
-            return children.at(id);
-        else
+        LOG_THIS(DOM);
+
+        auto storage = std::make_shared<Buffer>();
+
+        storage->data = data;
+        storage->name = objectName;
+
+        const std::string_view view = storage->data;
+
+        size_t pos = 0;
+        uint64_t nbNames = 0;
+
+        // Each name takes at least one byte, this also protects the reserve against corrupted data
+        bool valid = readVarint(view, pos, nbNames) and nbNames <= view.size() - pos;
+
+        if (valid)
+            storage->names.reserve(nbNames);
+
+        for (uint64_t i = 0; i < nbNames and valid; ++i)
         {
-            LOG_ERROR(DOM, "Requested the child: '" + std::to_string(id)  + "' not present inside the object");
-            return children[0];
+            uint64_t size = 0;
+
+            valid = readVarint(view, pos, size) and size <= view.size() - pos;
+
+            if (valid)
+            {
+                storage->names.push_back(view.substr(pos, size));
+                pos += size;
+            }
         }
+
+        UnserializedObject object;
+
+        object.buffer = storage;
+
+        // Only the header of the root is read, its size covers the whole object so truncated data is still caught here
+        valid = valid and object.parseBinaryNode(pos) and pos == view.size();
+
+        if (not valid)
+        {
+            LOG_ERROR(DOM, "Binary data of object '" << objectName << "' is ill formed");
+
+            return UnserializedObject();
+        }
+
+        object.objectName = storage->name;
+
+        return object;
     }
 
-    void UnserializedObject::parseString()
+    bool UnserializedObject::parseBinaryNode(size_t& pos)
     {
-        LOG_THIS_MEMBER(DOM);
+        const std::string_view data = buffer->data;
+        const auto& names = buffer->names;
 
-        std::string currentLine;
-        size_t classChildIndent = 0;
+        if (pos >= data.size())
+            return false;
 
-        std::string nextLine;
-        size_t currentIndent = 0;
-        size_t nextIndent = 0;
+        const auto tag = static_cast<uint8_t>(data[pos++]);
 
-        std::istringstream iss(serializedString);
+        uint64_t nameId = 0;
+        uint64_t typeId = 0;
 
-        std::string tempObjectName = ""; 
-        std::string tempAttributeName = ""; 
-        std::string delimiter = ": ";
-        std::string tempSerializedString = "";
-        size_t pos;
-        
-        // First line should always be the beginning of a class declaration
-        bool startOfClass = false;
-        bool lockupClass = false;
+        if (not readVarint(data, pos, nameId) or not readVarint(data, pos, typeId) or nameId >= names.size() or typeId >= names.size())
+            return false;
 
-        bool lockupAttribute = false;
+        uint64_t size = 0;
 
-        // First class of the serialized string is for the current class
-        //bool firstClass = true;
+        if (tag == ATTRIBUTETAG)
+        {
+            if (not readVarint(data, pos, size))
+                return false;
 
-        bool errorHappened = false;
+            isClass = false;
+        }
+        else if (tag == CLASSTAG and data.size() - pos >= CLASSSIZEBYTES)
+        {
+            size = readLittleEndian(data.data() + pos, CLASSSIZEBYTES);
+            pos += CLASSSIZEBYTES;
 
-        // The first child is a empty one
-        children.emplace_back();
+            isClass = true;
+        }
+        else
+            return false;
 
-        // Check if their is at least one line in the serialized string
-        if (not std::getline(iss, currentLine))
-        {
-            LOG_ERROR(DOM, "Serialized string is empty for object: '" + objectName + "'");
+        if (size > data.size() - pos)
+            return false;
 
-            isNullObject = true;
+        objectName = names[nameId];
+        objectType = names[typeId];
+
+        isNullObject = false;
+        binary = true;
+
+        // The value of an attribute or the body of a class, left undecoded until it is needed
+        serializedString = data.substr(pos, size);
+        pos += size;
+
+        return true;
+    }
+
+    void UnserializedObject::indexChildren() const
+    {
+        // Checked before touching indexed: the null object returned for a missing child is shared by all the threads
+        if (indexed or isNullObject or not isClass)
             return;
-        }
+
+        indexed = true;
+
+        if (binary)
+            indexBinaryChildren();
         else
+            indexTextChildren();
+    }
+
+    void UnserializedObject::indexBinaryChildren() const
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        // The first child is a empty one, as for the text format
+        children.emplace_back();
+
+        size_t pos = serializedString.data() - buffer->data.data();
+        const auto end = pos + serializedString.size();
+
+        // Only the headers of the children are read, their size is used to jump over their body
+        while (pos < end)
         {
-            // Then calculate the indent of the children
-            classChildIndent = nbLeadingSpaces("\t" + currentLine);
+            UnserializedObject child;
 
-            // This can happen if the class is actually a basic type which is only an attribute !
-            if (currentLine.find(ATTRIBUTECONST) != std::string::npos)
+            child.buffer = buffer;
+
+            if (not child.parseBinaryNode(pos) or pos > end)
             {
-                isClass = false;
-                return;
+                LOG_ERROR(DOM, "Binary data of object '" << objectName << "' is ill formed");
+
+                break;
             }
 
-            // Check if the name given to the constructor match to the class in the serialized string
-            pos = currentLine.find(delimiter);
+            children.push_back(std::move(child));
+        }
+    }
 
-            // If ":" is not found for the class declaration then it is a unnamed one
-            if (pos == std::string::npos)
-            {
-                tempObjectName = "";
+    void UnserializedObject::indexTextChildren() const
+    {
+        LOG_THIS_MEMBER(DOM);
 
-                // This should always be true
-                if (classChildIndent > 0)
-                    pos = classChildIndent - 1;
-                else
-                    pos = 0;
-            }
-            else // Else the name of the object is the first part of the string
-            {
-                tempObjectName = trim(currentLine.substr(0, pos));
-                pos += 2;
-            }
+        constexpr auto npos = std::string_view::npos;
 
-            auto endPos = currentLine.find(" {");
+        // The first child is a empty one
+        children.emplace_back();
 
-            if (endPos == std::string::npos)
-            {
-                LOG_ERROR(DOM, "Error happened when parsing class '" + objectName + "' missing { after class type");
-                
-                isNullObject = true;
-                return;
-            }
-            else
-            {
-                objectType = currentLine.substr(pos, endPos - 1);
-                LOG_MILE(DOM, "Found class type '" + objectType + "'");
-            }
+        const auto text = serializedString;
 
-            // If the object name doesn't match we throw an error
-            if (tempObjectName != objectName)
-            {
-                LOG_ERROR(DOM, "Error happened when passing data: Current objectName '" + objectName + "' doesn't match the serialized string passed '" + tempObjectName + "'");
-                
-                isNullObject = true;
-                return;
-            }
+        // The children are one indent further than the declaration of the class, the lines even further belong to a child class
+        const auto childIndent = nbLeadingSpaces(text) + 1;
 
-            // Read the next line (For a class their should always be at least 2 lines, one for constructor and the last "}" to indicate the end of the class)
-            if (not std::getline(iss, currentLine))
-            {
-                LOG_ERROR(DOM, "Serialized string doesn't end correctly for object: '" + objectName + "'");
+        size_t childStart = npos;
+        bool childIsClass = false;
 
-                isNullObject = true;
-                return;
-            }
+        auto endChild = [&](size_t end) {
+            if (childStart != npos)
+                children.push_back(makeTextChild(text.substr(childStart, end - childStart), childIsClass));
 
-            // If the second line of the string is "{" then it means that the class doesn't have any children so we can return early.
-            const auto trimmed = trim(currentLine);
-            if (trimmed == "}")
-            {
-                LOG_MILE(DOM, "Object: " + objectName + " doesn't have any children in serialization !");
-                
-                isNullObject = false;
-                return;
-            }
+            childStart = npos;
+        };
 
-        }
-            
-        while (std::getline(iss, nextLine))
+        // Skip the declaration of the class
+        auto lineStart = text.find('\n');
+        lineStart = lineStart == npos ? text.size() : lineStart + 1;
+
+        while (lineStart < text.size())
         {
-            nextIndent = nbLeadingSpaces(nextLine);
-            if (nextIndent > classChildIndent and startOfClass == false and lockupClass == false)
-                startOfClass = true;
+            auto lineEnd = text.find('\n', lineStart);
 
-            if (startOfClass)
-            {
-                // If lockupAttribute is true, then we finished processing the previous attribute
-                if (lockupAttribute)
-                {
-                    children.emplace_back(tempSerializedString, tempAttributeName, false);
-                    lockupAttribute = false;
-                }
+            if (lineEnd == npos)
+                lineEnd = text.size();
+
+            const auto nextStart = std::min(lineEnd + 1, text.size());
+
+            const auto line = text.substr(lineStart, lineEnd - lineStart);
+            const auto indent = nbLeadingSpaces(line);
 
-                // Try to find ":" to see if the class is named or not 
-                pos = currentLine.find(delimiter);
+            // Closing line of the class
+            if (indent < childIndent)
+                break;
 
-                // If ":" is not found for the class declaration then it is a unnamed one
-                if (pos == std::string::npos)
+            if (indent == childIndent)
+            {
+                const auto trimmed = trim(line);
+
+                if (childStart != npos and childIsClass and (trimmed == "}" or trimmed == "},"))
                 {
-                    tempObjectName = "";
+                    endChild(nextStart);
                 }
-                else // Else the name of the object is the first part of the string
+                // The current line is the beginning of a new attribute
+                else if (line.find(ATTRIBUTECONST) != npos)
                 {
-                    tempObjectName = trim(currentLine.substr(0, pos));
+                    endChild(lineStart);
+
+                    childStart = lineStart;
+                    childIsClass = false;
                 }
+                else
+                {
+                    const auto nextEnd = text.find('\n', nextStart);
+                    const auto nextIndent = nbLeadingSpaces(text.substr(nextStart, nextEnd == npos ? npos : nextEnd - nextStart));
 
-                // Todo: check if we need to retrive the class name from the serialized object
+                    // A class declaration is followed by its more indented body
+                    if (nextIndent != npos and nextIndent > childIndent)
+                    {
+                        endChild(lineStart);
 
-                // Look up for another ":" if found the serialized string is ill formated
-                pos = currentLine.find(delimiter, pos + delimiter.length());
-    
-                if (pos != std::string::npos)
-                {
-                    LOG_ERROR(DOM, "Class string is ill formated, current line possess multiple ':' '" + currentLine + "'");
+                        childStart = lineStart;
+                        childIsClass = true;
+                    }
+                    // Error the current line describe nothing
+                    else if (childStart == npos or childIsClass)
+                    {
+                        LOG_ERROR(DOM, "Line is neither a class definition, a class body nor a attribute in object '" << objectName << "', serialization string is ill formed !");
 
-                    errorHappened = true;
-                    break;
+                        childStart = npos;
+                        break;
+                    }
+
+                    // Else the current line is part of the body of the attribute
                 }
+            }
+
+            lineStart = nextStart;
+        }
+
+        endChild(lineStart);
+    }
+
+    UnserializedObject UnserializedObject::makeTextChild(std::string_view text, bool isChildClass) const
+    {
+        constexpr auto npos = std::string_view::npos;
+
+        UnserializedObject child;
 
-                tempSerializedString = currentLine + "\n";
+        child.buffer = buffer;
+        child.serializedString = text;
+        child.isNullObject = false;
+        child.isClass = isChildClass;
 
-                startOfClass = false;
-                lockupClass = true;
+        const auto line = text.substr(0, text.find('\n'));
+
+        if (isChildClass)
+        {
+            const auto typeEnd = line.find(" {");
+
+            auto pos = line.find(": ");
+
+            // If ":" is not found for the class declaration then it is a unnamed one
+            if (pos != npos and pos < typeEnd)
+            {
+                child.objectName = trim(line.substr(0, pos));
+                pos += 2;
             }
             else
-            {
-                if (lockupClass)
-                {
-                    tempSerializedString += currentLine + "\n";
+                pos = 0;
 
-                    const auto trimmed = trim(currentLine);
-                    if ((classChildIndent == currentIndent) and (trimmed == "}" or trimmed =="},"))
-                    {
-                        children.emplace_back(tempSerializedString, tempObjectName);
-                        lockupClass = false;
-                    }
-                }
-                else
-                {
-                    pos = currentLine.find(ATTRIBUTECONST);
+            child.objectType = trim(line.substr(pos, typeEnd == npos ? npos : typeEnd - pos));
+        }
+        else
+        {
+            // Cut the line at the ATTRIBUTECONST to look for the attribute name
+            const auto prefix = line.substr(0, line.find(ATTRIBUTECONST));
 
-                    // The current line is the beginning of a new attribute
-                    if (pos != std::string::npos)
-                    {
-                        // If lockupAttribute is true, then we finished processing the previous attribute
-                        if (lockupAttribute)
-                        {
-                            children.emplace_back(tempSerializedString, tempAttributeName, false);
-                            lockupAttribute = false;
-                        }
+            const auto pos = prefix.find(": ");
 
-                        // Cut the beginning of the current line to look for the attribute name
-                        tempAttributeName = currentLine.substr(0, pos);
+            if (pos != npos)
+                child.objectName = trim(prefix.substr(0, pos));
+        }
 
-                        // Try to find ":" to see if the attribute is named or not 
-                        pos = tempAttributeName.find(delimiter);
+        return child;
+    }
 
-                        // If ":" is not found for the class declaration then it is a unnamed one
-                        if (pos == std::string::npos)
-                            tempAttributeName = "";
-                        else // Else the name of the object is the first part of the string
-                            tempAttributeName = trim(tempAttributeName.substr(0, pos));
+    void UnserializedObject::parseString()
+    {
+        LOG_THIS_MEMBER(DOM);
 
-                        LOG_MILE(DOM, "Child Attribute name: '" + tempAttributeName + "'");
+        constexpr auto npos = std::string_view::npos;
 
-                        tempSerializedString = currentLine + "\n";
+        if (serializedString.empty())
+        {
+            LOG_ERROR(DOM, "Serialized string is empty for object: '" << objectName << "'");
 
-                        lockupAttribute = true;
-                    }
-                    // Error the current line describe nothing
-                    else if (pos == std::string::npos and lockupAttribute == false)
-                    {
-                        LOG_ERROR(DOM, "Line is neither a class definition, a class body nor a attribute, serialization string is ill formed. Exiting Serialization Parsing !");
+            isNullObject = true;
+            return;
+        }
 
-                        errorHappened = true;
-                        break;
-                    }
-                    // The current line is part of the body of the attribute
-                    else if (pos == std::string::npos and lockupAttribute == true)
-                    {
-                        // Trim the line by the current number of indent to make it back to the original format before making the value an attribute !
-                        tempSerializedString += currentLine.substr(currentIndent) + "\n";
-                    }
-                    
-                }
-            }
+        const auto firstLineEnd = serializedString.find('\n');
+        const auto firstLine = serializedString.substr(0, firstLineEnd);
+
+        // This can happen if the class is actually a basic type which is only an attribute !
+        if (firstLine.find(ATTRIBUTECONST) != npos)
+        {
+            isClass = false;
+            return;
+        }
+
+        const auto typeEnd = firstLine.find(" {");
 
-            currentLine = nextLine;
-            currentIndent = nextIndent;
+        if (typeEnd == npos)
+        {
+            LOG_ERROR(DOM, "Error happened when parsing class '" << objectName << "' missing { after class type");
+
+            isNullObject = true;
+            return;
         }
 
-        // If lockupAttribute is true, then we finished processing the previous attribute
-        if (lockupAttribute)
+        // Check if the name given to the constructor match to the class in the serialized string
+        auto pos = firstLine.find(": ");
+
+        std::string_view tempObjectName;
+
+        // If ":" is not found for the class declaration then it is a unnamed one
+        if (pos == npos or pos > typeEnd)
+        {
+            pos = firstLine.find_first_not_of(" \t");
+        }
+        else // Else the name of the object is the first part of the string
         {
-            children.emplace_back(tempSerializedString, tempAttributeName, false);
-            lockupAttribute = false;
+            tempObjectName = trim(firstLine.substr(0, pos));
+            pos += 2;
         }
 
-        if (errorHappened)
+        objectType = trim(firstLine.substr(pos, typeEnd - pos));
+
+        LOG_MILE(DOM, "Found class type '" << objectType << "'");
+
+        // If the object name doesn't match we throw an error
+        if (tempObjectName != objectName)
         {
-            LOG_ERROR(DOM, "Error happened when parsing serialized string for object: '" + objectName + "'");
+            LOG_ERROR(DOM, "Error happened when passing data: Current objectName '" << objectName << "' doesn't match the serialized string passed '" << tempObjectName << "'");
+
             isNullObject = true;
+            return;
+        }
 
+        // For a class their should always be at least 2 lines, one for constructor and the last "}" to indicate the end of the class
+        if (firstLineEnd == npos or firstLineEnd + 1 >= serializedString.size())
+        {
+            LOG_ERROR(DOM, "Serialized string doesn't end correctly for object: '" << objectName << "'");
+
+            isNullObject = true;
             return;
         }
 
-        isNullObject = false;
+        // The children are only indexed when they are first accessed
     }
 
     Serializer::Serializer(const TextFile& file, bool autoSave) : autoSave(autoSave), file(file)
@@ -848,7 +1362,7 @@ namespace pg
     {
         LOG_THIS_MEMBER(DOM);
 
-        TextFile file = UniversalFileAccessor::openTextFile(filename);
+        TextFile file = openFile(filename);
         this->file = file;
 
         readFile(file.data);
@@ -885,12 +1399,41 @@ namespace pg
 
         serializedMap.clear();
 
-        TextFile file = UniversalFileAccessor::openTextFile(path);
+        TextFile file = openFile(path);
         this->file = file;
 
         readFile(file.data);
     }
 
+    void Serializer::setFormat(SerializationFormat format)
+    {
+        LOG_THIS_MEMBER(DOM);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (format != this->format and not serializedMap.empty())
+        {
+            LOG_ERROR(DOM, "Can't change the format of a serializer holding objects, clear it first !");
+
+            return;
+        }
+
+        this->format = format;
+    }
+
+    TextFile Serializer::openFile(const std::string& path)
+    {
+        LOG_THIS(DOM);
+
+        // A text read would alter the line endings of a binary file, so it is read as is first
+        auto file = UniversalFileAccessor::openBinaryFile(path);
+
+        if (not isBinaryData(file.data))
+            file = UniversalFileAccessor::openTextFile(path);
+
+        return file;
+    }
+
     void Serializer::readFile(const std::string& data)
     {
         LOG_THIS_MEMBER(DOM);
@@ -901,6 +1444,18 @@ namespace pg
             return;
         }
 
+        // The header of the file picks the format
+        if (isBinaryData(data))
+        {
+            format = SerializationFormat::Binary;
+
+            serializedMap = readBinaryData(data);
+
+            return;
+        }
+
+        format = SerializationFormat::Text;
+
         std::string line;
 
         std::istringstream stream(data);
@@ -1005,12 +1560,70 @@ namespace pg
         return sMap;
     }
 
-    void Serializer::registerSerialized(const std::string& objectName, const std::stringstream& serializedString)
+    std::unordered_map<std::string, std::string> Serializer::readBinaryData(const std::string& data)
+    {
+        LOG_THIS(DOM);
+
+        std::unordered_map<std::string, std::string> sMap;
+
+        if (not isBinaryData(data))
+        {
+            LOG_ERROR(DOM, "Data is not a binary serialized file");
+
+            return sMap;
+        }
+
+        size_t pos = std::strlen(BINARYARCHIVEMAGIC);
+
+        const auto fileVersion = static_cast<uint8_t>(data[pos++]);
+
+        if (fileVersion != BINARYARCHIVEVERSION)
+        {
+            LOG_ERROR(DOM, "Unsupported binary format version: " << static_cast<int>(fileVersion));
+
+            return sMap;
+        }
+
+        uint64_t nbObjects = 0;
+
+        bool valid = readVarint(data, pos, nbObjects);
+
+        for (uint64_t i = 0; i < nbObjects and valid; ++i)
+        {
+            uint64_t nameSize = 0;
+            uint64_t dataSize = 0;
+
+            valid = readVarint(data, pos, nameSize) and nameSize <= data.size() - pos;
+
+            if (not valid)
+                break;
+
+            std::string objectName(data, pos, nameSize);
+            pos += nameSize;
+
+            valid = readVarint(data, pos, dataSize) and dataSize <= data.size() - pos;
+
+            if (not valid)
+                break;
+
+            sMap[objectName] = data.substr(pos, dataSize);
+            pos += dataSize;
+        }
+
+        if (not valid)
+        {
+            LOG_ERROR(DOM, "Error happened when parsing binary serialized data");
+        }
+
+        return sMap;
+    }
+
+    void Serializer::registerSerialized(const std::string& objectName, const std::string& serializedString)
     {
         LOG_THIS_MEMBER(DOM);
 
         std::lock_guard<std::mutex> lock(mutex);
-        serializedMap[objectName] = serializedString.str();
+        serializedMap[objectName] = serializedString;
 
         registerToFile();
     }
@@ -1019,16 +1632,57 @@ namespace pg
     {
         LOG_THIS_MEMBER(DOM);
 
+        if (format == SerializationFormat::Binary)
+        {
+            LOG_INFO(DOM, "Writing binary file: " << file.filepath);
+
+            UniversalFileAccessor::writeToFile(file, writeBinaryData(serializedMap), true, true);
+
+            return;
+        }
+
+        const auto data = writeData(version, serializedMap);
+
+        LOG_INFO(DOM, "Writing to file: " << file.filepath << " " << data);
+
+        UniversalFileAccessor::writeToFile(file, data, true);
+    }
+
+    std::string Serializer::writeBinaryData(const std::unordered_map<std::string, std::string>& objects)
+    {
+        LOG_THIS(DOM);
+
+        // Header with the format version followed by the length prefixed name and data of each object
+        std::string data = BINARYARCHIVEMAGIC;
+
+        data.push_back(static_cast<char>(BINARYARCHIVEVERSION));
+
+        writeVarint(data, objects.size());
+
+        for (const auto& serializedString : objects)
+        {
+            writeVarint(data, serializedString.first.size());
+            data.append(serializedString.first);
+
+            writeVarint(data, serializedString.second.size());
+            data.append(serializedString.second);
+        }
+
+        return data;
+    }
+
+    std::string Serializer::writeData(const std::string& vers, const std::unordered_map<std::string, std::string>& objects)
+    {
+        LOG_THIS(DOM);
+
         std::ostringstream stream;
 
         // First line of the serialized file should be the version id of the serializer
-        stream << version << std::endl;
+        stream << vers << std::endl;
 
-        for (const auto& serializedString : serializedMap)
+        for (const auto& serializedString : objects)
             stream << serializedString.first << ": " << serializedString.second;
 
-        LOG_INFO(DOM, "Writing to file: " << file.filepath << " " << stream.str());
-
-        UniversalFileAccessor::writeToFile(file, stream.str(), true);
+        return stream.str();
     }
 }
\ No newline at end of file
@@ -12,10 +12,12 @@
  * 
  */
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -37,6 +39,11 @@ namespace pg
     {
         constexpr const char * const ARCHIVEVERSION = "1.0.0";
 
+        /** Header of a binary serialized file, followed by the version of the binary format */
+        constexpr const char * const BINARYARCHIVEMAGIC = "PGSB";
+
+        constexpr uint8_t BINARYARCHIVEVERSION = 1;
+
         /** Name of the constant string indicating an attribute */
         const std::string ATTRIBUTECONST = "__PGSA"; // Stand for PGSERIALISEDATTRIBUTE
     }
@@ -77,6 +84,9 @@ namespace pg
         Archive() { endOfLine.indentLevel = &indentLevel; }
 
         virtual ~Archive() { }
+
+        /** Check if this archive is a BinaryArchive, base types are then written as raw values instead of text */
+        inline bool isBinary() const { return binary; }
         
         /**
          * @brief Function used to put an end of line in the serialized string
@@ -155,6 +165,76 @@ namespace pg
         size_t indentLevel = 0;
         /** The custom end of line object */
         EndOfLine endOfLine;
+
+    protected:
+        Archive(bool binary) : Archive() { this->binary = binary; }
+
+    private:
+        bool binary = false;
+    };
+
+    /** Format of the data of a Serializer */
+    enum class SerializationFormat : uint8_t
+    {
+        Text,
+        Binary
+    };
+
+    /**
+     * @brief Archive writing a compact binary encoding instead of the indented text one
+     * 
+     * The same serialize functions are used for both formats: classes and string attributes go through the
+     * virtual functions of Archive while base types (bool, int, float, ...) are written as little endian raw values.
+     * 
+     * An encoded object is a table of all the names and types used in it, each one stored only once,
+     * followed by the nodes of the object. Each node is a tag (class or attribute), the index of its name and of
+     * its type in the table and the size of its body, so a reader can skip a whole class without decoding it.
+     */
+    class BinaryArchive : public Archive
+    {
+    public:
+        BinaryArchive() : Archive(true) {}
+
+        virtual ~BinaryArchive() {}
+
+        virtual void startSerialization(const std::string& className) override;
+
+        virtual void endSerialization() override;
+
+        virtual void setAttribute(const std::string& value, const std::string& type = "") override;
+
+        virtual void setValueName(const std::string& name) override { pendingName = name; }
+
+        /** Put a base type attribute as a raw little endian value */
+        void setValue(bool value, const std::string& type);
+        void setValue(int value, const std::string& type);
+        void setValue(unsigned int value, const std::string& type);
+        void setValue(float value, const std::string& type);
+        void setValue(double value, const std::string& type);
+        void setValue(size_t value, const std::string& type);
+
+        /** Get the encoded object: its name table followed by its nodes */
+        std::string str() const;
+
+    private:
+        /** Write the tag, name and type of a new node, the name being the one set by the last setValueName */
+        void startNode(uint8_t tag, const std::string& type);
+
+        /** Write a raw value, its size first */
+        void writeRawValue(uint64_t value, size_t nbBytes, const std::string& type);
+
+        /** Get the index of a name in the name table, adding it if needed */
+        size_t intern(const std::string& name);
+
+        std::string nodes;
+
+        std::vector<std::string> names;
+        std::unordered_map<std::string, size_t> nameIds;
+
+        /** Positions of the size of the classes not ended yet */
+        std::vector<size_t> openedClasses;
+
+        std::string pendingName;
     };
 
     // TODO make a specialized renderer for std::nullptr_t to catch nullptr error ?; 
@@ -211,6 +291,18 @@ namespace pg
     template <>
     void serialize(Archive& archive, const constant::ModelInfo& modelInfo);
 
+    /**
+     * @brief Read only view of a serialized object, parsed on demand
+     * 
+     * The serialized data is copied once in a buffer shared by the object and all of its children,
+     * each node only holds views into this buffer.
+     * 
+     * Only the header of the object (its name, type and kind) is parsed at construction. Its direct children
+     * are indexed on the first access to them and each child is only parsed when it is accessed in turn,
+     * so reading one value out of a large object doesn't touch nor copy the rest of it.
+     * 
+     * @warning The lazy indexing mutates the object, so a same object must not be read from multiple threads at once
+     */
     class UnserializedObject
     {
         struct Attribute
@@ -218,15 +310,40 @@ namespace pg
             std::string name = "";
             std::string value = "";
         };
+
+        /** Storage shared by all the nodes parsed from a same serialized data */
+        struct Buffer
+        {
+            std::string data;
+
+            /** Name and type given at construction, the nodes parsed from data use views into data instead */
+            std::string name;
+            std::string type;
+
+            /** Name table of a binary object, views into data */
+            std::vector<std::string_view> names;
+        };
+
     public:
         UnserializedObject() : isNullObject(true), isClass(false) { }
-        UnserializedObject(const std::string& serializedString, const std::string& objectName = "", bool isClass = true) : objectName(objectName), serializedString(serializedString), isNullObject(false), isClass(isClass) { if (isClass) parseString(); }
-        UnserializedObject(const std::string& objectName, const std::string& objectType, const std::string& serializedString) : objectName(objectName), objectType(objectType), serializedString(serializedString), isNullObject(false), isClass(true) {}
+        UnserializedObject(const std::string& serializedString, const std::string& objectName = "", bool isClass = true);
 
-        const std::string& getObjectName() const { return objectName; }
+        /** Create a class object whose children are added by hand with addChild */
+        UnserializedObject(const std::string& objectName, const std::string& objectType, const std::string& serializedString);
 
-        // Todo add
-        const std::string& getObjectType() const { return objectType; }
+        /**
+         * @brief Decode an object encoded by a BinaryArchive
+         * 
+         * @param data The encoded object (see BinaryArchive::str)
+         * @param objectName Name of the object
+         * 
+         * @return The decoded object, a null object if the data is ill formed
+         */
+        static UnserializedObject fromBinary(const std::string& data, const std::string& objectName = "");
+
+        inline std::string_view getObjectName() const { return objectName; }
+
+        inline std::string_view getObjectType() const { return objectType; }
 
         /**
          * @brief Return the object as an Attribute object.
@@ -240,33 +357,70 @@ namespace pg
 
         inline bool isClassObject() const { return isClass; }
 
-        const UnserializedObject& operator[](const std::string& key);
+        /** Check if the object was decoded from a binary archive, its attributes then hold raw values */
+        inline bool isBinary() const { return binary; }
+
         const UnserializedObject& operator[](const std::string& key) const;
 
-        const UnserializedObject& operator[](size_t id);
         const UnserializedObject& operator[](size_t id) const;
 
-        size_t getNbChildren() const { return children.size(); }
+        /** Get the children of the object, the first one is always an empty one for a parsed class */
+        const std::vector<UnserializedObject>& getChildren() const { indexChildren(); return children; }
 
-        std::string getString() const { return serializedString; }
+        size_t getNbChildren() const { return getChildren().size(); }
 
-    public:
-        std::vector<UnserializedObject> children;
+        /** Add a child to an object created by hand */
+        void addChild(const UnserializedObject& child);
+
+        std::string getString() const { return std::string(serializedString); }
+
+        /** Get the encoded value of a binary attribute, without copying it */
+        inline std::string_view getRawValue() const { return serializedString; }
 
     private:
+        /** Parse the header of a text object: check its name and read its type */
         void parseString();
 
-        std::string objectName;
-        std::string objectType;
-        std::string serializedString;
+        /** Index the direct children of the object, only done once */
+        void indexChildren() const;
+
+        void indexTextChildren() const;
+
+        void indexBinaryChildren() const;
+
+        /** Create the child of a text class spanning text (a view into the buffer) */
+        UnserializedObject makeTextChild(std::string_view text, bool isChildClass) const;
+
+        /** Read the header of the node starting at pos in the buffer, moving pos past the whole node */
+        bool parseBinaryNode(size_t& pos);
+
+        std::shared_ptr<const Buffer> buffer;
+
+        std::string_view objectName;
+        std::string_view objectType;
+
+        /** Whole text of a text object, value of a binary attribute or body of a binary class */
+        std::string_view serializedString;
+
+        mutable std::vector<UnserializedObject> children;
+        mutable bool indexed = false;
         
         bool isNullObject = false;
         bool isClass = true;
+        bool binary = false;
     };
 
     template <typename Type>
     Type deserialize(const UnserializedObject& name);
 
+    /**
+     * @brief Write an already serialized object back in an archive
+     * 
+     * The object is rewritten node by node, so an object read from a text archive can be written in a binary one and vice versa.
+     */
+    template <>
+    void serialize(Archive& archive, const UnserializedObject& value);
+
     // Todo add a version header for serialization
 
     class Serializer
@@ -275,7 +429,7 @@ namespace pg
         {
         friend class Serializer;
             ClassSerializer(Serializer *ser, const std::string& objectName) : serializer(ser), objectName(objectName) {}
-            ~ClassSerializer() { archive.container << std::endl; serializer->registerSerialized(objectName, archive.container); }
+            ~ClassSerializer() { archive.container << std::endl; serializer->registerSerialized(objectName, archive.container.str()); }
         
         public:
             Archive archive;
@@ -295,40 +449,82 @@ namespace pg
 
         void clear() { serializedMap.clear(); }
 
+        /**
+         * @brief Set the format used to write the file
+         * 
+         * The format of an existing file is picked from its header when it is opened, so this is only needed for new files.
+         * It can't be changed while the serializer holds objects of the other format, clear it first.
+         */
+        void setFormat(SerializationFormat format);
+
+        inline SerializationFormat getFormat() const { return format; }
+
         // Todo remove baseIndent when removing indent need from serializer
         static std::unordered_map<std::string, std::string> readData(const std::string& vers, const std::string& stringData, size_t baseIndent = 0);
 
+        /** Content of a text file holding the given serialized objects, the counterpart of readData */
+        static std::string writeData(const std::string& vers, const std::unordered_map<std::string, std::string>& objects);
+
         static std::unique_ptr<Serializer>& getSerializer(const std::string& filename = "serialize.sz")
             {static std::unique_ptr<Serializer> serializer = std::unique_ptr<Serializer>(new Serializer(filename)); return serializer; }
 
         // Todo make a static_assert to check if ": " is present in the objectName and reject it at compile time
         template <typename Type>
-        void serializeObject(const std::string& objectName, const Type& type) { ClassSerializer ar(this, objectName); serialize(ar.archive, type); }
+        void serializeObject(const std::string& objectName, const Type& type)
+        {
+            if (format == SerializationFormat::Binary)
+            {
+                BinaryArchive archive;
+
+                serialize(archive, type);
+
+                registerSerialized(objectName, archive.str());
+            }
+            else
+            {
+                ClassSerializer ar(this, objectName);
+                serialize(ar.archive, type);
+            }
+        }
 
         template <typename Type>
         Type deserializeObject(const std::string& objectName) const
         { 
             const auto& it = serializedMap.find(objectName);
 
-            if (it != serializedMap.end())
-                return deserialize<Type>(UnserializedObject(it->second, objectName)); 
-            else 
+            if (it == serializedMap.end())
                 return deserialize<Type>(UnserializedObject());
+            else if (format == SerializationFormat::Binary)
+                return deserialize<Type>(UnserializedObject::fromBinary(it->second, objectName));
+            else
+                return deserialize<Type>(UnserializedObject(it->second, objectName)); 
         }
 
         const std::unordered_map<std::string, std::string>& getSerializedMap() const { return serializedMap; }
 
         inline const std::string& getVersion() { return version; }
 
+        /** Split the objects of a binary file (header included), the counterpart of readData for the binary format */
+        static std::unordered_map<std::string, std::string> readBinaryData(const std::string& data);
+
+        /** Content of a binary file holding the given encoded objects, the counterpart of readBinaryData */
+        static std::string writeBinaryData(const std::unordered_map<std::string, std::string>& objects);
+
     private:
         Serializer(const std::string& filename);
+
+        /** Open a file as is if it is a binary one, as a text file otherwise */
+        static TextFile openFile(const std::string& path);
+
         void readFile(const std::string& data);
 
-        void registerSerialized(const std::string& objectName, const std::stringstream& serializedString);
+        void registerSerialized(const std::string& objectName, const std::string& serializedString);
         void registerToFile() const;
 
         bool autoSave = true;
 
+        SerializationFormat format = SerializationFormat::Text;
+
         TextFile file;
         std::mutex mutex;
 
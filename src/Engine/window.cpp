@@ -390,6 +390,9 @@ namespace pg
 
         // Ecs task scheduling
 
+        // The render thread draws at its own pace, the ecs only needs to produce a new state at the display rate
+        ecs.setTickRate(60);
+
         ecs.succeed<TickingSystem, PgInterpreter>();
 
         ecs.succeed<TimerSystem, TickingSystem>();
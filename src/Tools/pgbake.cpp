@@ -0,0 +1,33 @@
+#include <iostream>
+#include <filesystem>
+
+#include "Scene/prefab.h"
+
+/**
+ * Bake tool: compile text scene files (.sz) into binary prefabs (.pgp) loaded by pg::Prefab::loadFile
+ *
+ * Usage: PgBake <scene.sz> [<prefab.pgp>]
+ * Without an output path the prefab is written next to the scene, with the .pgp extension.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <scene.sz> [<prefab.pgp>]" << std::endl;
+        return 1;
+    }
+
+    const std::string scenePath = argv[1];
+
+    const std::string prefabPath = argc > 2 ? argv[2] : std::filesystem::path(scenePath).replace_extension(".pgp").string();
+
+    if (not pg::Prefab::bakeFile(scenePath, prefabPath))
+    {
+        std::cerr << "Couldn't bake '" << scenePath << "'" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Baked '" << scenePath << "' into '" << prefabPath << "'" << std::endl;
+
+    return 0;
+}
@@ -6,12 +6,27 @@
 #include "ECS/componentregistry.h"
 #include "ECS/entitysystem.h"
 
+#include "Systems/oneventcomponent.h"
+#include "Systems/coresystems.h"
+
+#include "2D/simple2dobject.h"
+#include "2D/texture.h"
+#include "2D/collisionsystem.h"
+#include "UI/sentencesystem.h"
+#include "UI/ttftext.h"
+#include "Input/inputcomponent.h"
+
 #include "mocklogger.h"
 
 #include <iostream>
 #include <string>
+#include <sstream>
 
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <set>
+#include <utility>
 
 namespace pg
 {
@@ -53,6 +68,15 @@ namespace pg
                 virtual void execute() { }
             };
 
+            struct ABGroupSystem : public System<Ref<A>, Ref<B>, InitSys>
+            {
+                virtual void init() override { group = registerGroup<A, B>(); }
+
+                virtual void execute() { }
+
+                Group<A, B>* group = nullptr;
+            };
+
             struct C
             {
                 C(_unique_id value, const std::string& text) : value(value), text(text) {}
@@ -188,6 +212,381 @@ namespace pg
                 }
             };
 
+            struct PackedComp : public PackedStorage
+            {
+                PackedComp(int value) : value(value) {}
+
+                int value;
+            };
+
+            struct PackedSystem : public System<Own<PackedComp>, StoragePolicy> { };
+
+            struct H
+            {
+                H(int value) : value(value) {}
+
+                int value;
+            };
+
+            struct I : public PackedStorage
+            {
+                I(int value) : value(value) {}
+
+                int value;
+            };
+
+            struct HISystem : public System<Own<H>, Own<I>, StoragePolicy> { };
+
+            struct SpawnerSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    if (spawned)
+                        return;
+
+                    spawned = true;
+
+                    auto entities = ecsRef->createEntities(50);
+
+                    ecsRef->attachBulk<A>(entities, [](size_t i) { return A(static_cast<int>(i), 10); });
+                }
+
+                bool spawned = false;
+            };
+
+            struct ValueEvent
+            {
+                ValueEvent(int value) : value(value) {}
+
+                const int value;
+            };
+
+            struct OtherValueEvent
+            {
+                OtherValueEvent(int value) : value(value) {}
+
+                const int value;
+            };
+
+            struct ValueListenerSystem : public System<Listener<ValueEvent>, Listener<OtherValueEvent>>
+            {
+                virtual void onEvent(const ValueEvent& event) override { received.push_back(event.value); }
+
+                virtual void onEvent(const OtherValueEvent& event) override { received.push_back(-event.value); }
+
+                virtual void execute() override { }
+
+                std::vector<int> received;
+            };
+
+            struct ValueSenderSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    if (sent)
+                        return;
+
+                    sent = true;
+
+                    ecsRef->sendEvent(ValueEvent{1});
+                    ecsRef->sendEvent(OtherValueEvent{2});
+                    ecsRef->sendEvent(ValueEvent{3});
+                }
+
+                bool sent = false;
+            };
+
+            /** The renderers need the shaders of a window in their init, only their registration matters here */
+            struct NoInitSimple2DObjectSystem : public Simple2DObjectSystem
+            {
+                NoInitSimple2DObjectSystem(MasterRenderer* masterRenderer) : Simple2DObjectSystem(masterRenderer) {}
+
+                virtual void init() override {}
+            };
+
+            struct NoInitTexture2DComponentSystem : public Texture2DComponentSystem
+            {
+                NoInitTexture2DComponentSystem(MasterRenderer* masterRenderer) : Texture2DComponentSystem(masterRenderer) {}
+
+                virtual void init() override {}
+            };
+
+            struct NoInitSentenceSystem : public SentenceSystem
+            {
+                NoInitSentenceSystem(MasterRenderer* masterRenderer) : SentenceSystem(masterRenderer, "res/font/fontmap.ft") {}
+
+                virtual void init() override {}
+            };
+
+            struct NoInitTTFTextSystem : public TTFTextSystem
+            {
+                NoInitTTFTextSystem(MasterRenderer* masterRenderer) : TTFTextSystem(masterRenderer) {}
+
+                virtual void init() override {}
+            };
+
+            struct NamedCounterSystem : public System<NamedSystem>
+            {
+                virtual std::string getSystemName() const override { return "Named Counter"; }
+
+                virtual void execute() override { nbRuns++; }
+
+                size_t nbRuns = 0;
+            };
+
+            struct FrameDataSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    FrameVector<int> values(ecsRef->frameAllocator<int>());
+                    values.reserve(8);
+
+                    for (int i = 0; i < 8; i++)
+                        values.push_back(i);
+
+                    sum = 0;
+
+                    for (auto value : values)
+                        sum += value;
+
+                    usedWorkerArena = ecsRef->isExecutorWorker();
+                }
+
+                int sum = 0;
+
+                bool usedWorkerArena = false;
+            };
+
+            struct KeyedEvent
+            {
+                _unique_id id;
+                int value;
+
+                _unique_id coalescingKey() const { return id; }
+            };
+
+            struct KeyedBatchSystem : public System<BatchListener<KeyedEvent>>
+            {
+                virtual void onEvents(const std::vector<KeyedEvent>& events) override
+                {
+                    nbBatches++;
+
+                    for (const auto& event : events)
+                        received.push_back(event);
+                }
+
+                virtual void execute() override
+                {
+                    if (sent)
+                        return;
+
+                    sent = true;
+
+                    ecsRef->sendEvent(KeyedEvent{1, 1});
+                    ecsRef->sendEvent(KeyedEvent{2, 2});
+                    ecsRef->sendEvent(KeyedEvent{1, 3});
+                    ecsRef->sendEvent(KeyedEvent{1, 4});
+                }
+
+                bool sent = false;
+
+                size_t nbBatches = 0;
+
+                std::vector<KeyedEvent> received;
+            };
+
+            struct RestructureSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    if (done)
+                        return;
+
+                    done = true;
+
+                    // Two components of the same entity removed in the same tick
+                    ecsRef->detach<A>(target);
+                    ecsRef->detach<B>(target);
+
+                    // Deduplicated with the previous one
+                    ecsRef->detach<A>(target);
+
+                    for (int i = 0; i < 3; i++)
+                    {
+                        auto entity = ecsRef->createEntity();
+
+                        auto b = ecsRef->attach<B>(entity, i, 0);
+                        ecsRef->attach<A>(entity, i, 0);
+
+                        // The pending component can be tweaked until the sync point
+                        b->value += 10;
+                    }
+                }
+
+                EntityRef target;
+
+                bool done = false;
+            };
+
+            struct TransientSpawnerSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    if (done)
+                        return;
+
+                    done = true;
+
+                    // Created and removed before the sync point, it must never reach the pool
+                    auto transient = ecsRef->createEntity();
+
+                    ecsRef->attach<A>(transient, 1, 0);
+
+                    ecsRef->removeEntity(transient);
+
+                    transientId = transient.id;
+                }
+
+                _unique_id transientId = 0;
+
+                bool done = false;
+            };
+
+            struct Counter
+            {
+                int value = 0;
+            };
+
+            struct CounterSystem : public System<Own<Counter>, StoragePolicy> { };
+
+            struct IncrementSystem : public System<Ref<Counter>>
+            {
+                virtual void execute() override
+                {
+                    auto list = view<Counter>();
+
+                    for (size_t i = 1; i < list.nbComponents(); i++)
+                    {
+                        list[i]->value++;
+                    }
+                }
+            };
+
+            struct TrackedIncrementSystem : public System<Ref<Counter>>
+            {
+                virtual void execute() override
+                {
+                    for (const auto& id : ids)
+                    {
+                        ecsRef->getComponent<Counter>(id)->value++;
+                        ecsRef->markChanged<Counter>(id);
+                    }
+                }
+
+                std::vector<_unique_id> ids;
+            };
+
+            struct ReadCounterSystem : public System<ReadRef<Counter>>
+            {
+                virtual void execute() override { lastValue = view<Counter>()[1]->value; }
+
+                int lastValue = -1;
+            };
+
+            struct OtherReadCounterSystem : public System<ReadRef<Counter>>
+            {
+                virtual void execute() override { lastValue = view<Counter>()[1]->value; }
+
+                int lastValue = -1;
+            };
+
+            struct RuntimeCounterSystem : public System<>
+            {
+                RuntimeCounterSystem(std::atomic<int> *nbRuns) : nbRuns(nbRuns) {}
+
+                virtual void execute() override { (*nbRuns)++; }
+
+                std::atomic<int> *nbRuns;
+            };
+
+            struct OnEventCounterSystem : public System<Listener<ValueEvent>, OnEventPolicy>
+            {
+                virtual void onEvent(const ValueEvent& event) override { lastValue = event.value; }
+
+                virtual void execute() override { nbRuns++; }
+
+                int lastValue = 0;
+
+                size_t nbRuns = 0;
+            };
+
+            struct FixedRateCounterSystem : public System<FixedRate<20>>
+            {
+                virtual void execute() override { nbRuns++; }
+
+                std::atomic<size_t> nbRuns = 0;
+            };
+
+            template <int N>
+            struct TypedRuntimeSystem : public System<>
+            {
+                virtual void execute() override {}
+            };
+
+            /** Create new system types on its first run, while the other systems keep looking up type ids */
+            struct TypeSpawnerSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    if (spawned)
+                        return;
+
+                    spawned = true;
+
+                    spawn(std::make_integer_sequence<int, 8>{});
+                }
+
+                template <int... N>
+                void spawn(std::integer_sequence<int, N...>) { (ecsRef->createSystem<TypedRuntimeSystem<N>>(), ...); }
+
+                bool spawned = false;
+            };
+
+            template <int N>
+            struct TypeLookupSystem : public System<>
+            {
+                virtual void execute() override
+                {
+                    for (size_t i = 0; i < 1000; i++)
+                    {
+                        if (ecsRef->getSystem<TypeSpawnerSystem>())
+                            nbFound++;
+                    }
+                }
+
+                size_t nbFound = 0;
+            };
+
+            /** Create a runtime counter system on its first run and delete it on its third one */
+            struct SystemSpawnerSystem : public System<>
+            {
+                SystemSpawnerSystem(std::atomic<int> *nbRuns) : nbRuns(nbRuns) {}
+
+                virtual void execute() override
+                {
+                    nbExecutions++;
+
+                    if (nbExecutions == 1)
+                        ecsRef->createSystem<RuntimeCounterSystem>(nbRuns);
+                    else if (nbExecutions == 3)
+                        ecsRef->deleteSystem<RuntimeCounterSystem>();
+                }
+
+                std::atomic<int> *nbRuns;
+
+                size_t nbExecutions = 0;
+            };
+
         }
 
         // ----------------------------------------------------------------------------------------
@@ -444,10 +843,11 @@ namespace pg
 
             const auto& allEntities = ecs.view();
 
-            EXPECT_EQ(allEntities[1]->id, 4);
-            EXPECT_EQ(allEntities[2]->id, 6);
-            EXPECT_EQ(allEntities[3]->id, 7);
-            EXPECT_EQ(allEntities[4]->id, 8);
+            // The index of entity1 got recycled with a new generation
+            EXPECT_EQ(allEntities[1]->id, 1);
+            EXPECT_EQ(allEntities[2]->id, 3);
+            EXPECT_EQ(allEntities[3]->id, makeEntityId(2, 1));
+            EXPECT_EQ(allEntities[4]->id, 4);
 
             ecs.removeEntity(entity0);
             ecs.removeEntity(entity1bis);
@@ -496,11 +896,11 @@ namespace pg
 
             const auto& allEntities = ecs.view();
 
-            EXPECT_EQ(allEntities[1]->id, 4);
-            EXPECT_EQ(allEntities[2]->id, 7);
-            EXPECT_EQ(allEntities[3]->id, 6);
-            EXPECT_EQ(allEntities[4]->id, 8);
-            EXPECT_EQ(allEntities[5]->id, 9);
+            EXPECT_EQ(allEntities[1]->id, 1);
+            EXPECT_EQ(allEntities[2]->id, 4);
+            EXPECT_EQ(allEntities[3]->id, 3);
+            EXPECT_EQ(allEntities[4]->id, makeEntityId(2, 1));
+            EXPECT_EQ(allEntities[5]->id, 5);
 
             ecs.removeEntity(entity0);
             ecs.removeEntity(entity1bis);
@@ -901,5 +1301,1351 @@ namespace pg
             //     ecs.attach<A>(entity, static_cast<int>(i), 15);
             // }
         }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, packed_component_storage)
+        {
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<PackedSystem>();
+
+            std::vector<EntityRef> entities;
+
+            for (int i = 0; i < 100; i++)
+            {
+                entities.push_back(ecs.createEntity());
+                ecs.attach<PackedComp>(entities.back(), i);
+            }
+
+            // Keep a reference to the last component, it will be moved by the removals
+            auto lastComp = entities.back().get<PackedComp>();
+
+            EXPECT_EQ(lastComp->value, 99);
+
+            for (int i = 0; i < 50; i++)
+            {
+                ecs.detach<PackedComp>(entities[i]);
+            }
+
+            auto list = sys->view<PackedComp>();
+
+            EXPECT_EQ(list.nbComponents(), 51);
+
+            // Components are stored contiguously in the set
+            for (size_t i = 2; i < list.nbComponents(); i++)
+            {
+                EXPECT_EQ(list[i], list[i - 1] + 1);
+            }
+
+            int sum = 0;
+
+            for (const auto& comp : list)
+                sum += comp->value;
+
+            EXPECT_EQ(sum, (50 + 99) * 50 / 2);
+
+            // The reference is still valid as it fetch the component back from the entity id
+            EXPECT_EQ(lastComp->value, 99);
+            EXPECT_EQ(static_cast<PackedComp*>(lastComp), ecs.getComponent<PackedComp>(entities.back().id));
+
+            ecs.attach<PackedComp>(entities.back(), 5);
+
+            EXPECT_EQ(lastComp->value, 5);
+            EXPECT_EQ(sys->view<PackedComp>().nbComponents(), 51);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, multi_component_view)
+        {
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+            ecs.createSystem<ABSystem>();
+
+            std::vector<EntityRef> entities;
+
+            for (int i = 0; i < 30; i++)
+            {
+                entities.push_back(ecs.createEntity());
+
+                if (i % 2 == 0)
+                    ecs.attach<A>(entities.back(), i, 0);
+
+                if (i % 3 == 0)
+                    ecs.attach<B>(entities.back(), i, 0);
+            }
+
+            size_t nbElements = 0;
+            int sum = 0;
+
+            for (const auto& elem : ecs.view<A, B>())
+            {
+                EXPECT_TRUE(elem.entity.has<A>());
+                EXPECT_TRUE(elem.entity.has<B>());
+
+                EXPECT_EQ(elem.get<A>()->value, elem.get<B>()->value);
+
+                sum += elem.get<A>()->value;
+                nbElements++;
+            }
+
+            // Only the multiples of 6 have both components
+            EXPECT_EQ(nbElements, 5);
+            EXPECT_EQ(sum, 0 + 6 + 12 + 18 + 24);
+
+            ecs.detach<A>(entities[6]);
+
+            nbElements = 0;
+
+            for (const auto& elem : ecs.view<B, A>())
+            {
+                EXPECT_NE(elem.entity.id, entities[6].id);
+                nbElements++;
+            }
+
+            EXPECT_EQ(nbElements, 4);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, owning_group)
+        {
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<HISystem>();
+
+            std::vector<EntityRef> entities;
+
+            for (int i = 0; i < 40; i++)
+            {
+                entities.push_back(ecs.createEntity());
+
+                if (i % 2 == 0)
+                    ecs.attach<H>(entities.back(), i);
+
+                // Half of the components are attached after the creation of the group
+                if (i % 4 == 0 and i < 20)
+                    ecs.attach<I>(entities.back(), i);
+            }
+
+            // The group sorts the sets that are already populated on creation
+            auto group = sys->registerOwningGroup<H, I>();
+
+            ASSERT_NE(group, nullptr);
+
+            EXPECT_EQ(group->size(), 5);
+
+            // A set can only be owned by one group
+            auto secondGroup = sys->registerOwningGroup<I, H>();
+
+            EXPECT_EQ(secondGroup, nullptr);
+
+            for (int i = 20; i < 40; i += 4)
+                ecs.attach<I>(entities[i], i);
+
+            auto checkGroup = [&](size_t expectedSize) {
+                EXPECT_EQ(group->size(), expectedSize);
+
+                const auto hList = sys->view<H>();
+                const auto iList = sys->view<I>();
+
+                // The members of the group are packed at the start of both sets in the same order
+                for (size_t i = 1; i <= group->size(); i++)
+                {
+                    EXPECT_EQ(hList[i], group->get<H>(i));
+                    EXPECT_EQ(iList[i], group->get<I>(i));
+                    EXPECT_EQ(hList[i]->value, iList[i]->value);
+                }
+
+                size_t nbElements = 0;
+
+                group->each([&nbElements](H* h, I* i) {
+                    EXPECT_EQ(h->value % 2, 0);
+                    EXPECT_EQ(h->value, i->value);
+                    nbElements++;
+                });
+
+                EXPECT_EQ(nbElements, expectedSize);
+            };
+
+            checkGroup(10);
+
+            ecs.detach<H>(entities[8]);
+            ecs.removeEntity(entities[0]);
+
+            checkGroup(8);
+
+            ecs.attach<H>(entities[8], 8);
+            ecs.attach<I>(entities[2], 2);
+
+            checkGroup(10);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, derived_task_dependencies)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<CounterSystem>();
+            auto increment = ecs.createSystem<IncrementSystem>();
+            auto read = ecs.createSystem<ReadCounterSystem>();
+            auto otherRead = ecs.createSystem<OtherReadCounterSystem>();
+
+            EXPECT_EQ(ecs.getNbTasks(), 3);
+
+            EXPECT_TRUE(increment->conflictsWith(read));
+            EXPECT_TRUE(read->conflictsWith(increment));
+            EXPECT_FALSE(read->conflictsWith(otherRead));
+
+            auto entity = ecs.createEntity();
+            ecs.attach<Counter>(entity);
+
+            // The readers are registered after the writer so they always see the incremented value
+            ecs.executeOnce();
+
+            EXPECT_EQ(read->lastValue, 1);
+            EXPECT_EQ(otherRead->lastValue, 1);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(read->lastValue, 2);
+            EXPECT_EQ(otherRead->lastValue, 2);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, ui_readers_are_unordered)
+        {
+            MockLogger logger;
+
+            MasterRenderer masterRenderer;
+
+            EntitySystem ecs;
+
+            auto uiSystem = ecs.createSystem<UiComponentSystem>();
+
+            std::vector<AbstractSystem*> readers;
+
+            readers.push_back(ecs.createMockSystem<Simple2DObjectSystem, NoInitSimple2DObjectSystem>(&masterRenderer));
+            readers.push_back(ecs.createMockSystem<Texture2DComponentSystem, NoInitTexture2DComponentSystem>(&masterRenderer));
+            readers.push_back(ecs.createMockSystem<SentenceSystem, NoInitSentenceSystem>(&masterRenderer));
+            readers.push_back(ecs.createMockSystem<TTFTextSystem, NoInitTTFTextSystem>(&masterRenderer));
+            readers.push_back(ecs.createSystem<CollisionSystem>());
+
+            // The callbacks of the mouse systems can modify the ui components
+            std::vector<AbstractSystem*> writers = {uiSystem};
+
+            writers.push_back(ecs.createSystem<MouseClickSystem>(nullptr));
+            writers.push_back(ecs.createSystem<MouseLeaveClickSystem>(nullptr));
+
+            // The systems that only read the ui components get no derived dependency between them
+            for (size_t i = 0; i < readers.size(); i++)
+            {
+                for (const auto& writer : writers)
+                    EXPECT_TRUE(writer->conflictsWith(readers[i]));
+
+                for (size_t j = 0; j < readers.size(); j++)
+                {
+                    if (i == j)
+                        continue;
+
+                    EXPECT_FALSE(readers[i]->conflictsWith(readers[j])) << "Systems " << i << " and " << j << " are ordered";
+                }
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, manual_ordering_over_derived_dependencies)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<CounterSystem>();
+            ecs.createSystem<IncrementSystem>();
+            auto read = ecs.createSystem<ReadCounterSystem>();
+            auto otherRead = ecs.createSystem<OtherReadCounterSystem>();
+
+            // Reverse the registration order for the first reader only
+            ecs.succeed<IncrementSystem, ReadCounterSystem>();
+
+            auto entity = ecs.createEntity();
+            ecs.attach<Counter>(entity);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(read->lastValue, 0);
+            EXPECT_EQ(otherRead->lastValue, 1);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(read->lastValue, 1);
+            EXPECT_EQ(otherRead->lastValue, 2);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, parallel_for_each)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+            ecs.createSystem<ABSystem>();
+            ecs.createSystem<PackedSystem>();
+
+            constexpr size_t nbEntities = 1000;
+
+            std::vector<_unique_id> ids;
+
+            for (size_t i = 0; i < nbEntities; i++)
+            {
+                auto entity = ecs.createEntity();
+
+                ids.push_back(entity.id);
+
+                ecs.attach<A>(entity, static_cast<int>(i), 0);
+                ecs.attach<PackedComp>(entity, static_cast<int>(i));
+
+                if (i % 3 == 0)
+                    ecs.attach<B>(entity, static_cast<int>(i), 0);
+            }
+
+            ecs.view<A>().parallelForEach([](A* a) { a->value *= 2; }, 10);
+            ecs.view<PackedComp>().parallelForEach([](PackedComp* comp) { comp->value += 1; });
+
+            for (size_t i = 0; i < nbEntities; i++)
+            {
+                EXPECT_EQ(ecs.getComponent<A>(ids[i])->value, 2 * static_cast<int>(i));
+                EXPECT_EQ(ecs.getComponent<PackedComp>(ids[i])->value, static_cast<int>(i) + 1);
+            }
+
+            std::atomic<size_t> nbElements = 0;
+
+            ecs.view<A, B>().parallelForEach([&nbElements](const CompList<A, B>& list) {
+                EXPECT_EQ(list.get<A>()->value, 2 * list.get<B>()->value);
+
+                list.get<B>()->value = -1;
+
+                nbElements++;
+            }, 8);
+
+            EXPECT_EQ(nbElements, (nbEntities + 2) / 3);
+
+            for (const auto& b : ecs.view<B>())
+                EXPECT_EQ(b->value, -1);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, parallel_timer_update)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto timerSys = ecs.createSystem<TimerSystem>();
+
+            for (size_t i = 0; i < 1000; i++)
+            {
+                auto entity = ecs.createEntity();
+                auto timer = ecs.attach<Timer>(entity);
+
+                timer->interval = i % 7 + 1;
+
+                if (i % 2 == 0)
+                    timer->start();
+            }
+
+            timerSys->currentIncrement = 10;
+            timerSys->execute();
+
+            size_t i = 0;
+
+            for (const auto& timer : ecs.view<Timer>())
+            {
+                EXPECT_EQ(timer->currentTime, timer->running ? 10 % timer->interval : 0);
+                EXPECT_EQ(timer->nbTriggers, 0);
+
+                i++;
+            }
+
+            EXPECT_EQ(i, 1000);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, batch_creation)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+            ecs.createSystem<PackedSystem>();
+
+            constexpr size_t nbEntities = 500;
+
+            auto entities = ecs.createEntities(nbEntities);
+
+            ASSERT_EQ(entities.size(), nbEntities);
+            EXPECT_EQ(ecs.getNbEntities(), nbEntities);
+
+            for (size_t i = 1; i < nbEntities; i++)
+                EXPECT_EQ(entities[i].id, entities[0].id + i);
+
+            auto comps = ecs.attachBulk<A>(entities, [](size_t i) { return A(static_cast<int>(i), 1); });
+            auto packedComps = ecs.attachBulk<PackedComp>(entities, [](size_t i) { return PackedComp(static_cast<int>(i)); });
+
+            ASSERT_EQ(comps.size(), nbEntities);
+            ASSERT_EQ(packedComps.size(), nbEntities);
+
+            EXPECT_EQ(ecs.view<A>().nbComponents() - 1, nbEntities);
+
+            for (size_t i = 0; i < nbEntities; i++)
+            {
+                EXPECT_EQ(comps[i]->value, static_cast<int>(i) + 1);
+                EXPECT_EQ(packedComps[i]->value, static_cast<int>(i));
+                EXPECT_TRUE(entities[i].has<A>());
+                EXPECT_EQ(ecs.getComponent<A>(entities[i].id)->value, static_cast<int>(i) + 1);
+            }
+
+            std::vector<EntityRef> toRemove(entities.begin(), entities.begin() + 100);
+
+            ecs.removeEntities(toRemove);
+
+            EXPECT_EQ(ecs.getNbEntities(), nbEntities - 100);
+            EXPECT_EQ(ecs.view<A>().nbComponents() - 1, nbEntities - 100);
+            EXPECT_EQ(ecs.view<PackedComp>().nbComponents() - 1, nbEntities - 100);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, batch_creation_while_running)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto aSys = ecs.createSystem<ASystem>();
+            ecs.createSystem<SpawnerSystem>();
+
+            EXPECT_EQ(ecs.getNbEntities(), 0);
+
+            // The batch is queued during the first run and created by the command dispatcher on the next one
+            ecs.executeOnce();
+
+            EXPECT_EQ(ecs.getNbEntities(), 0);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(ecs.getNbEntities(), 50);
+            EXPECT_EQ(aSys->getNbComponents() - 1, 50);
+
+            int sum = 0;
+
+            for (const auto& a : ecs.view<A>())
+                sum += a->value;
+
+            // Sum of i + 10 for i in [0, 50[
+            EXPECT_EQ(sum, 1225 + 500);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, entity_id_recycling)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+
+            auto entity = ecs.createEntity();
+            auto comp = ecs.attach<A>(entity, 1, 2);
+
+            const auto oldId = entity.id;
+
+            EXPECT_TRUE(entity.isAlive());
+            EXPECT_TRUE(comp.isAlive());
+
+            ecs.removeEntity(entity);
+
+            EXPECT_FALSE(entity.isAlive());
+            EXPECT_FALSE(comp.isAlive());
+
+            // The new entity reuses the index of the deleted one with the next generation
+            auto newEntity = ecs.createEntity();
+
+            EXPECT_EQ(entityIndex(newEntity.id), entityIndex(oldId));
+            EXPECT_EQ(entityGeneration(newEntity.id), entityGeneration(oldId) + 1);
+
+            ecs.attach<A>(newEntity, 3, 4);
+
+            // The stale references don't see the new entity
+            EXPECT_FALSE(entity.isAlive());
+            EXPECT_FALSE(comp.isAlive());
+            EXPECT_EQ(ecs.getEntity(oldId), nullptr);
+            EXPECT_EQ(ecs.getComponent<A>(oldId), nullptr);
+            EXPECT_EQ(ecs.getComponent<A>(newEntity.id)->value, 7);
+
+            ecs.removeEntity(newEntity);
+
+            // Creating and deleting entities over and over doesn't grow the sparse arrays
+            for (size_t i = 0; i < 1000; i++)
+            {
+                auto entities = ecs.createEntities(10);
+
+                for (auto& ent : entities)
+                    ecs.attach<A>(ent, 0, 0);
+
+                ecs.removeEntities(entities);
+            }
+
+            EXPECT_EQ(ecs.getNbEntities(), 0);
+
+            for (size_t i = 0; i < 10; i++)
+                EXPECT_LE(entityIndex(ecs.createEntity().id), 10);
+
+            // Type ids live in their own space
+            EXPECT_EQ(ecs.getId<A>(), ecs.getComponentRegistry()->getTypeId<A>());
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, typed_event_dispatch)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto listener = ecs.createSystem<ValueListenerSystem>();
+            ecs.createSystem<ValueSenderSystem>();
+            ecs.createSystem<OnEventComponentSystem>();
+
+            // Not running, the event is dispatched right away
+            ecs.sendEvent(ValueEvent{0});
+
+            ASSERT_EQ(listener->received.size(), 1);
+            EXPECT_EQ(listener->received[0], 0);
+
+            // Events sent during a run are deferred and dispatched in order on the next one
+            ecs.executeOnce();
+
+            EXPECT_EQ(listener->received.size(), 1);
+
+            ecs.executeOnce();
+
+            ASSERT_EQ(listener->received.size(), 4);
+            EXPECT_EQ(listener->received[1], 1);
+            EXPECT_EQ(listener->received[2], -2);
+            EXPECT_EQ(listener->received[3], 3);
+
+            // Per entity callbacks go through the same channel as the systems
+            int entityReceived = 0;
+
+            auto entity = ecs.createEntity();
+            ecs.attach<OnEventComponent>(entity, std::function<void(const ValueEvent&)>([&entityReceived](const ValueEvent& event) { entityReceived += event.value; }));
+
+            EXPECT_EQ(ecs.getComponentRegistry()->eventStorageMapSize<ValueEvent>(), 2);
+
+            ecs.sendEvent(ValueEvent{5});
+
+            EXPECT_EQ(entityReceived, 5);
+            EXPECT_EQ(listener->received.size(), 5);
+
+            ecs.removeEntity(entity);
+
+            EXPECT_EQ(ecs.getComponentRegistry()->eventStorageMapSize<ValueEvent>(), 1);
+
+            ecs.sendEvent(ValueEvent{5});
+
+            EXPECT_EQ(entityReceived, 5);
+            EXPECT_EQ(listener->received.size(), 6);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, immediate_event_batch_of_one)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<KeyedBatchSystem>();
+
+            // Each immediate dispatch delivers only its own event, even when the same batch memory is reused
+            for (int i = 0; i < 3; i++)
+            {
+                ecs.sendEvent(KeyedEvent{static_cast<_unique_id>(i + 1), i});
+
+                EXPECT_EQ(sys->nbBatches, i + 1);
+                ASSERT_EQ(sys->received.size(), i + 1);
+                EXPECT_EQ(sys->received[i].value, i);
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, coalesced_event_batch)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<KeyedBatchSystem>();
+
+            // Not running, the event is delivered right away as a batch of one
+            ecs.sendEvent(KeyedEvent{5, 0});
+
+            EXPECT_EQ(sys->nbBatches, 1);
+            ASSERT_EQ(sys->received.size(), 1);
+
+            sys->received.clear();
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbBatches, 1);
+
+            ecs.executeOnce();
+
+            // The 4 events sent during the previous tick are merged by key and delivered in one call
+            EXPECT_EQ(sys->nbBatches, 2);
+            ASSERT_EQ(sys->received.size(), 2);
+            EXPECT_EQ(sys->received[0].id, 1);
+            EXPECT_EQ(sys->received[0].value, 4);
+            EXPECT_EQ(sys->received[1].id, 2);
+            EXPECT_EQ(sys->received[1].value, 2);
+
+            // Nothing left to deliver
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbBatches, 2);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, component_signature)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+            ecs.createSystem<ABSystem>();
+
+            auto registry = ecs.getComponentRegistry();
+
+            // Component types get consecutive bits in the order their owner got registered
+            EXPECT_EQ(registry->getComponentIndex(ecs.getId<A>()), 0);
+            EXPECT_EQ(registry->getComponentIndex(ecs.getId<B>()), 1);
+            EXPECT_EQ(registry->getComponentIndex(ecs.getId<C>()), MAXCOMPONENTTYPES);
+
+            auto entity = ecs.createEntity();
+
+            ecs.attach<A>(entity, 1, 2);
+            ecs.attach<B>(entity, 3, 4);
+
+            EXPECT_EQ(entity->signature.count(), 2);
+            EXPECT_TRUE(entity->has<A>());
+            EXPECT_TRUE(entity->has(ecs.getId<B>()));
+            EXPECT_FALSE(entity->has<C>());
+
+            auto group = ecs.createSystem<ABGroupSystem>()->group;
+
+            ASSERT_NE(group, nullptr);
+            EXPECT_TRUE(group->isEntityInGroup(entity));
+
+            ecs.detach<B>(entity);
+
+            EXPECT_EQ(entity->signature.count(), 1);
+            EXPECT_TRUE(entity->has<A>());
+            EXPECT_FALSE(entity->has<B>());
+            EXPECT_FALSE(group->isEntityInGroup(entity));
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, deferred_structural_changes)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ASystem>();
+            ecs.createSystem<ABSystem>();
+            auto sys = ecs.createSystem<RestructureSystem>();
+
+            auto target = ecs.createEntity();
+
+            ecs.attach<A>(target, 1, 1);
+            ecs.attach<B>(target, 1, 1);
+
+            sys->target = target;
+
+            // Commands are recorded during the first run and played back at the sync point of the second one
+            ecs.executeOnce();
+
+            EXPECT_EQ(ecs.getNbEntities(), 1);
+            EXPECT_TRUE(target.has<A>());
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(ecs.getNbEntities(), 4);
+            EXPECT_FALSE(target.has<A>());
+            EXPECT_FALSE(target.has<B>());
+
+            int sumA = 0, sumB = 0;
+
+            for (const auto& a : ecs.view<A>())
+                sumA += a->value;
+
+            for (const auto& b : ecs.view<B>())
+                sumB += b->value;
+
+            EXPECT_EQ(ecs.view<A>().nbComponents() - 1, 3);
+            EXPECT_EQ(ecs.view<B>().nbComponents() - 1, 3);
+            EXPECT_EQ(sumA, 0 + 1 + 2);
+            EXPECT_EQ(sumB, 10 + 11 + 12);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, create_and_remove_in_same_tick)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto aSys = ecs.createSystem<ASystem>();
+            auto sys = ecs.createSystem<TransientSpawnerSystem>();
+
+            // Commands are recorded during the first run and played back at the sync point of the second one
+            ecs.executeOnce();
+            ecs.executeOnce();
+
+            EXPECT_NE(sys->transientId, 0);
+            EXPECT_EQ(ecs.getNbEntities(), 0);
+            EXPECT_EQ(aSys->getNbComponents() - 1, 0);
+            EXPECT_EQ(ecs.getEntity(sys->transientId), nullptr);
+
+            // The index of the transient entity is free again and owned by a single live entity
+            auto first = ecs.createEntity();
+            auto second = ecs.createEntity();
+
+            EXPECT_EQ(entityIndex(first.id), entityIndex(sys->transientId));
+            EXPECT_NE(entityIndex(first.id), entityIndex(second.id));
+            EXPECT_EQ(ecs.getNbEntities(), 2);
+
+            EXPECT_TRUE(first.isAlive());
+            EXPECT_TRUE(second.isAlive());
+            EXPECT_EQ(ecs.getEntity(sys->transientId), nullptr);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, profiler_records_frames)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<ValueListenerSystem>();
+            ecs.createSystem<ValueSenderSystem>();
+
+            ecs.createEntity();
+            ecs.createEntity();
+
+            ecs.executeOnce();
+            ecs.executeOnce();
+
+            auto profiler = ecs.getProfiler();
+
+            // The events sent during the first run are dispatched in the basic task of the second one
+            auto frames = profiler->getFrames();
+
+            ASSERT_EQ(frames.size(), 2);
+            EXPECT_EQ(frames[0].nbEntitiesCreated, 2);
+            EXPECT_EQ(frames[0].nbEvents, 0);
+            EXPECT_EQ(frames[1].nbEntitiesCreated, 0);
+            EXPECT_EQ(frames[1].nbEvents, 3);
+            EXPECT_GE(frames[1].start, frames[0].start + frames[0].duration);
+
+            size_t nbBasicTasks = 0;
+            size_t nbSenderRuns = 0;
+
+            const auto basicTaskId = profiler->registerName("Basic Task");
+            const auto senderId = profiler->registerName(typeid(ValueSenderSystem).name());
+
+            for (const auto& sample : profiler->getSamples())
+            {
+                EXPECT_GE(sample.duration, 0);
+
+                if (sample.nameId == basicTaskId)
+                    nbBasicTasks++;
+                else if (sample.nameId == senderId)
+                    nbSenderRuns++;
+            }
+
+            EXPECT_EQ(nbBasicTasks, 2);
+            EXPECT_EQ(nbSenderRuns, 2);
+
+            std::stringstream trace;
+            profiler->exportChromeTrace(trace);
+
+            EXPECT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+            EXPECT_NE(trace.str().find("{\"name\":\"Basic Task\",\"ph\":\"X\""), std::string::npos);
+            EXPECT_NE(trace.str().find("\"events\":3"), std::string::npos);
+
+            // Nothing is recorded while the profiler is disabled
+            const auto nbSamples = profiler->getSamples().size();
+
+            profiler->setEnabled(false);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(profiler->getSamples().size(), nbSamples);
+            EXPECT_EQ(profiler->getFrames().size(), 2);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, profiler_records_named_systems)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<NamedCounterSystem>();
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbRuns, 1);
+
+            auto profiler = ecs.getProfiler();
+
+            // The name of a named system is only known once it is added to the registry
+            const auto namedId = profiler->registerName(sys->getSystemName());
+            const auto typeId = profiler->registerName(typeid(NamedCounterSystem).name());
+
+            size_t nbNamedRuns = 0;
+
+            for (const auto& sample : profiler->getSamples())
+            {
+                EXPECT_NE(sample.nameId, typeId);
+
+                if (sample.nameId == namedId)
+                    nbNamedRuns++;
+            }
+
+            EXPECT_EQ(nbNamedRuns, 1);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, profiler_ring_buffer_concurrent_snapshot)
+        {
+            RingBuffer<ProfileSample, 64> buffer;
+
+            std::atomic<bool> done = false;
+
+            std::vector<std::thread> writers;
+
+            for (uint32_t t = 0; t < 4; t++)
+            {
+                writers.emplace_back([&buffer, t]() {
+                    for (int64_t i = 0; i < 20000; i++)
+                        buffer.push(ProfileSample{t, t, i, i});
+                });
+            }
+
+            std::thread reader([&buffer, &done]() {
+                while (not done)
+                {
+                    // A value torn by a concurrent write is never returned
+                    for (const auto& sample : buffer.snapshot())
+                    {
+                        EXPECT_EQ(sample.nameId, sample.threadId);
+                        EXPECT_EQ(sample.start, sample.duration);
+                    }
+                }
+            });
+
+            for (auto& writer : writers)
+                writer.join();
+
+            done = true;
+
+            reader.join();
+
+            EXPECT_EQ(buffer.nbPushed(), 80000u);
+            EXPECT_EQ(buffer.snapshot().size(), 64u);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, runtime_system_registration)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            std::atomic<int> nbRuns = 0;
+
+            ecs.createSystem<SystemSpawnerSystem>(&nbRuns);
+
+            ecs.executeOnce();
+
+            // The system created during the run is registered once the run is over and only executes on the next one
+            EXPECT_EQ(ecs.getNbSystems(), 2);
+            EXPECT_EQ(ecs.getNbTasks(), 2);
+            EXPECT_EQ(nbRuns, 0);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(nbRuns, 1);
+
+            // The deletion requested during this run leaves the counter system running until the end of the run
+            ecs.executeOnce();
+
+            EXPECT_EQ(nbRuns, 2);
+            EXPECT_EQ(ecs.getNbSystems(), 1);
+            EXPECT_EQ(ecs.getNbTasks(), 1);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(nbRuns, 2);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, runtime_system_creation_with_concurrent_lookups)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<TypeSpawnerSystem>();
+            auto lookup0 = ecs.createSystem<TypeLookupSystem<0>>();
+            auto lookup1 = ecs.createSystem<TypeLookupSystem<1>>();
+
+            // The new types get their ids while the lookup systems are running
+            ecs.executeOnce();
+            ecs.executeOnce();
+
+            EXPECT_EQ(lookup0->nbFound, 2000);
+            EXPECT_EQ(lookup1->nbFound, 2000);
+
+            EXPECT_EQ(ecs.getNbSystems(), 11);
+
+            std::set<_unique_id> ids;
+
+            auto collect = [&ecs, &ids](auto system) {
+                ASSERT_NE(system, nullptr);
+                ids.insert(system->_id);
+            };
+
+            collect(ecs.getSystem<TypedRuntimeSystem<0>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<1>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<2>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<3>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<4>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<5>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<6>>());
+            collect(ecs.getSystem<TypedRuntimeSystem<7>>());
+
+            // Every new type got its own id
+            EXPECT_EQ(ids.size(), 8);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, runtime_system_registration_while_started)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            std::atomic<int> nbRuns = 0;
+
+            ecs.start();
+
+            // Created from another thread without stopping the ecs
+            ecs.createSystem<RuntimeCounterSystem>(&nbRuns);
+
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (nbRuns < 3 and std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            EXPECT_GE(nbRuns, 3);
+
+            ecs.deleteSystem<RuntimeCounterSystem>();
+
+            ecs.stop();
+
+            // Every pending change is applied once the ecs is stopped
+            EXPECT_EQ(ecs.getNbSystems(), 0);
+            EXPECT_EQ(ecs.getNbTasks(), 0);
+
+            const int nbRunsAfterStop = nbRuns;
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(nbRuns, nbRunsAfterStop);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, on_event_schedule)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<OnEventCounterSystem>();
+
+            EXPECT_EQ(sys->schedulePolicy, SchedulePolicy::OnEvent);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbRuns, 0);
+
+            ecs.sendEvent(ValueEvent{5});
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->lastValue, 5);
+            EXPECT_EQ(sys->nbRuns, 1);
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbRuns, 1);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, fixed_rate_schedule)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<FixedRateCounterSystem>();
+
+            EXPECT_EQ(sys->schedulePolicy, SchedulePolicy::FixedRate);
+            EXPECT_EQ(sys->schedulePeriod, 50000000);
+
+            ecs.executeOnce();
+            ecs.executeOnce();
+
+            // The second tick came before the end of the period
+            EXPECT_EQ(sys->nbRuns, 1);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbRuns, 2);
+
+            // Can be changed at runtime, with no effect on an invalid rate
+            sys->setFixedRate(-1);
+
+            EXPECT_EQ(sys->schedulePeriod, 50000000);
+
+            sys->setEveryTick();
+
+            ecs.executeOnce();
+
+            EXPECT_EQ(sys->nbRuns, 3);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, tick_rate)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            std::atomic<int> nbRuns = 0;
+
+            ecs.createSystem<RuntimeCounterSystem>(&nbRuns);
+
+            EXPECT_EQ(ecs.getTickRate(), 0.0);
+            EXPECT_EQ(ecs.getInterpolationAlpha(), 1.0f);
+
+            ecs.setTickRate(50);
+
+            EXPECT_NEAR(ecs.getTickRate(), 50.0, 0.01);
+
+            ecs.start();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+            const auto alpha = ecs.getInterpolationAlpha();
+
+            ecs.stop();
+
+            // Around 10 ticks, with a large margin for slow machines
+            EXPECT_GE(nbRuns, 2);
+            EXPECT_LE(nbRuns, 14);
+
+            EXPECT_GE(alpha, 0.0f);
+            EXPECT_LE(alpha, 1.0f);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, stop_interrupts_the_tick_wait)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            std::atomic<int> nbRuns = 0;
+
+            ecs.createSystem<RuntimeCounterSystem>(&nbRuns);
+
+            // One tick per second, the loop spends almost all its time waiting for the next one
+            ecs.setTickRate(1);
+
+            ecs.start();
+
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (nbRuns < 1 and std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            const auto stopStart = std::chrono::steady_clock::now();
+
+            ecs.stop();
+
+            const auto stopDuration = std::chrono::steady_clock::now() - stopStart;
+
+            EXPECT_EQ(nbRuns, 1);
+            EXPECT_LT(stopDuration, std::chrono::milliseconds(500));
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, component_snapshot)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            ecs.createSystem<CounterSystem>();
+            auto sys = ecs.createSystem<TrackedIncrementSystem>();
+
+            auto snapshot = ecs.createSnapshot<Counter>();
+
+            auto entity = ecs.createEntity();
+            ecs.attach<Counter>(entity);
+
+            auto other = ecs.createEntity();
+            ecs.attach<Counter>(other);
+
+            sys->ids.push_back(entity.id);
+
+            EXPECT_EQ(snapshot->getNbPublished(), 0);
+            EXPECT_EQ(snapshot->acquire().size(), 0);
+
+            ecs.executeOnce();
+
+            // Published at the end of the tick, once the increment system ran
+            const auto& first = snapshot->acquire();
+
+            EXPECT_EQ(snapshot->getNbPublished(), 1);
+            ASSERT_EQ(first.size(), 2);
+            EXPECT_EQ(first.entityIds[0], entity.id);
+            EXPECT_EQ(first.components[0].value, 1);
+            EXPECT_EQ(first.tick, ecs.getNbTicks());
+            ASSERT_NE(first.find(entity.id), nullptr);
+            EXPECT_EQ(first.find(entity.id)->value, 1);
+
+            ecs.executeOnce();
+
+            // The acquired frame is a copy, it doesn't change until the next acquire
+            EXPECT_EQ(first.components[0].value, 1);
+
+            const auto& second = snapshot->acquire();
+
+            EXPECT_EQ(second.components[0].value, 2);
+            EXPECT_EQ(second.tick, first.tick + 1);
+            ASSERT_NE(second.find(other.id), nullptr);
+            EXPECT_EQ(second.find(other.id)->value, 0);
+
+            // Changes made in place only reach the snapshot once marked
+            ecs.getComponent<Counter>(other.id)->value = 5;
+            ecs.markChanged<Counter>(other.id);
+
+            // Go through all the buffers to check that each one catches up with the changes it missed
+            for (int i = 0; i < 3; i++)
+                ecs.executeOnce();
+
+            const auto& third = snapshot->acquire();
+
+            EXPECT_EQ(third.find(entity.id)->value, 5);
+            EXPECT_EQ(third.find(other.id)->value, 5);
+
+            // A component added after the first frames is appended to them
+            auto added = ecs.createEntity();
+            ecs.attach<Counter>(added);
+
+            ecs.executeOnce();
+
+            ASSERT_NE(snapshot->acquire().find(added.id), nullptr);
+            EXPECT_EQ(snapshot->acquire().size(), 3);
+
+            sys->ids.clear();
+
+            ecs.removeEntity(entity);
+
+            ecs.executeOnce();
+
+            // The entity is gone from the next frame
+            EXPECT_EQ(snapshot->acquire().find(entity.id), nullptr);
+            EXPECT_EQ(snapshot->acquire().size(), 2);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(component_registry_test, change_tracking)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<CounterSystem>();
+
+            auto entities = ecs.createEntities(4);
+
+            for (auto& entity : entities)
+                ecs.attach<Counter>(entity);
+
+            auto list = sys->view<Counter>();
+
+            // New components count as changes
+            size_t nbChanged = 0;
+
+            for (const auto& changed : list.changedSince(0))
+            {
+                EXPECT_EQ(changed.component, ecs.getComponent<Counter>(changed.id));
+                nbChanged++;
+            }
+
+            EXPECT_EQ(nbChanged, 4);
+
+            const auto version = list.getVersion();
+
+            EXPECT_EQ(list.changedSince(version).begin(), list.changedSince(version).end());
+
+            ecs.getComponent<Counter>(entities[2].id)->value = 7;
+            ecs.markChanged<Counter>(entities[2].id);
+
+            std::vector<_unique_id> changedIds;
+
+            for (const auto& changed : list.changedSince(version))
+            {
+                changedIds.push_back(changed.id);
+
+                EXPECT_EQ(changed.component->value, 7);
+            }
+
+            ASSERT_EQ(changedIds.size(), 1);
+            EXPECT_EQ(changedIds[0], entities[2].id);
+            EXPECT_GT(sys->Own<Counter>::components.getVersion(entities[2].id), version);
+
+            // The version follows the component moved in the place of a removed one
+            ecs.detach<Counter>(entities[0]);
+            ecs.markChanged<Counter>(entities[1].id);
+
+            changedIds.clear();
+
+            list = sys->view<Counter>();
+
+            for (const auto& changed : list.changedSince(version))
+                changedIds.push_back(changed.id);
+
+            std::sort(changedIds.begin(), changedIds.end());
+
+            ASSERT_EQ(changedIds.size(), 2);
+            EXPECT_EQ(changedIds[0], std::min(entities[1].id, entities[2].id));
+            EXPECT_EQ(changedIds[1], std::max(entities[1].id, entities[2].id));
+
+            // Marking an entity without the component does nothing
+            const auto lastVersion = list.getVersion();
+
+            ecs.markChanged<Counter>(entities[0].id);
+
+            EXPECT_EQ(list.getVersion(), lastVersion);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(system_test, frame_arenas)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sys = ecs.createSystem<FrameDataSystem>();
+
+            ecs.executeOnce();
+
+            // Systems run on the executor and allocate from their worker arena
+            EXPECT_TRUE(sys->usedWorkerArena);
+            EXPECT_EQ(sys->sum, 28);
+
+            // Any other thread goes through the shared arena
+            EXPECT_FALSE(ecs.isExecutorWorker());
+            EXPECT_THROW(ecs.getFrameArena(), std::runtime_error);
+
+            const auto allocatedBytes = ecs.getFrameAllocator().nbAllocatedBytes();
+
+            FrameVector<int> values(ecs.frameAllocator<int>());
+            values.reserve(16);
+
+            EXPECT_NE(values.get_allocator().mutex, nullptr);
+            EXPECT_GE(ecs.getFrameAllocator().nbAllocatedBytes(), allocatedBytes + 16 * sizeof(int));
+        }
     }
-}
\ No newline at end of file
+}
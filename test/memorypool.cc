@@ -1,6 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <thread>
+
 #include "Memory/memorypool.h"
+#include "Memory/lineararena.h"
+#include "Memory/frameallocator.h"
+#include "Memory/triplebuffer.h"
 
 namespace pg
 {
@@ -129,5 +134,480 @@ namespace pg
             EXPECT_EQ(pool.getNbElements(), 0);
             EXPECT_EQ(pool.getSize(), 5);
         }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(memorypool_test, bulk_alloc)
+        {
+            AllocatorPool<BasicObject> pool;
+
+            BasicObject* objects[100];
+
+            pool.allocateBulk(100, objects, BasicObject{5});
+
+            EXPECT_EQ(pool.getNbElements(), 100);
+            EXPECT_EQ(pool.getSize(), 127);
+
+            for (size_t i = 0; i < 100; i++)
+            {
+                EXPECT_EQ(objects[i]->id, 5);
+                objects[i]->id = static_cast<int>(i);
+            }
+
+            pool.releaseBulk(objects + 50, 50);
+
+            EXPECT_EQ(pool.getNbElements(), 50);
+
+            // Released chunks are reused before growing the pool
+            pool.allocateBulk(50, objects + 50);
+
+            EXPECT_EQ(pool.getNbElements(), 100);
+            EXPECT_EQ(pool.getSize(), 127);
+
+            for (size_t i = 0; i < 50; i++)
+            {
+                EXPECT_EQ(objects[i]->id, static_cast<int>(i));
+            }
+
+            // A single allocation after a bulk one doesn't overlap any living object
+            auto single = pool.allocate();
+
+            for (size_t i = 0; i < 100; i++)
+            {
+                EXPECT_NE(objects[i], single);
+            }
+
+            pool.release(single);
+            pool.releaseBulk(objects, 100);
+
+            EXPECT_EQ(pool.getNbElements(), 0);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(memorypool_test, shrink)
+        {
+            AllocatorPool<BasicObject, 4> pool;
+
+            std::vector<BasicObject*> objects(12);
+
+            pool.allocateBulk(12, objects.data());
+
+            EXPECT_EQ(pool.getSize(), 12);
+
+            // Nothing to free while every block holds an object
+            EXPECT_EQ(pool.shrink(), 0);
+
+            // Empty the middle block and the last one
+            pool.releaseBulk(objects.data() + 4, 8);
+
+            EXPECT_EQ(pool.shrink(), 8);
+            EXPECT_EQ(pool.getSize(), 4);
+            EXPECT_EQ(pool.getNbElements(), 4);
+
+            // The pool grows back from its end
+            pool.allocateBulk(8, objects.data() + 4);
+
+            EXPECT_EQ(pool.getSize(), 12);
+
+            for (size_t i = 0; i < 12; i++)
+                objects[i]->id = static_cast<int>(i);
+
+            // Free the middle block only, it becomes a hole that is never reused
+            pool.releaseBulk(objects.data() + 4, 4);
+
+            EXPECT_EQ(pool.shrink(), 4);
+            EXPECT_EQ(pool.getSize(), 8);
+
+            auto elem = pool.allocate();
+
+            EXPECT_EQ(pool.getSize(), 12);
+
+            pool.release(elem);
+            pool.releaseBulk(objects.data(), 4);
+            pool.releaseBulk(objects.data() + 8, 4);
+
+            EXPECT_EQ(pool.getNbElements(), 0);
+            EXPECT_EQ(pool.shrink(), 12);
+            EXPECT_EQ(pool.getSize(), 0);
+
+            elem = pool.allocate();
+
+            EXPECT_EQ(pool.getSize(), 4);
+
+            pool.release(elem);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(concurrent_memorypool_test, multi_thread_churn)
+        {
+            ConcurrentAllocatorPool<BasicObject, 8> pool;
+
+            constexpr size_t nbThreads = 4;
+            constexpr size_t nbObjects = 1000;
+
+            std::vector<std::vector<BasicObject*>> objects(nbThreads);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < nbThreads; t++)
+            {
+                threads.emplace_back([&pool, &objects, t]() {
+                    auto& list = objects[t];
+
+                    for (size_t i = 0; i < nbObjects; i++)
+                    {
+                        list.push_back(pool.allocate(BasicObject{static_cast<int>(t)}));
+
+                        // Release every other object right away to churn the cache
+                        if (i % 2 == 1)
+                        {
+                            pool.release(list.back());
+                            list.pop_back();
+                        }
+                    }
+
+                    pool.flush();
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            threads.clear();
+
+            EXPECT_EQ(pool.getNbElements(), nbThreads * nbObjects / 2);
+
+            for (size_t t = 0; t < nbThreads; t++)
+            {
+                for (auto object : objects[t])
+                    EXPECT_EQ(object->id, static_cast<int>(t));
+            }
+
+            // Objects can be released by another thread than the one that allocated them
+            for (size_t t = 0; t < nbThreads; t++)
+            {
+                threads.emplace_back([&pool, &objects, t]() {
+                    auto& list = objects[(t + 1) % nbThreads];
+
+                    pool.releaseBulk(list.data(), list.size());
+                    pool.flush();
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            EXPECT_EQ(pool.getNbElements(), 0);
+
+            pool.flush();
+
+            const auto size = pool.getSize();
+
+            EXPECT_GT(size, 0);
+
+            // Every chunk is back in the depot so all the blocks can be freed
+            EXPECT_EQ(pool.shrink(), size);
+            EXPECT_EQ(pool.getSize(), 0);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(concurrent_memorypool_test, destroyed_pool_leaves_thread_caches)
+        {
+            typedef ConcurrentAllocatorPool<BasicObject, 4> Pool;
+
+            const auto nbCaches = Pool::getNbThreadCaches();
+
+            auto pool = std::make_unique<Pool>();
+
+            pool->release(pool->allocate());
+
+            EXPECT_EQ(Pool::getNbThreadCaches(), nbCaches + 1);
+
+            // A thread still alive when the pool is destroyed
+            std::atomic<bool> used {false};
+            std::atomic<bool> destroyed {false};
+            size_t nbWorkerCaches = 1;
+
+            std::thread worker([&pool, &used, &destroyed, &nbWorkerCaches]() {
+                pool->release(pool->allocate());
+
+                used = true;
+
+                while (not destroyed)
+                    std::this_thread::yield();
+
+                nbWorkerCaches = Pool::getNbThreadCaches();
+            });
+
+            while (not used)
+                std::this_thread::yield();
+
+            // A thread that exited before the pool is destroyed
+            std::thread([&pool]() { pool->release(pool->allocate()); }).join();
+
+            pool.reset();
+
+            destroyed = true;
+
+            worker.join();
+
+            EXPECT_EQ(nbWorkerCaches, 0);
+            EXPECT_EQ(Pool::getNbThreadCaches(), nbCaches);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(concurrent_memorypool_test, pool_allocator)
+        {
+            constexpr size_t nbThreads = 4;
+
+            std::vector<std::vector<std::shared_ptr<BasicObject>>> objects(nbThreads);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < nbThreads; t++)
+            {
+                threads.emplace_back([&objects, t]() {
+                    for (int i = 0; i < 100; i++)
+                        objects[t].push_back(std::allocate_shared<BasicObject>(ConcurrentPoolAllocator<BasicObject>(), BasicObject{i}));
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (size_t t = 0; t < nbThreads; t++)
+            {
+                for (int i = 0; i < 100; i++)
+                    EXPECT_EQ(objects[t][i]->id, i);
+            }
+
+            // Objects released by another thread than the one that created them go back to the pool
+            threads.clear();
+
+            for (size_t t = 0; t < nbThreads; t++)
+                threads.emplace_back([&objects, t]() { objects[(t + 1) % nbThreads].clear(); });
+
+            for (auto& thread : threads)
+                thread.join();
+
+            std::vector<BasicObject, ConcurrentPoolAllocator<BasicObject>> list(10, BasicObject{3});
+
+            EXPECT_EQ(list[9].id, 3);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(linear_arena_test, allocate_and_reset)
+        {
+            LinearArena arena(256);
+
+            auto first = arena.create<BasicObject>();
+            auto second = arena.create<BasicObject>();
+
+            first->id = 1;
+            second->id = 2;
+
+            EXPECT_NE(first, second);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % alignof(BasicObject), 0);
+            EXPECT_EQ(arena.nbAllocatedBytes(), 2 * sizeof(BasicObject));
+            EXPECT_EQ(arena.capacity(), 256);
+
+            // An allocation bigger than a block gets its own block
+            auto big = arena.allocate<BasicObject>(200);
+
+            big[199].id = 3;
+
+            EXPECT_EQ(first->id, 1);
+            EXPECT_GE(arena.capacity(), 256 + 200 * sizeof(BasicObject));
+
+            const auto capacity = arena.capacity();
+
+            // After a reset the same memory is handed out again
+            arena.reset();
+
+            EXPECT_EQ(arena.nbAllocatedBytes(), 0);
+            EXPECT_EQ(arena.create<BasicObject>(), first);
+
+            arena.allocate<BasicObject>(200);
+
+            EXPECT_EQ(arena.capacity(), capacity);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(frame_allocator_test, double_buffered_frames)
+        {
+            FrameAllocator allocator(2, 1024);
+
+            EXPECT_EQ(allocator.getNbSlots(), 2);
+
+            FrameVector<int> values(FrameStdAllocator<int>(&allocator.getArena(0)));
+            values.reserve(16);
+
+            for (int i = 0; i < 16; i++)
+                values.push_back(i);
+
+            FrameSet<int> ids(FrameStdAllocator<int>(&allocator.getArena(1)));
+            ids.insert({3, 1, 2, 1});
+
+            EXPECT_EQ(ids.size(), 3);
+            EXPECT_EQ(*ids.begin(), 1);
+
+            const auto firstFrameBytes = allocator.nbAllocatedBytes();
+
+            EXPECT_GE(firstFrameBytes, 16 * sizeof(int));
+
+            // The data of the last frame stays untouched during the next one
+            allocator.nextFrame();
+
+            EXPECT_EQ(allocator.nbAllocatedBytes(), 0);
+
+            auto other = allocator.getArena(0).allocate<int>(16);
+
+            EXPECT_NE(other, values.data());
+            EXPECT_EQ(values[15], 15);
+
+            // After two frames the memory of the first one is handed out again without growing the arenas
+            allocator.nextFrame();
+
+            const auto capacity = allocator.capacity();
+
+            EXPECT_EQ(allocator.getArena(0).allocate<int>(16), values.data());
+            EXPECT_EQ(allocator.capacity(), capacity);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(frame_allocator_test, shared_arena)
+        {
+            FrameAllocator allocator(1, 1024);
+
+            constexpr int NBVALUES = 1000;
+
+            // Threads without a slot allocate concurrently from the shared arena through the mutex
+            auto fill = [](FrameVector<int>& values) {
+                for (int i = 0; i < NBVALUES; i++)
+                    values.push_back(i);
+            };
+
+            FrameVector<int> first(FrameStdAllocator<int>(&allocator.getSharedArena(), &allocator.getSharedMutex()));
+            FrameVector<int> second(FrameStdAllocator<int>(&allocator.getSharedArena(), &allocator.getSharedMutex()));
+
+            std::thread t1(fill, std::ref(first));
+            std::thread t2(fill, std::ref(second));
+
+            t1.join();
+            t2.join();
+
+            ASSERT_EQ(first.size(), NBVALUES);
+            ASSERT_EQ(second.size(), NBVALUES);
+
+            for (int i = 0; i < NBVALUES; i++)
+            {
+                EXPECT_EQ(first[i], i);
+                EXPECT_EQ(second[i], i);
+            }
+
+            EXPECT_GE(allocator.nbAllocatedBytes(), 2 * NBVALUES * sizeof(int));
+
+            // The shared arena follows the frames as the other ones
+            allocator.nextFrame();
+
+            EXPECT_EQ(allocator.nbAllocatedBytes(), 0);
+            EXPECT_EQ(first[NBVALUES - 1], NBVALUES - 1);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(triple_buffer_test, latest_frame_wins)
+        {
+            TripleBuffer<int> buffer;
+
+            EXPECT_FALSE(buffer.hasNewFrame());
+            EXPECT_FALSE(buffer.acquire());
+
+            buffer.back() = 1;
+            buffer.publish();
+
+            buffer.back() = 2;
+            buffer.publish();
+
+            // The consumer only sees the latest frame, the producer never waited for it
+            EXPECT_TRUE(buffer.hasNewFrame());
+            EXPECT_TRUE(buffer.acquire());
+            EXPECT_EQ(buffer.front(), 2);
+            EXPECT_EQ(buffer.getNbPublished(), 2);
+
+            // The front frame stays untouched until a new one is acquired
+            buffer.back() = 3;
+
+            EXPECT_FALSE(buffer.acquire());
+            EXPECT_EQ(buffer.front(), 2);
+
+            buffer.publish();
+
+            EXPECT_TRUE(buffer.acquire());
+            EXPECT_EQ(buffer.front(), 3);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(triple_buffer_test, concurrent_frames)
+        {
+            struct Frame
+            {
+                int values[64];
+            };
+
+            constexpr int nbFrames = 20000;
+
+            TripleBuffer<Frame> buffer;
+
+            std::thread producer([&buffer]() {
+                for (int i = 1; i <= nbFrames; i++)
+                {
+                    for (auto& value : buffer.back().values)
+                        value = i;
+
+                    buffer.publish();
+                }
+            });
+
+            int last = 0;
+            bool torn = false;
+
+            while (last < nbFrames)
+            {
+                if (not buffer.acquire())
+                    continue;
+
+                const auto& frame = buffer.front();
+
+                // A frame is never read while it is written and frames never go back in time
+                for (const auto& value : frame.values)
+                    torn |= value != frame.values[0];
+
+                torn |= frame.values[0] < last;
+
+                last = frame.values[0];
+            }
+
+            producer.join();
+
+            EXPECT_FALSE(torn);
+            EXPECT_EQ(last, nbFrames);
+        }
     }
-}
\ No newline at end of file
+}
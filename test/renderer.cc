@@ -1,11 +1,93 @@
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <thread>
+
 #include "Renderer/renderer.h"
+#include "ECS/sparseset.h"
 
 namespace pg
 {
     namespace test
     {
+        namespace
+        {
+            /** Renderer whose calls are set by hand, reporting its changes as the ecs renderers do */
+            struct MockRenderer : public AbstractRenderer
+            {
+                MockRenderer(MasterRenderer* masterRenderer) : AbstractRenderer(masterRenderer, RenderStage::Render) {}
+
+                void setCalls(const std::vector<RenderCall>& calls)
+                {
+                    renderCallList = calls;
+
+                    notifyRebuilt();
+                }
+
+                void updateCall(size_t index, const RenderCall& call)
+                {
+                    renderCallList[index] = call;
+
+                    notifyUpdated(index);
+                }
+            };
+
+            struct CallComponent
+            {
+                CallComponent(const RenderCall& call) : call(call) {}
+
+                RenderCall call;
+            };
+
+            /** Renderer mirroring a component set by index, as the ecs renderers do */
+            struct SetRenderer : public AbstractRenderer
+            {
+                SetRenderer(MasterRenderer* masterRenderer) : AbstractRenderer(masterRenderer, RenderStage::Render) {}
+
+                void sync(const ComponentSet<CallComponent>& set) { syncRenderCalls<CallComponent>(set.viewComponents()); }
+
+                const std::vector<RenderCall>& getCalls() const { return renderCallList; }
+            };
+
+            struct CallListComponent
+            {
+                CallListComponent(const std::vector<RenderCall>& calls) : calls(calls) {}
+
+                std::vector<RenderCall> calls;
+            };
+
+            /** Renderer mirroring a component set holding several calls per component, as the text renderers do */
+            struct RangeRenderer : public AbstractRenderer
+            {
+                RangeRenderer(MasterRenderer* masterRenderer) : AbstractRenderer(masterRenderer, RenderStage::Render) {}
+
+                void sync(const ComponentSet<CallListComponent>& set) { syncRenderCallRanges<CallListComponent>(set.viewComponents()); }
+
+                const std::vector<RenderCall>& getCalls() const { return renderCallList; }
+            };
+
+            RenderCall makeCall(int depth, const std::vector<float>& data)
+            {
+                RenderCall call(true, RenderStage::Render, OpacityType::Normal, depth, 0);
+
+                call.data = data;
+
+                return call;
+            }
+
+            /** Check that the batch holds the data of both calls, in any order */
+            bool batchHolds(const RenderCall& batch, const std::vector<float>& lhs, const std::vector<float>& rhs)
+            {
+                auto expected = lhs;
+                expected.insert(expected.end(), rhs.begin(), rhs.end());
+
+                auto reversed = rhs;
+                reversed.insert(reversed.end(), lhs.begin(), lhs.end());
+
+                return batch.data == expected or batch.data == reversed;
+            }
+        }
+
         // ----------------------------------------------------------------------------------------
         // ---------------------------        Test separator        -------------------------------
         // ----------------------------------------------------------------------------------------
@@ -43,6 +125,258 @@ namespace pg
             EXPECT_EQ(visible, true);
         }
 
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(master_renderer_test, incremental_render_queue)
+        {
+            MasterRenderer masterRenderer;
+
+            MockRenderer renderer(&masterRenderer);
+
+            renderer.setCalls({makeCall(1, {1.0f, 2.0f}), makeCall(1, {3.0f, 4.0f}), makeCall(2, {5.0f})});
+
+            masterRenderer.execute();
+
+            // The two calls with the same key are batched together
+            ASSERT_EQ(masterRenderer.getNbGeneratedFrames(), 1);
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 2);
+            EXPECT_TRUE(batchHolds(masterRenderer.getRenderQueue()[0], {1.0f, 2.0f}, {3.0f, 4.0f}));
+            EXPECT_EQ(masterRenderer.getRenderQueue()[1].data, std::vector<float>{5.0f});
+
+            // Nothing changed, no new frame is generated
+            masterRenderer.execute();
+
+            EXPECT_EQ(masterRenderer.getNbGeneratedFrames(), 1);
+
+            // Same key and size, the data is patched in its batch
+            renderer.updateCall(0, makeCall(1, {10.0f, 20.0f}));
+
+            masterRenderer.execute();
+
+            EXPECT_EQ(masterRenderer.getNbGeneratedFrames(), 2);
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 2);
+            EXPECT_TRUE(batchHolds(masterRenderer.getRenderQueue()[0], {10.0f, 20.0f}, {3.0f, 4.0f}));
+
+            // A new key moves the call out of its batch, the queue is rebuilt
+            renderer.updateCall(1, makeCall(0, {3.0f, 4.0f}));
+
+            masterRenderer.execute();
+
+            EXPECT_EQ(masterRenderer.getNbGeneratedFrames(), 3);
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 3);
+            EXPECT_EQ(masterRenderer.getRenderQueue()[0].data, (std::vector<float>{3.0f, 4.0f}));
+            EXPECT_EQ(masterRenderer.getRenderQueue()[1].data, (std::vector<float>{10.0f, 20.0f}));
+            EXPECT_EQ(masterRenderer.getRenderQueue()[2].data, std::vector<float>{5.0f});
+
+            // A new size is also rebuilt
+            renderer.updateCall(2, makeCall(2, {5.0f, 6.0f, 7.0f}));
+
+            masterRenderer.execute();
+
+            EXPECT_EQ(masterRenderer.getNbGeneratedFrames(), 4);
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 3);
+            EXPECT_EQ(masterRenderer.getRenderQueue()[2].data, (std::vector<float>{5.0f, 6.0f, 7.0f}));
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(master_renderer_test, sync_after_removal_and_addition)
+        {
+            MasterRenderer masterRenderer;
+
+            SetRenderer renderer(&masterRenderer);
+
+            ComponentSet<CallComponent> set;
+
+            set.addComponent(1, makeCall(1, {1.0f}));
+            set.addComponent(2, makeCall(1, {2.0f}));
+            set.addComponent(3, makeCall(1, {3.0f}));
+
+            renderer.sync(set);
+
+            ASSERT_EQ(renderer.getCalls().size(), 3);
+
+            // The last component moves in the slot of the removed one and the new one takes the freed slot, the size doesn't change
+            set.removeComponent(1);
+            set.addComponent(4, makeCall(1, {4.0f}));
+
+            renderer.sync(set);
+
+            ASSERT_EQ(renderer.getCalls().size(), 3);
+
+            for (size_t i = 0; i < 3; i++)
+                EXPECT_EQ(renderer.getCalls()[i].data, set[i + 1]->call.data);
+
+            EXPECT_EQ(renderer.getCalls()[0].data, std::vector<float>{3.0f});
+            EXPECT_EQ(renderer.getCalls()[2].data, std::vector<float>{4.0f});
+
+            // Without any move, an update is still patched in place
+            set.atEntity(2)->call = makeCall(1, {5.0f});
+            set.markChanged(2);
+
+            renderer.sync(set);
+
+            EXPECT_EQ(renderer.getCalls()[1].data, std::vector<float>{5.0f});
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(master_renderer_test, patched_frames)
+        {
+            MasterRenderer masterRenderer;
+
+            MockRenderer renderer(&masterRenderer);
+
+            std::vector<RenderCall> calls;
+
+            for (int i = 0; i < 100; i++)
+                calls.push_back(makeCall(1, {static_cast<float>(i), 0.0f}));
+
+            renderer.setCalls(calls);
+
+            masterRenderer.execute();
+
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 1);
+            EXPECT_EQ(masterRenderer.getNbCopiedValues(), 200);
+
+            // Each frame of the triple buffer starts with a full copy, then only the patched calls are copied
+            for (int i = 0; i < 10; i++)
+            {
+                renderer.updateCall(i, makeCall(1, {static_cast<float>(i), 1.0f}));
+
+                masterRenderer.execute();
+
+                const auto& frame = masterRenderer.acquireFrame();
+
+                ASSERT_EQ(frame.nbRenderCalls, 1);
+                EXPECT_EQ(frame.renderCalls[0].data, masterRenderer.getRenderQueue()[0].data);
+            }
+
+            EXPECT_EQ(masterRenderer.getNbGeneratedFrames(), 11);
+
+            // The two frames never filled yet are copied whole, every other frame only gets the calls it missed
+            EXPECT_LT(masterRenderer.getNbCopiedValues(), 3 * 200 + 10 * 2 * 3);
+
+            const auto copied = masterRenderer.getNbCopiedValues();
+
+            renderer.updateCall(50, makeCall(1, {50.0f, 1.0f}));
+
+            masterRenderer.execute();
+
+            EXPECT_LE(masterRenderer.getNbCopiedValues() - copied, 2 * 3);
+            EXPECT_EQ(masterRenderer.acquireFrame().renderCalls[0].data, masterRenderer.getRenderQueue()[0].data);
+
+            // A rebuild copies the frames whole again
+            renderer.updateCall(0, makeCall(2, {0.0f, 1.0f}));
+
+            masterRenderer.execute();
+
+            const auto& frame = masterRenderer.acquireFrame();
+
+            ASSERT_EQ(frame.nbRenderCalls, 2);
+
+            for (size_t i = 0; i < frame.nbRenderCalls; i++)
+                EXPECT_EQ(frame.renderCalls[i].data, masterRenderer.getRenderQueue()[i].data);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(master_renderer_test, sync_call_ranges)
+        {
+            MasterRenderer masterRenderer;
+
+            RangeRenderer renderer(&masterRenderer);
+
+            ComponentSet<CallListComponent> set;
+
+            set.addComponent(1, std::vector<RenderCall>{makeCall(1, {1.0f}), makeCall(1, {2.0f})});
+            set.addComponent(2, std::vector<RenderCall>{makeCall(1, {3.0f})});
+            set.addComponent(3, std::vector<RenderCall>{makeCall(1, {4.0f}), makeCall(1, {5.0f}), makeCall(1, {6.0f})});
+
+            renderer.sync(set);
+
+            masterRenderer.execute();
+
+            ASSERT_EQ(renderer.getCalls().size(), 6);
+            EXPECT_EQ(renderer.getCalls()[2].data, std::vector<float>{3.0f});
+
+            const auto version = renderer.getRenderVersion();
+
+            // Same number of calls, only the range of the component is copied
+            set.atEntity(3)->calls = {makeCall(1, {7.0f}), makeCall(1, {8.0f}), makeCall(1, {9.0f})};
+            set.markChanged(3);
+
+            renderer.sync(set);
+
+            ASSERT_EQ(renderer.getCalls().size(), 6);
+            EXPECT_EQ(renderer.getCalls()[3].data, std::vector<float>{7.0f});
+            EXPECT_EQ(renderer.getCalls()[5].data, std::vector<float>{9.0f});
+            EXPECT_EQ(renderer.getRenderVersion(), version + 3);
+
+            // The master renderer patches the calls in their batch
+            masterRenderer.execute();
+
+            ASSERT_EQ(masterRenderer.getNbQueuedCalls(), 1);
+            EXPECT_EQ(masterRenderer.getRenderQueue()[0].data.size(), 6);
+
+            // A new number of calls moves the calls of the next components, the list is rebuilt
+            set.atEntity(1)->calls = {makeCall(1, {10.0f})};
+            set.markChanged(1);
+
+            renderer.sync(set);
+
+            ASSERT_EQ(renderer.getCalls().size(), 5);
+            EXPECT_EQ(renderer.getCalls()[0].data, std::vector<float>{10.0f});
+            EXPECT_EQ(renderer.getCalls()[1].data, std::vector<float>{3.0f});
+            EXPECT_EQ(renderer.getCalls()[4].data, std::vector<float>{9.0f});
+
+            // Removing a component moves the last one in its slot, the list follows the new dense order
+            set.removeComponent(1);
+
+            renderer.sync(set);
+
+            ASSERT_EQ(renderer.getCalls().size(), 4);
+            EXPECT_EQ(renderer.getCalls()[0].data, std::vector<float>{7.0f});
+            EXPECT_EQ(renderer.getCalls()[3].data, std::vector<float>{3.0f});
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(master_renderer_test, interpolation_alpha_parameter)
+        {
+            EntitySystem ecs;
+
+            auto masterRenderer = ecs.createSystem<MasterRenderer>();
+
+            ecs.executeOnce();
+
+            // Without a tick rate the last tick is always the one to draw
+            masterRenderer->renderAll();
+
+            EXPECT_FLOAT_EQ(masterRenderer->getParameter()["InterpolationAlpha"].get<float>(), 1.0f);
+
+            ecs.setTickRate(1);
+
+            ecs.start();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            // Rendered in the middle of a one second tick
+            masterRenderer->renderAll();
+
+            ecs.stop();
+
+            const auto alpha = masterRenderer->getParameter()["InterpolationAlpha"].get<float>();
+
+            EXPECT_GE(alpha, 0.0f);
+            EXPECT_LT(alpha, 1.0f);
+        }
+
     } // namespace test
     
-} // namespace pg
\ No newline at end of file
+} // namespace pg
@@ -0,0 +1,195 @@
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+#include "gtest/gtest.h"
+
+#include "ECS/savemanager.h"
+
+#include "Files/filemanager.h"
+
+namespace pg
+{
+    namespace test
+    {
+        namespace
+        {
+            constexpr char const * SAVEPATH = "tmpSaveTest.sz";
+            constexpr char const * JOURNALPATH = "tmpSaveTest.sz.journal";
+
+            void removeSaveFiles()
+            {
+                fs::remove(SAVEPATH);
+                fs::remove(JOURNALPATH);
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(save_manager_test, save_and_reload)
+        {
+            removeSaveFiles();
+
+            {
+                SaveManager manager(SAVEPATH);
+
+                manager.onEvent(SaveElementEvent{"gold", 42});
+                manager.onEvent(SaveElementEvent{"name", std::string("player")});
+
+                manager.execute();
+
+                // The values are available right away, before reaching the disk
+                EXPECT_EQ(manager.getValue("gold").get<int>(), 42);
+
+                manager.flush();
+
+                EXPECT_EQ(manager.getNbWrites(), 1);
+                EXPECT_TRUE(fs::exists(SAVEPATH));
+                EXPECT_FALSE(fs::exists(std::string(SAVEPATH) + ".tmp"));
+            }
+
+            SaveManager reloaded(SAVEPATH);
+
+            EXPECT_EQ(reloaded.getValue("gold").get<int>(), 42);
+            EXPECT_EQ(reloaded.getValue("name").get<std::string>(), "player");
+
+            removeSaveFiles();
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(save_manager_test, writes_are_coalesced)
+        {
+            removeSaveFiles();
+
+            {
+                SaveManager manager(SAVEPATH);
+
+                manager.setMinSaveInterval(std::chrono::hours(1));
+
+                // The first write goes through right away
+                manager.onEvent(SaveElementEvent{"gold", 1});
+                manager.execute();
+                manager.flush();
+
+                EXPECT_EQ(manager.getNbWrites(), 1);
+
+                // The next ones wait for the interval and are merged in a single write
+                for (int i = 2; i <= 10; ++i)
+                {
+                    manager.onEvent(SaveElementEvent{"gold", i});
+                    manager.execute();
+                }
+
+                manager.flush();
+
+                EXPECT_EQ(manager.getNbWrites(), 2);
+            }
+
+            SaveManager reloaded(SAVEPATH);
+
+            EXPECT_EQ(reloaded.getValue("gold").get<int>(), 10);
+
+            removeSaveFiles();
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(save_manager_test, journal_mode)
+        {
+            removeSaveFiles();
+
+            {
+                SaveManager manager(SAVEPATH);
+
+                manager.setSaveMode(SaveMode::Journal);
+                manager.setMinSaveInterval(std::chrono::milliseconds(0));
+                manager.setCompactionThreshold(3);
+
+                manager.onEvent(SaveElementEvent{"gold", 1});
+                manager.onEvent(SaveElementEvent{"wood", 5});
+                manager.execute();
+                manager.flush();
+
+                // Only the journal is written until it gets compacted
+                EXPECT_FALSE(fs::exists(SAVEPATH));
+                EXPECT_TRUE(fs::exists(JOURNALPATH));
+
+                manager.onEvent(SaveElementEvent{"gold", 2});
+                manager.execute();
+                manager.flush();
+            }
+
+            {
+                // The journal is replayed on load
+                SaveManager reloaded(SAVEPATH);
+
+                EXPECT_EQ(reloaded.getValue("gold").get<int>(), 2);
+                EXPECT_EQ(reloaded.getValue("wood").get<int>(), 5);
+
+                reloaded.setSaveMode(SaveMode::Journal);
+                reloaded.setMinSaveInterval(std::chrono::milliseconds(0));
+                reloaded.setCompactionThreshold(3);
+
+                reloaded.onEvent(SaveElementEvent{"gold", 3});
+                reloaded.execute();
+                reloaded.flush();
+
+                // Third record, the journal is compacted in the save file
+                EXPECT_TRUE(fs::exists(SAVEPATH));
+                EXPECT_FALSE(fs::exists(JOURNALPATH));
+            }
+
+            SaveManager compacted(SAVEPATH);
+
+            EXPECT_EQ(compacted.getValue("gold").get<int>(), 3);
+            EXPECT_EQ(compacted.getValue("wood").get<int>(), 5);
+
+            removeSaveFiles();
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(save_manager_test, torn_journal_record_is_dropped)
+        {
+            removeSaveFiles();
+
+            {
+                SaveManager manager(SAVEPATH);
+
+                manager.setSaveMode(SaveMode::Journal);
+                manager.setMinSaveInterval(std::chrono::milliseconds(0));
+
+                manager.onEvent(SaveElementEvent{"gold", 1});
+                manager.execute();
+                manager.flush();
+            }
+
+            // Simulate a crash in the middle of the append of a second record
+            FileAccessor::appendToFile(TextFile{JOURNALPATH, ""}, std::string("\x40\x00\x00\x00\x01\x02", 6), true);
+
+            {
+                SaveManager reloaded(SAVEPATH);
+
+                EXPECT_EQ(reloaded.getValue("gold").get<int>(), 1);
+
+                reloaded.setSaveMode(SaveMode::Journal);
+                reloaded.setMinSaveInterval(std::chrono::milliseconds(0));
+
+                reloaded.onEvent(SaveElementEvent{"gold", 2});
+                reloaded.execute();
+                reloaded.flush();
+            }
+
+            SaveManager last(SAVEPATH);
+
+            EXPECT_EQ(last.getValue("gold").get<int>(), 2);
+
+            removeSaveFiles();
+        }
+    }
+}
@@ -0,0 +1,280 @@
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+#include "gtest/gtest.h"
+
+#include "Scene/scenemanager.h"
+#include "Scene/prefab.h"
+#include "Systems/coresystems.h"
+#include "UI/uisystem.h"
+
+#include "mocklogger.h"
+
+namespace pg
+{
+    namespace test
+    {
+        namespace
+        {
+            constexpr char const * SCENEPATH = "tmpSceneTest.sz";
+            constexpr char const * PREFABPATH = "tmpSceneTest.pgp";
+            constexpr char const * OTHERSCENEPATH = "tmpOtherSceneTest.sz";
+
+            constexpr size_t NBENTITIES = 10;
+
+            struct SceneLoadingListener : public System<Listener<SceneLoadingProgress>, Listener<NewSceneLoaded>, StoragePolicy>
+            {
+                virtual void onEvent(const SceneLoadingProgress& event) override
+                {
+                    progress.push_back(event.nbLoaded);
+                    nbEntities = event.nbEntities;
+                }
+
+                virtual void onEvent(const NewSceneLoaded&) override { loaded = true; nbLoaded++; }
+
+                std::vector<size_t> progress;
+                size_t nbEntities = 0;
+                bool loaded = false;
+                size_t nbLoaded = 0;
+            };
+
+            struct TestSystemScene : public Scene
+            {
+                TestSystemScene(bool *started) : started(started) {}
+
+                virtual void init() override {}
+
+                virtual void startUp() override { *started = true; }
+
+                bool *started;
+            };
+
+            /** Save a scene of named entities, the named entities are removed from the ecs afterward */
+            void saveNamedScene(EntitySystem& ecs, SceneElementSystem *sceneSystem, const std::string& path = SCENEPATH, const std::string& prefix = "entity")
+            {
+                std::vector<EntityRef> entities;
+
+                for (size_t i = 0; i < NBENTITIES; ++i)
+                {
+                    auto entity = ecs.createEntity();
+
+                    ecs.attach<SceneElement>(entity);
+                    ecs.attach<EntityName>(entity, prefix + std::to_string(i));
+
+                    entities.push_back(entity);
+                }
+
+                sceneSystem->onEvent(SaveScene{path});
+
+                for (auto& entity : entities)
+                    ecs.removeEntity(entity.id);
+            }
+
+            size_t countNamed(EntitySystem& ecs, const std::string& name)
+            {
+                size_t count = 0;
+
+                for (const auto& entityName : ecs.view<EntityName>())
+                {
+                    if (entityName->name == name)
+                        ++count;
+                }
+
+                return count;
+            }
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(scene_element_system_test, scene_is_loaded_in_batches)
+        {
+            MockLogger logger;
+
+            fs::remove(SCENEPATH);
+
+            EntitySystem ecs;
+
+            ecs.createSystem<EntityNameSystem>();
+            ecs.createSystem<UiComponentSystem>();
+            auto listener = ecs.createSystem<SceneLoadingListener>();
+            auto sceneSystem = ecs.createSystem<SceneElementSystem>();
+
+            // The sub scenes are placed relatively to the main window
+            auto window = ecs.createEntity();
+            ecs.attach<UiComponent>(window);
+            ecs.attach<EntityName>(window, "__MainWindow");
+
+            for (size_t i = 0; i < NBENTITIES; ++i)
+            {
+                auto entity = ecs.createEntity();
+
+                ecs.attach<SceneElement>(entity);
+                ecs.attach<EntityName>(entity, "entity" + std::to_string(i));
+            }
+
+            sceneSystem->onEvent(SaveScene{SCENEPATH});
+
+            sceneSystem->setLoadingBudget(3, std::chrono::microseconds(0));
+
+            ecs.sendEvent(LoadScene{SCENEPATH});
+
+            for (size_t nbFrames = 0; not listener->loaded and nbFrames < 100; ++nbFrames)
+                ecs.executeOnce();
+
+            ASSERT_TRUE(listener->loaded);
+
+            // One event once the file is parsed, then one per batch of at most 3 entities
+            EXPECT_EQ(listener->nbEntities, NBENTITIES);
+            EXPECT_EQ(listener->progress, (std::vector<size_t>{0, 3, 6, 9, 10}));
+
+            EXPECT_EQ(sceneSystem->currentScene.instancedEntities.size(), NBENTITIES);
+            EXPECT_NE(ecs.getSystem<EntityNameSystem>()->getEntityId("entity9"), 0);
+
+            fs::remove(SCENEPATH);
+        }
+   
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(scene_element_system_test, load_requested_during_parsing)
+        {
+            MockLogger logger;
+
+            fs::remove(SCENEPATH);
+            fs::remove(OTHERSCENEPATH);
+
+            EntitySystem ecs;
+
+            ecs.createSystem<EntityNameSystem>();
+            ecs.createSystem<UiComponentSystem>();
+            auto listener = ecs.createSystem<SceneLoadingListener>();
+            auto sceneSystem = ecs.createSystem<SceneElementSystem>();
+
+            auto window = ecs.createEntity();
+            ecs.attach<UiComponent>(window);
+            ecs.attach<EntityName>(window, "__MainWindow");
+
+            saveNamedScene(ecs, sceneSystem, SCENEPATH, "first");
+            saveNamedScene(ecs, sceneSystem, OTHERSCENEPATH, "second");
+
+            ecs.sendEvent(LoadScene{SCENEPATH});
+
+            ecs.executeOnce();
+
+            ASSERT_EQ(sceneSystem->currentState, SceneElementSystem::LoadingState::Parsing);
+
+            // A file scene requested during the parsing is loaded once the first load is over
+            ecs.sendEvent(LoadScene{OTHERSCENEPATH});
+
+            for (size_t nbFrames = 0; listener->nbLoaded < 2 and nbFrames < 200; ++nbFrames)
+                ecs.executeOnce();
+
+            ASSERT_EQ(listener->nbLoaded, 2);
+            EXPECT_EQ(sceneSystem->currentState, SceneElementSystem::LoadingState::Idle);
+            EXPECT_EQ(countNamed(ecs, "first0"), 0);
+            EXPECT_EQ(countNamed(ecs, "second0"), 1);
+
+            // Same for a system scene
+            ecs.sendEvent(LoadScene{SCENEPATH});
+
+            ecs.executeOnce();
+
+            ASSERT_EQ(sceneSystem->currentState, SceneElementSystem::LoadingState::Parsing);
+
+            bool started = false;
+
+            sceneSystem->loadSystemScene<TestSystemScene>(&started);
+
+            for (size_t nbFrames = 0; listener->nbLoaded < 4 and nbFrames < 200; ++nbFrames)
+                ecs.executeOnce();
+
+            ASSERT_EQ(listener->nbLoaded, 4);
+            EXPECT_TRUE(started);
+            EXPECT_EQ(sceneSystem->currentLoadedScene, SceneElementSystem::SceneToLoadFlag::SystemScene);
+            EXPECT_EQ(countNamed(ecs, "first0"), 0);
+            EXPECT_EQ(countNamed(ecs, "second0"), 0);
+
+            fs::remove(SCENEPATH);
+            fs::remove(OTHERSCENEPATH);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(scene_element_system_test, prefetched_scenes_are_bounded)
+        {
+            MockLogger logger;
+
+            EntitySystem ecs;
+
+            auto sceneSystem = ecs.createSystem<SceneElementSystem>();
+
+            const auto nbPrefetches = SceneElementSystem::MAXPREFETCHEDSCENES + 2;
+
+            for (size_t i = 0; i < nbPrefetches; ++i)
+            {
+                sceneSystem->prefetchScene("prefetch" + std::to_string(i) + ".sz");
+
+                // Let the parse finish so that the scene can be dropped by the next prefetches
+                sceneSystem->prefetchedScenes.back().second.wait();
+            }
+
+            // The oldest parsed scenes are dropped
+            ASSERT_EQ(sceneSystem->prefetchedScenes.size(), SceneElementSystem::MAXPREFETCHEDSCENES);
+            EXPECT_EQ(sceneSystem->prefetchedScenes.front().first, "prefetch2.sz");
+            EXPECT_EQ(sceneSystem->prefetchedScenes.back().first, "prefetch" + std::to_string(nbPrefetches - 1) + ".sz");
+
+            // Prefetching a scene twice doesn't parse it again
+            sceneSystem->prefetchScene("prefetch3.sz");
+
+            EXPECT_EQ(sceneSystem->prefetchedScenes.size(), SceneElementSystem::MAXPREFETCHEDSCENES);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(scene_element_system_test, baked_prefab)
+        {
+            MockLogger logger;
+
+            fs::remove(SCENEPATH);
+            fs::remove(PREFABPATH);
+
+            EntitySystem ecs;
+
+            ecs.createSystem<EntityNameSystem>();
+            auto sceneSystem = ecs.createSystem<SceneElementSystem>();
+
+            saveNamedScene(ecs, sceneSystem);
+
+            ASSERT_TRUE(Prefab::bakeFile(SCENEPATH, PREFABPATH));
+
+            auto prefab = Prefab::loadFile(&ecs, PREFABPATH);
+
+            ASSERT_NE(prefab, nullptr);
+
+            // All the names are in a single group
+            EXPECT_EQ(prefab->getNbEntities(), NBENTITIES);
+            EXPECT_EQ(prefab->getNbComponentTypes(), 1);
+
+            auto entities = prefab->instantiate(&ecs);
+
+            ASSERT_EQ(entities.size(), NBENTITIES);
+            EXPECT_EQ(countNamed(ecs, "entity0"), 1);
+            EXPECT_EQ(countNamed(ecs, "entity9"), 1);
+
+            // Spawned instances are part of the scene, the prefab is loaded once and reused
+            sceneSystem->spawnPrefab(PREFABPATH);
+            sceneSystem->spawnPrefab(PREFABPATH);
+
+            EXPECT_EQ(countNamed(ecs, "entity0"), 3);
+            // The list counts its empty first slot
+            EXPECT_EQ(ecs.view<SceneElement>().nbComponents(), 2 * NBENTITIES + 1);
+
+            fs::remove(SCENEPATH);
+            fs::remove(PREFABPATH);
+        }
+    }
+}
@@ -27,6 +27,48 @@ namespace pg
         archive.endSerialization();
     }
 
+    template <>
+    TestSerializeA deserialize(const UnserializedObject& serializedString)
+    {
+        return TestSerializeA{deserialize<int>(serializedString["data"])};
+    }
+
+    struct TestSerializeB
+    {
+        float value = 0.0f;
+        std::string text;
+        bool flag = false;
+        size_t count = 0;
+        TestSerializeA child = 0;
+    };
+
+    template <>
+    void serialize(Archive& archive, const TestSerializeB& b)
+    {
+        archive.startSerialization("Test Serial B");
+
+        serialize(archive, "value", b.value);
+        serialize(archive, "text", b.text);
+        serialize(archive, "flag", b.flag);
+        serialize(archive, "count", b.count);
+        serialize(archive, "child", b.child);
+
+        archive.endSerialization();
+    }
+
+    template <>
+    TestSerializeB deserialize(const UnserializedObject& serializedString)
+    {
+        TestSerializeB b;
+
+        b.value = deserialize<float>(serializedString["value"]);
+        b.text = deserialize<std::string>(serializedString["text"]);
+        b.flag = deserialize<bool>(serializedString["flag"]);
+        b.count = deserialize<size_t>(serializedString["count"]);
+        b.child = deserialize<TestSerializeA>(serializedString["child"]);
+
+        return b;
+    }
 
     namespace test
     {
@@ -170,5 +212,206 @@ namespace pg
             EXPECT_EQ(logger.getNbError(), 0);
         }
 
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serialize_test, text_object)
+        {
+            MockLogger logger;
+
+            TestSerializeB val;
+
+            val.value = 1.5f;
+            val.text = "text";
+            val.flag = true;
+            val.count = 12;
+            val.child = 42;
+
+            Archive archive;
+
+            serialize(archive, val);
+
+            UnserializedObject object("test: " + archive.container.str() + "\n", "test");
+
+            ASSERT_FALSE(object.isNull());
+            EXPECT_EQ(object.getObjectName(), "test");
+            EXPECT_EQ(object.getObjectType(), "Test Serial B");
+
+            // The empty first child followed by the 5 members
+            EXPECT_EQ(object.getNbChildren(), 6);
+            EXPECT_EQ(object["child"].getObjectType(), "Test Serial A");
+
+            auto ret = deserialize<TestSerializeB>(object);
+
+            EXPECT_EQ(ret.value, 1.5f);
+            EXPECT_EQ(ret.text, "text");
+            EXPECT_EQ(ret.flag, true);
+            EXPECT_EQ(ret.count, 12);
+            EXPECT_EQ(ret.child.data, 42);
+
+            EXPECT_EQ(logger.getNbError(), 0);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serialize_test, text_object_is_parsed_lazily)
+        {
+            MockLogger logger;
+
+            // The body of the nested class is ill formed
+            std::string str = "test: Test Serial B {\n"
+                              "\tvalue: __PGSA float {2.5},\n"
+                              "\tchild: Test Serial A {\n"
+                              "\t\tnot an attribute\n"
+                              "\t\tnor a class\n"
+                              "\t}\n"
+                              "}\n";
+
+            UnserializedObject object(str, "test");
+
+            // Reading a member doesn't parse the nested class
+            EXPECT_EQ(deserialize<float>(object["value"]), 2.5f);
+
+            EXPECT_EQ(logger.getNbError(), 0);
+
+            // It is only parsed when it is accessed
+            deserialize<int>(object["child"]["data"]);
+
+            EXPECT_GT(logger.getNbError(), 0);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serialize_test, missing_child_lookups)
+        {
+            MockLogger logger;
+
+            std::string str = "test: Test Serial B {\n"
+                              "\tvalue: __PGSA float {2.5},\n"
+                              "}\n";
+
+            UnserializedObject first(str, "test");
+            UnserializedObject second(str, "test");
+
+            // A missing child is the null object shared by every object (and every thread), looking into it stays null
+            const auto& missing = first["missing"];
+
+            EXPECT_EQ(&missing, &second["other"]);
+
+            EXPECT_TRUE(first["missing"]["x"].isNull());
+            EXPECT_TRUE(second[42]["y"].isNull());
+
+            EXPECT_TRUE(missing.getChildren().empty());
+
+            // The existing children are still found after the failed lookups
+            EXPECT_EQ(deserialize<float>(first["value"]), 2.5f);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serialize_test, binary_archive)
+        {
+            MockLogger logger;
+
+            TestSerializeB val;
+
+            val.value = 0.1f;
+            val.text = "multi\nline {text}";
+            val.flag = true;
+            val.count = 1ull << 40;
+            val.child = -42;
+
+            BinaryArchive archive;
+
+            serialize(archive, val);
+
+            auto object = UnserializedObject::fromBinary(archive.str(), "test");
+
+            ASSERT_FALSE(object.isNull());
+            EXPECT_TRUE(object.isBinary());
+            EXPECT_EQ(object.getObjectName(), "test");
+            EXPECT_EQ(object.getObjectType(), "Test Serial B");
+
+            // The values are stored raw, so they are restored exactly
+            auto ret = deserialize<TestSerializeB>(object);
+
+            EXPECT_EQ(ret.value, 0.1f);
+            EXPECT_EQ(ret.text, "multi\nline {text}");
+            EXPECT_EQ(ret.flag, true);
+            EXPECT_EQ(ret.count, 1ull << 40);
+            EXPECT_EQ(ret.child.data, -42);
+
+            // Base types can still be read as text attributes
+            auto attribute = object["flag"].getAsAttribute();
+
+            EXPECT_EQ(attribute.name, "bool");
+            EXPECT_EQ(attribute.value, "true");
+
+            EXPECT_EQ(logger.getNbError(), 0);
+
+            // Truncated data is rejected
+            auto str = archive.str();
+
+            auto truncated = UnserializedObject::fromBinary(str.substr(0, str.size() - 1), "test");
+
+            EXPECT_TRUE(truncated.isNull());
+            EXPECT_EQ(logger.getNbError(), 1);
+        }
+
+        // ----------------------------------------------------------------------------------------
+        // ---------------------------        Test separator        -------------------------------
+        // ----------------------------------------------------------------------------------------
+        TEST(serialize_test, binary_file)
+        {
+            MockLogger logger;
+            fs::remove("tmpSerializeTest.sz");
+
+            {
+                Serializer serialize;
+
+                serialize.setFile("tmpSerializeTest.sz");
+                serialize.setFormat(SerializationFormat::Binary);
+
+                TestSerializeB val;
+                val.value = 2.5f;
+                val.text = "text";
+                val.child = 7;
+
+                serialize.serializeObject("test 1", val);
+                serialize.serializeObject("test 2", 35);
+            }
+
+            auto file = UniversalFileAccessor::openBinaryFile("tmpSerializeTest.sz");
+
+            EXPECT_EQ(file.data.compare(0, 4, BINARYARCHIVEMAGIC), 0);
+
+            // The format is picked from the header of the file
+            Serializer serialize;
+
+            serialize.setFile("tmpSerializeTest.sz");
+
+            EXPECT_EQ(serialize.getFormat(), SerializationFormat::Binary);
+            EXPECT_EQ(serialize.getSerializedMap().size(), 2);
+
+            auto ret = serialize.deserializeObject<TestSerializeB>("test 1");
+
+            EXPECT_EQ(ret.value, 2.5f);
+            EXPECT_EQ(ret.text, "text");
+            EXPECT_EQ(ret.child.data, 7);
+
+            EXPECT_EQ(serialize.deserializeObject<int>("test 2"), 35);
+
+            EXPECT_EQ(logger.getNbError(), 0);
+
+            // The format can't change while holding objects
+            serialize.setFormat(SerializationFormat::Text);
+
+            EXPECT_EQ(serialize.getFormat(), SerializationFormat::Binary);
+            EXPECT_EQ(logger.getNbError(), 1);
+        }
+
     }
 }
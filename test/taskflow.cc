@@ -5,6 +5,11 @@
 #include <taskflow.hpp>
 #include <algorithm/pipeline.hpp>
 
+#include <atomic>
+#include <vector>
+
+#include "Memory/parallelfor.h"
+
 namespace
 {
     int spawn(int n, tf::Subflow& sbf)
@@ -318,4 +323,80 @@ TEST(taskflow_test, observer)
 
     // remove the observer (optional)
     executor.remove_observer(std::move(observer));
-}
\ No newline at end of file
+}
+
+// ----------------------------------------------------------------------------------------
+// ---------------------------        Test separator        -------------------------------
+// ----------------------------------------------------------------------------------------
+TEST(taskflow_test, parallel_for)
+{
+    tf::Executor executor(4);
+
+    constexpr size_t nbElements = 1000;
+
+    std::vector<int> values(nbElements, 0);
+    std::atomic<size_t> nbChunks = 0;
+
+    // Start at 1 like the dense arrays of the component sets
+    pg::parallelFor(executor, 1, nbElements, 64, [&values, &nbChunks](size_t start, size_t end) {
+        // Every chunk but the first one start on a multiple of the grain
+        EXPECT_TRUE(start == 1 or start % 64 == 0);
+        EXPECT_LE(end - start, 64);
+
+        for (size_t i = start; i < end; i++)
+            values[i]++;
+
+        nbChunks++;
+    });
+
+    EXPECT_EQ(values[0], 0);
+
+    for (size_t i = 1; i < nbElements; i++)
+        EXPECT_EQ(values[i], 1);
+
+    EXPECT_EQ(nbChunks, 16);
+
+    // Parallel loops started from a task of the executor run on the same workers
+    tf::Taskflow taskflow;
+    std::atomic<size_t> sum = 0;
+
+    taskflow.emplace([&executor, &sum]() {
+        pg::parallelFor(executor, 0, 100, 10, [&sum](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++)
+                sum += i;
+        });
+    });
+
+    executor.run(taskflow).wait();
+
+    EXPECT_EQ(sum, 4950);
+
+    // Chunks cut from an offset, as for an array that doesn't start on a cache line
+    std::fill(values.begin(), values.end(), 0);
+
+    pg::parallelFor(executor, 1, nbElements, 64, [&values](size_t start, size_t end) {
+        EXPECT_TRUE(start == 1 or start % 64 == 5);
+        EXPECT_TRUE(end == nbElements or end % 64 == 5);
+
+        for (size_t i = start; i < end; i++)
+            values[i]++;
+    }, 5);
+
+    EXPECT_EQ(values[0], 0);
+
+    for (size_t i = 1; i < nbElements; i++)
+        EXPECT_EQ(values[i], 1);
+
+    alignas(64) char buffer[256];
+
+    EXPECT_EQ(pg::firstCacheLineIndex(buffer, 8), 0);
+    EXPECT_EQ(pg::firstCacheLineIndex(buffer + 16, 8), 6);
+    EXPECT_EQ(pg::firstCacheLineIndex(buffer + 4, 12), 5);
+    // Never on a cache line
+    EXPECT_EQ(pg::firstCacheLineIndex(buffer + 1, 8), 0);
+
+    EXPECT_EQ(pg::elementsPerCacheLine(8), 8);
+    EXPECT_EQ(pg::elementsPerCacheLine(12), 16);
+    EXPECT_EQ(pg::elementsPerCacheLine(64), 1);
+    EXPECT_EQ(pg::elementsPerCacheLine(96), 2);
+}